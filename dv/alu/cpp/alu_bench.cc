@@ -0,0 +1,404 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "alu_bench.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// Kinds of random operands, chosen with equal probability
+enum OperandKind {
+  kOperandCorner,
+  kOperandSingleBit,
+  kOperandSparse,
+  kOperandDense,
+  kOperandRandom,
+  kNumOperandKinds
+};
+
+static const uint32_t kCornerOperands[] = {
+    0x00000000, 0x00000001, 0x0000001f, 0x00000020, 0x0000ffff,
+    0x00010000, 0x7fffffff, 0x80000000, 0xfffffffe, 0xffffffff};
+static const int kNumCornerOperands =
+    sizeof(kCornerOperands) / sizeof(*kCornerOperands);
+
+// The balanced implementation only supports the rev, rev8 and orc.b
+// immediates of grev and gorc, see ibex_alu
+static const uint32_t kBalancedGrevShamt[] = {24, 31};
+static const uint32_t kBalancedGorcShamt = 7;
+
+static const char *const kRv32bNames[] = {"RV32BNone", "RV32BBalanced",
+                                          "RV32BFull"};
+
+// The instance accessed by the DPI functions below
+static AluBench *alu_bench_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void alu_tb_init(int rv32b) {
+  assert(alu_bench_instance);
+  alu_bench_instance->Init(rv32b);
+}
+
+void alu_tb_tick(svBit valid, const svBitVecVal *result,
+                 svBitVecVal *alu_operator, svBitVecVal *operand_a,
+                 svBitVecVal *operand_b, svBit *instr_first_cycle,
+                 svBit *stop) {
+  assert(alu_bench_instance);
+
+  AluBenchOutputs out;
+  out.valid = valid;
+  out.result = result[0];
+
+  AluBenchInputs in;
+  *stop = alu_bench_instance->Tick(out, in);
+
+  alu_operator[0] = in.alu_operator;
+  operand_a[0] = in.operand_a;
+  operand_b[0] = in.operand_b;
+  *instr_first_cycle = in.instr_first_cycle;
+}
+}
+
+AluBench::AluBench()
+    : max_vectors_(1000000),
+      seed_(1),
+      batch_(64),
+      rv32b_(0),
+      op_vectors_(kNumAluOps) {
+  assert(!alu_bench_instance && "Only one AluBench instance is supported.");
+  alu_bench_instance = this;
+
+  for (int op = 0; op < kNumAluOps; ++op) {
+    ops_.push_back(static_cast<AluOp>(op));
+  }
+}
+
+AluBench::~AluBench() { alu_bench_instance = nullptr; }
+
+// Parse a comma separated list of operation names
+static bool ParseOps(const char *arg, std::vector<AluOp> &ops) {
+  ops.clear();
+  std::istringstream list(arg);
+  std::string name;
+  while (std::getline(list, name, ',')) {
+    int op = 0;
+    while (op < kNumAluOps && name != AluOpName(static_cast<AluOp>(op))) {
+      ++op;
+    }
+    if (op == kNumAluOps) {
+      std::cerr << "ERROR: Unknown operation: " << name << std::endl;
+      return false;
+    }
+    ops.push_back(static_cast<AluOp>(op));
+  }
+  if (ops.empty()) {
+    std::cerr << "ERROR: No operations given." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool AluBench::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"vectors", required_argument, nullptr, 'n'},
+      {"seed", required_argument, nullptr, 'S'},
+      {"batch", required_argument, nullptr, 'B'},
+      {"ops", required_argument, nullptr, 'O'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'n':
+        max_vectors_ = strtoull(optarg, nullptr, 0);
+        break;
+      case 'S':
+        seed_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'B':
+        batch_ = strtoul(optarg, nullptr, 0);
+        if (!batch_) {
+          std::cerr << "ERROR: The batch size must not be 0." << std::endl;
+          return false;
+        }
+        break;
+      case 'O':
+        if (!ParseOps(optarg, ops_)) {
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void AluBench::PrintHelp() const {
+  std::cout << "ALU testbench:\n\n"
+               "--vectors=N\n"
+               "  Stop after N operand vectors (default: "
+            << max_vectors_
+            << ", 0: run until the cycle\n"
+               "  limit)\n\n"
+               "--seed=N\n"
+               "  Seed of the random stimulus (default: "
+            << seed_
+            << ")\n\n"
+               "--batch=N\n"
+               "  Number of vectors per operation computed by one call of "
+               "the reference\n"
+               "  model (default: "
+            << batch_
+            << ")\n\n"
+               "--ops=OP[,OP...]\n"
+               "  Only issue these operations, e.g. bext,bdep (default: all "
+               "operations of\n"
+               "  the RV32B implementation)\n\n";
+}
+
+void AluBench::PreExec() {
+  rng_.seed(seed_);
+
+  pos_ = 0;
+  order_.clear();
+
+  cycle_ = 0;
+  memset(&in_, 0, sizeof(in_));
+  busy_ = false;
+
+  errors_ = 0;
+  vectors_ = 0;
+  std::fill(op_vectors_.begin(), op_vectors_.end(), 0);
+  model_time_ = std::chrono::steady_clock::duration::zero();
+  model_vectors_ = 0;
+  time_begin_ = std::chrono::steady_clock::now();
+}
+
+void AluBench::PostExec() { time_end_ = std::chrono::steady_clock::now(); }
+
+void AluBench::Init(unsigned int rv32b) {
+  rv32b_ = rv32b;
+  std::cout << "ALU: "
+            << (rv32b < sizeof(kRv32bNames) / sizeof(*kRv32bNames)
+                    ? kRv32bNames[rv32b]
+                    : "unknown")
+            << std::endl
+            << "Stimulus seed " << seed_ << std::endl;
+
+  std::vector<AluOp> supported;
+  std::string skipped;
+  for (AluOp op : ops_) {
+    if (AluOpMinRv32b(op) <= rv32b) {
+      supported.push_back(op);
+    } else {
+      skipped += std::string(skipped.empty() ? "" : ",") + AluOpName(op);
+    }
+  }
+  if (!skipped.empty()) {
+    std::cout << "Not supported, skipped: " << skipped << std::endl;
+  }
+  ops_ = supported;
+  if (ops_.empty()) {
+    Error("No supported operations to issue");
+  }
+}
+
+uint32_t AluBench::Operand() {
+  switch (rng_() % kNumOperandKinds) {
+    case kOperandCorner:
+      return kCornerOperands[rng_() % kNumCornerOperands];
+    case kOperandSingleBit:
+      return 1u << (rng_() % 32);
+    case kOperandSparse:
+      return rng_() & rng_() & rng_();
+    case kOperandDense:
+      return rng_() | rng_() | rng_();
+    default:
+      return rng_();
+  }
+}
+
+uint32_t AluBench::OperandB(AluOp op) {
+  if (rv32b_ != 2 /* RV32BFull */) {
+    // Only the shift amount selects the balanced grev and gorc variants, the
+    // upper bits must be ignored
+    if (op == kAluGrev) {
+      return (rng_() & ~31u) | kBalancedGrevShamt[rng_() % 2];
+    }
+    if (op == kAluGorc) {
+      return (rng_() & ~31u) | kBalancedGorcShamt;
+    }
+  }
+  return Operand();
+}
+
+void AluBench::Refill() {
+  size_t size = ops_.size() * batch_;
+  op_.resize(size);
+  a_.resize(size);
+  b_.resize(size);
+  c_.resize(size);
+  expected_.resize(size);
+  order_.resize(size);
+
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    for (size_t j = i * batch_; j < (i + 1) * batch_; ++j) {
+      op_[j] = ops_[i];
+      a_[j] = Operand();
+      b_[j] = OperandB(ops_[i]);
+      c_[j] = Operand();
+    }
+  }
+
+  auto model_begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    size_t first = i * batch_;
+    AluEvaluate(ops_[i], &a_[first], &b_[first], &c_[first], &expected_[first],
+                batch_);
+  }
+  model_time_ += std::chrono::steady_clock::now() - model_begin;
+  model_vectors_ += size;
+
+  std::iota(order_.begin(), order_.end(), 0);
+  std::shuffle(order_.begin(), order_.end(), rng_);
+  pos_ = 0;
+}
+
+void AluBench::Issue(AluBenchInputs &next) {
+  if (pos_ == order_.size()) {
+    Refill();
+  }
+  vector_ = order_[pos_++];
+  next.alu_operator = op_[vector_];
+  next.operand_a = a_[vector_];
+  next.operand_b = b_[vector_];
+  next.instr_first_cycle = true;
+
+  busy_ = true;
+  vector_cycles_ = 0;
+}
+
+void AluBench::Error(const std::string &msg) {
+  std::cerr << "ERROR: Cycle " << cycle_ << ": " << msg << std::endl;
+  errors_++;
+}
+
+bool AluBench::Tick(const AluBenchOutputs &out, AluBenchInputs &in) {
+  // |in_| holds the inputs of the cycle ending at this clock edge
+  cycle_++;
+
+  AluBenchInputs next = in_;
+  if (busy_) {
+    AluOp op = op_[vector_];
+    unsigned int cycles = AluOpMultiCycle(op) ? 2 : 1;
+    vector_cycles_++;
+    if (out.valid) {
+      if (out.result != expected_[vector_] || vector_cycles_ != cycles) {
+        std::ostringstream msg;
+        msg << std::hex << std::setfill('0') << AluOpName(op) << " 0x"
+            << std::setw(8) << a_[vector_] << ", 0x" << std::setw(8)
+            << b_[vector_];
+        if (AluOpTernary(op)) {
+          msg << ", 0x" << std::setw(8) << c_[vector_];
+        }
+        msg << ": result 0x" << std::setw(8) << out.result << ", expected 0x"
+            << std::setw(8) << expected_[vector_] << std::dec << " after "
+            << cycles << " cycle(s), valid after " << vector_cycles_;
+        Error(msg.str());
+      }
+      vectors_++;
+      op_vectors_[op]++;
+      busy_ = false;
+    } else if (vector_cycles_ >= cycles) {
+      std::ostringstream msg;
+      msg << AluOpName(op) << ": no result after " << vector_cycles_
+          << " cycle(s)";
+      Error(msg.str());
+      busy_ = false;
+    } else {
+      // Second cycle, ternary operations get their third operand in
+      // operand a
+      next.instr_first_cycle = false;
+      if (AluOpTernary(op)) {
+        next.operand_a = c_[vector_];
+      }
+    }
+  }
+
+  // Inputs for the next cycle
+  if (!busy_ && !errors_) {
+    Issue(next);
+  }
+
+  in_ = next;
+  in = next;
+  return errors_ || (max_vectors_ && vectors_ >= max_vectors_);
+}
+
+std::string AluBench::ReportString(bool csv) const {
+  StatValues values;
+
+  double seconds =
+      std::chrono::duration<double>(time_end_ - time_begin_).count();
+  double model_seconds = std::chrono::duration<double>(model_time_).count();
+
+  AddStat(values, "Cycles", cycle_);
+  AddStat(values, "Vectors", vectors_);
+  AddStat(values, "Mismatches", errors_);
+  AddStatRatio(values, "Vectors/Cycle",
+               cycle_ ? static_cast<double>(vectors_) / cycle_ : 0.0);
+  AddStat(values, "Vectors/s", seconds > 0.0 ? vectors_ / seconds : 0);
+  // Throughput of the reference model alone, to see how much of the
+  // simulation time it takes
+  AddStat(values, "Model Vectors/s",
+          model_seconds > 0.0 ? model_vectors_ / model_seconds : 0);
+
+  for (int op = 0; op < kNumAluOps; ++op) {
+    if (op_vectors_[op]) {
+      AddStat(values,
+              std::string(AluOpName(static_cast<AluOp>(op))) + " Vectors",
+              op_vectors_[op]);
+    }
+  }
+
+  return FormatStats(values, csv);
+}
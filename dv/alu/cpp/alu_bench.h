@@ -0,0 +1,167 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ALU_BENCH_H_
+#define ALU_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "alu_ref_model.h"
+#include "ibex_tb_driver.h"
+
+// Inputs of the ALU driven by the testbench in one cycle
+struct AluBenchInputs {
+  unsigned int alu_operator;
+  uint32_t operand_a;
+  uint32_t operand_b;
+  bool instr_first_cycle;
+};
+
+// Outputs of the ALU sampled by the testbench at a clock edge
+struct AluBenchOutputs {
+  bool valid;
+  uint32_t result;
+};
+
+/**
+ * Driver and scoreboard of the ALU testbench
+ *
+ * Called through DPI from tb/tb_alu.sv in every cycle. Issues one operand
+ * vector per cycle, or one per two cycles for the multicycle operations,
+ * which get the third operand of ternary operations in the second cycle like
+ * the ID stage does. Checks the result and the number of cycles of every
+ * vector.
+ *
+ * The expected results are computed a batch at a time: the bench generates
+ * |batch| random vectors for each operation, evaluates them with one call of
+ * AluEvaluate() per operation, and then issues the whole batch in random
+ * order. Operands are biased towards corner cases and sparse and dense bit
+ * patterns, which matter for the bit manipulation operations.
+ *
+ * The bench is configured on the command line, see PrintHelp().
+ */
+class AluBench : public IbexTestbench {
+ public:
+  AluBench();
+  ~AluBench();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Seed the stimulus and reset the statistics
+   */
+  virtual void PreExec();
+
+  /**
+   * Stop the wall clock time measurement
+   */
+  virtual void PostExec();
+
+  /**
+   * Set the RV32B implementation (the parameter of the DUT)
+   *
+   * Operations the implementation doesn't support are not issued.
+   */
+  void Init(unsigned int rv32b);
+
+  /**
+   * Check the DUT outputs at a clock edge, and choose the inputs for the next
+   * cycle
+   *
+   * @return true if the simulation should stop
+   */
+  bool Tick(const AluBenchOutputs &out, AluBenchInputs &in);
+
+  /**
+   * Did all checks pass?
+   */
+  virtual bool Passed() const { return errors_ == 0; }
+
+  /**
+   * Returns a formatted string of the bench statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  virtual std::string ReportString(bool csv) const;
+
+ private:
+  // Configuration
+  uint64_t max_vectors_;
+  unsigned int seed_;
+  size_t batch_;
+  std::vector<AluOp> ops_;
+  unsigned int rv32b_;
+
+  std::mt19937 rng_;
+
+  // Current batch, in structure of arrays layout for AluEvaluate(). The
+  // vectors of each operation are stored contiguously, |order_| is the issue
+  // order.
+  std::vector<AluOp> op_;
+  std::vector<uint32_t> a_;
+  std::vector<uint32_t> b_;
+  std::vector<uint32_t> c_;
+  std::vector<uint32_t> expected_;
+  std::vector<size_t> order_;
+  size_t pos_;
+
+  // State of the driver
+  uint64_t cycle_;
+  AluBenchInputs in_;
+  bool busy_;
+  size_t vector_;
+  unsigned int vector_cycles_;
+
+  // Statistics
+  uint64_t errors_;
+  uint64_t vectors_;
+  std::vector<uint64_t> op_vectors_;
+  std::chrono::steady_clock::time_point time_begin_;
+  std::chrono::steady_clock::time_point time_end_;
+  std::chrono::steady_clock::duration model_time_;
+  uint64_t model_vectors_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Choose a random operand
+   */
+  uint32_t Operand();
+
+  /**
+   * Choose the second operand of a vector
+   */
+  uint32_t OperandB(AluOp op);
+
+  /**
+   * Generate a new batch of vectors and compute their expected results
+   */
+  void Refill();
+
+  /**
+   * Start the next vector in the next cycle
+   */
+  void Issue(AluBenchInputs &next);
+
+  void Error(const std::string &msg);
+};
+
+#endif  // ALU_BENCH_H_
@@ -0,0 +1,464 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "alu_ref_model.h"
+
+#include <cassert>
+
+// ibex_pkg::rv32b_e
+enum {
+  kRv32bNone = 0,
+  kRv32bBalanced = 1,
+  kRv32bFull = 2,
+};
+
+struct AluOpInfo {
+  const char *name;
+  unsigned int min_rv32b;
+  bool multi_cycle;
+  bool ternary;
+};
+
+static const AluOpInfo kAluOps[kNumAluOps] = {
+    {"add", kRv32bNone, false, false},
+    {"sub", kRv32bNone, false, false},
+    {"xor", kRv32bNone, false, false},
+    {"or", kRv32bNone, false, false},
+    {"and", kRv32bNone, false, false},
+    {"xnor", kRv32bBalanced, false, false},
+    {"orn", kRv32bBalanced, false, false},
+    {"andn", kRv32bBalanced, false, false},
+    {"sra", kRv32bNone, false, false},
+    {"srl", kRv32bNone, false, false},
+    {"sll", kRv32bNone, false, false},
+    {"sro", kRv32bBalanced, false, false},
+    {"slo", kRv32bBalanced, false, false},
+    {"ror", kRv32bBalanced, true, false},
+    {"rol", kRv32bBalanced, true, false},
+    {"grev", kRv32bBalanced, false, false},
+    {"gorc", kRv32bBalanced, false, false},
+    {"shfl", kRv32bFull, false, false},
+    {"unshfl", kRv32bFull, false, false},
+    {"lt", kRv32bNone, false, false},
+    {"ltu", kRv32bNone, false, false},
+    {"ge", kRv32bNone, false, false},
+    {"geu", kRv32bNone, false, false},
+    {"eq", kRv32bNone, false, false},
+    {"ne", kRv32bNone, false, false},
+    {"min", kRv32bBalanced, false, false},
+    {"minu", kRv32bBalanced, false, false},
+    {"max", kRv32bBalanced, false, false},
+    {"maxu", kRv32bBalanced, false, false},
+    {"pack", kRv32bBalanced, false, false},
+    {"packu", kRv32bBalanced, false, false},
+    {"packh", kRv32bBalanced, false, false},
+    {"sext.b", kRv32bBalanced, false, false},
+    {"sext.h", kRv32bBalanced, false, false},
+    {"clz", kRv32bBalanced, false, false},
+    {"ctz", kRv32bBalanced, false, false},
+    {"pcnt", kRv32bBalanced, false, false},
+    {"slt", kRv32bNone, false, false},
+    {"sltu", kRv32bNone, false, false},
+    {"cmov", kRv32bBalanced, true, true},
+    {"cmix", kRv32bBalanced, true, true},
+    {"fsl", kRv32bBalanced, true, true},
+    {"fsr", kRv32bBalanced, true, true},
+    {"sbset", kRv32bBalanced, false, false},
+    {"sbclr", kRv32bBalanced, false, false},
+    {"sbinv", kRv32bBalanced, false, false},
+    {"sbext", kRv32bBalanced, false, false},
+    {"bext", kRv32bFull, true, false},
+    {"bdep", kRv32bFull, true, false},
+    {"bfp", kRv32bBalanced, false, false},
+    {"clmul", kRv32bFull, false, false},
+    {"clmulr", kRv32bFull, false, false},
+    {"clmulh", kRv32bFull, false, false},
+    {"crc32.b", kRv32bFull, true, false},
+    {"crc32c.b", kRv32bFull, true, false},
+    {"crc32.h", kRv32bFull, true, false},
+    {"crc32c.h", kRv32bFull, true, false},
+    {"crc32.w", kRv32bFull, true, false},
+    {"crc32c.w", kRv32bFull, true, false},
+};
+
+const char *AluOpName(AluOp op) {
+  assert(op < kNumAluOps);
+  return kAluOps[op].name;
+}
+
+unsigned int AluOpMinRv32b(AluOp op) {
+  assert(op < kNumAluOps);
+  return kAluOps[op].min_rv32b;
+}
+
+bool AluOpMultiCycle(AluOp op) {
+  assert(op < kNumAluOps);
+  return kAluOps[op].multi_cycle;
+}
+
+bool AluOpTernary(AluOp op) {
+  assert(op < kNumAluOps);
+  return kAluOps[op].ternary;
+}
+
+// All-ones if |bit| of |x| is set, zero otherwise
+static inline uint32_t BitMask(uint32_t x, unsigned int bit) {
+  return -((x >> bit) & 1);
+}
+
+// Swap the bit groups selected by |mask_l| and |mask_r| with a distance of
+// |shift| bits
+static inline uint32_t SwapStage(uint32_t x, uint32_t mask_l, uint32_t mask_r,
+                                 unsigned int shift) {
+  return ((x & mask_r) << shift) | ((x & mask_l) >> shift);
+}
+
+static inline uint32_t Grev(uint32_t x, uint32_t b, bool orc) {
+  static const uint32_t kMaskL[5] = {0xaaaaaaaa, 0xcccccccc, 0xf0f0f0f0,
+                                     0xff00ff00, 0xffff0000};
+  for (unsigned int i = 0; i < 5; ++i) {
+    uint32_t swapped = SwapStage(x, kMaskL[i], ~kMaskL[i], 1u << i);
+    uint32_t sel = BitMask(b, i);
+    x = orc ? x | (swapped & sel) : (x & ~sel) | (swapped & sel);
+  }
+  return x;
+}
+
+// One stage of a shuffle: move the bits in |mask_r| |shift| bits to the left
+// and the bits in |mask_l| |shift| bits to the right
+static inline uint32_t ShuffleStage(uint32_t x, uint32_t mask_l,
+                                    uint32_t mask_r, unsigned int shift) {
+  return (x & ~(mask_l | mask_r)) | ((x << shift) & mask_l) |
+         ((x >> shift) & mask_r);
+}
+
+static const uint32_t kShuffleMaskL[4] = {0x00ff0000, 0x0f000f00, 0x30303030,
+                                          0x44444444};
+static const uint32_t kShuffleMaskR[4] = {0x0000ff00, 0x00f000f0, 0x0c0c0c0c,
+                                          0x22222222};
+
+static inline uint32_t Shfl(uint32_t x, uint32_t b) {
+  for (unsigned int i = 0; i < 4; ++i) {
+    uint32_t sel = BitMask(b, 3 - i);
+    uint32_t stage =
+        ShuffleStage(x, kShuffleMaskL[i], kShuffleMaskR[i], 8u >> i);
+    x = (x & ~sel) | (stage & sel);
+  }
+  return x;
+}
+
+static inline uint32_t Unshfl(uint32_t x, uint32_t b) {
+  for (unsigned int i = 0; i < 4; ++i) {
+    uint32_t sel = BitMask(b, i);
+    uint32_t stage = ShuffleStage(x, kShuffleMaskL[3 - i],
+                                  kShuffleMaskR[3 - i], 1u << i);
+    x = (x & ~sel) | (stage & sel);
+  }
+  return x;
+}
+
+static inline uint32_t Bext(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  unsigned int pos = 0;
+  for (unsigned int i = 0; i < 32; ++i) {
+    uint32_t sel = (b >> i) & 1;
+    result |= ((a >> i) & sel) << pos;
+    pos += sel;
+  }
+  return result;
+}
+
+static inline uint32_t Bdep(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  unsigned int pos = 0;
+  for (unsigned int i = 0; i < 32; ++i) {
+    uint32_t sel = (b >> i) & 1;
+    result |= ((a >> pos) & sel) << i;
+    pos += sel;
+  }
+  return result;
+}
+
+static inline uint32_t Clmul(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  for (unsigned int i = 0; i < 32; ++i) {
+    result ^= (a << i) & BitMask(b, i);
+  }
+  return result;
+}
+
+static inline uint32_t Clmulr(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  for (unsigned int i = 0; i < 32; ++i) {
+    result ^= (a >> (31 - i)) & BitMask(b, i);
+  }
+  return result;
+}
+
+static inline uint32_t Clmulh(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  for (unsigned int i = 1; i < 32; ++i) {
+    result ^= (a >> (32 - i)) & BitMask(b, i);
+  }
+  return result;
+}
+
+// CRC-32 (kCrc32Poly) and CRC-32C (kCrc32cPoly) in reflected bit order
+static const uint32_t kCrc32Poly = 0xedb88320;
+static const uint32_t kCrc32cPoly = 0x82f63b78;
+
+static inline uint32_t Crc(uint32_t x, uint32_t poly, unsigned int bits) {
+  for (unsigned int i = 0; i < bits; ++i) {
+    x = (x >> 1) ^ (poly & -(x & 1));
+  }
+  return x;
+}
+
+// Funnel shifts, the shift amount is b[5:0]. The shifts in two steps avoid
+// shifting by 32 bits when b[4:0] == 0.
+static inline uint32_t Fsl(uint32_t a, uint32_t b, uint32_t c) {
+  uint32_t swap = BitMask(b, 5);
+  uint32_t hi = (a & ~swap) | (c & swap);
+  uint32_t lo = (c & ~swap) | (a & swap);
+  uint32_t shamt = b & 31;
+  return (hi << shamt) | ((lo >> 1) >> (31 - shamt));
+}
+
+static inline uint32_t Fsr(uint32_t a, uint32_t b, uint32_t c) {
+  uint32_t swap = BitMask(b, 5);
+  uint32_t lo = (a & ~swap) | (c & swap);
+  uint32_t hi = (c & ~swap) | (a & swap);
+  uint32_t shamt = b & 31;
+  return (lo >> shamt) | ((hi << 1) << (31 - shamt));
+}
+
+static inline uint32_t Bfp(uint32_t a, uint32_t b) {
+  uint32_t len = (b >> 24) & 15;
+  uint32_t off = (b >> 16) & 31;
+  // A length of 0 encodes 16
+  uint32_t mask = ~(0xffffffffu << len) | (len ? 0 : 0xffff);
+  return (a & ~(mask << off)) | ((b & mask) << off);
+}
+
+static inline int32_t AsSigned(uint32_t x) { return static_cast<int32_t>(x); }
+
+// Apply |f| to each vector of a batch
+template <typename F>
+static void Map(const uint32_t *a, const uint32_t *b, const uint32_t *c,
+                uint32_t *result, size_t n, F f) {
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = f(a[i], b[i], c[i]);
+  }
+}
+
+void AluEvaluate(AluOp op, const uint32_t *a, const uint32_t *b,
+                 const uint32_t *c, uint32_t *result, size_t n) {
+  typedef uint32_t u;
+
+  switch (op) {
+    case kAluAdd:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a + b; });
+      break;
+    case kAluSub:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a - b; });
+      break;
+    case kAluXor:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a ^ b; });
+      break;
+    case kAluOr:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a | b; });
+      break;
+    case kAluAnd:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a & b; });
+      break;
+    case kAluXnor:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a ^ ~b; });
+      break;
+    case kAluOrn:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a | ~b; });
+      break;
+    case kAluAndn:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a & ~b; });
+      break;
+    case kAluSra:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return static_cast<u>(AsSigned(a) >> (b & 31)); });
+      break;
+    case kAluSrl:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a >> (b & 31); });
+      break;
+    case kAluSll:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a << (b & 31); });
+      break;
+    case kAluSro:
+      Map(a, b, c, result, n, [](u a, u b, u) { return ~(~a >> (b & 31)); });
+      break;
+    case kAluSlo:
+      Map(a, b, c, result, n, [](u a, u b, u) { return ~(~a << (b & 31)); });
+      break;
+    case kAluRor:
+      Map(a, b, c, result, n, [](u a, u b, u) {
+        return (a >> (b & 31)) | (a << ((32 - (b & 31)) & 31));
+      });
+      break;
+    case kAluRol:
+      Map(a, b, c, result, n, [](u a, u b, u) {
+        return (a << (b & 31)) | (a >> ((32 - (b & 31)) & 31));
+      });
+      break;
+    case kAluGrev:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Grev(a, b, false); });
+      break;
+    case kAluGorc:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Grev(a, b, true); });
+      break;
+    case kAluShfl:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Shfl(a, b); });
+      break;
+    case kAluUnshfl:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Unshfl(a, b); });
+      break;
+    case kAluLt:
+    case kAluSlt:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return u(AsSigned(a) < AsSigned(b)); });
+      break;
+    case kAluLtu:
+    case kAluSltu:
+      Map(a, b, c, result, n, [](u a, u b, u) { return u(a < b); });
+      break;
+    case kAluGe:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return u(AsSigned(a) >= AsSigned(b)); });
+      break;
+    case kAluGeu:
+      Map(a, b, c, result, n, [](u a, u b, u) { return u(a >= b); });
+      break;
+    case kAluEq:
+      Map(a, b, c, result, n, [](u a, u b, u) { return u(a == b); });
+      break;
+    case kAluNe:
+      Map(a, b, c, result, n, [](u a, u b, u) { return u(a != b); });
+      break;
+    case kAluMin:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return AsSigned(a) < AsSigned(b) ? a : b; });
+      break;
+    case kAluMinu:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a < b ? a : b; });
+      break;
+    case kAluMax:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return AsSigned(a) < AsSigned(b) ? b : a; });
+      break;
+    case kAluMaxu:
+      Map(a, b, c, result, n, [](u a, u b, u) { return a < b ? b : a; });
+      break;
+    case kAluPack:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return (b << 16) | (a & 0xffff); });
+      break;
+    case kAluPacku:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return (b & 0xffff0000) | (a >> 16); });
+      break;
+    case kAluPackh:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return ((b & 0xff) << 8) | (a & 0xff); });
+      break;
+    case kAluSextb:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return static_cast<u>(AsSigned(a << 24) >> 24); });
+      break;
+    case kAluSexth:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return static_cast<u>(AsSigned(a << 16) >> 16); });
+      break;
+    case kAluClz:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return a ? u(__builtin_clz(a)) : 32; });
+      break;
+    case kAluCtz:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return a ? u(__builtin_ctz(a)) : 32; });
+      break;
+    case kAluPcnt:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return u(__builtin_popcount(a)); });
+      break;
+    case kAluCmov:
+      Map(a, b, c, result, n, [](u a, u b, u c) { return b ? a : c; });
+      break;
+    case kAluCmix:
+      Map(a, b, c, result, n,
+          [](u a, u b, u c) { return (a & b) | (c & ~b); });
+      break;
+    case kAluFsl:
+      Map(a, b, c, result, n, [](u a, u b, u c) { return Fsl(a, b, c); });
+      break;
+    case kAluFsr:
+      Map(a, b, c, result, n, [](u a, u b, u c) { return Fsr(a, b, c); });
+      break;
+    case kAluSbset:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return a | (1u << (b & 31)); });
+      break;
+    case kAluSbclr:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return a & ~(1u << (b & 31)); });
+      break;
+    case kAluSbinv:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return a ^ (1u << (b & 31)); });
+      break;
+    case kAluSbext:
+      Map(a, b, c, result, n,
+          [](u a, u b, u) { return (a >> (b & 31)) & 1; });
+      break;
+    case kAluBext:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Bext(a, b); });
+      break;
+    case kAluBdep:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Bdep(a, b); });
+      break;
+    case kAluBfp:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Bfp(a, b); });
+      break;
+    case kAluClmul:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Clmul(a, b); });
+      break;
+    case kAluClmulr:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Clmulr(a, b); });
+      break;
+    case kAluClmulh:
+      Map(a, b, c, result, n, [](u a, u b, u) { return Clmulh(a, b); });
+      break;
+    case kAluCrc32B:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32Poly, 8); });
+      break;
+    case kAluCrc32cB:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32cPoly, 8); });
+      break;
+    case kAluCrc32H:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32Poly, 16); });
+      break;
+    case kAluCrc32cH:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32cPoly, 16); });
+      break;
+    case kAluCrc32W:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32Poly, 32); });
+      break;
+    case kAluCrc32cW:
+      Map(a, b, c, result, n,
+          [](u a, u, u) { return Crc(a, kCrc32cPoly, 32); });
+      break;
+    default:
+      assert(0);
+  }
+}
@@ -0,0 +1,111 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ALU_REF_MODEL_H_
+#define ALU_REF_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// ALU operations, must match the order of ibex_pkg::alu_op_e
+enum AluOp {
+  kAluAdd,
+  kAluSub,
+  kAluXor,
+  kAluOr,
+  kAluAnd,
+  kAluXnor,
+  kAluOrn,
+  kAluAndn,
+  kAluSra,
+  kAluSrl,
+  kAluSll,
+  kAluSro,
+  kAluSlo,
+  kAluRor,
+  kAluRol,
+  kAluGrev,
+  kAluGorc,
+  kAluShfl,
+  kAluUnshfl,
+  kAluLt,
+  kAluLtu,
+  kAluGe,
+  kAluGeu,
+  kAluEq,
+  kAluNe,
+  kAluMin,
+  kAluMinu,
+  kAluMax,
+  kAluMaxu,
+  kAluPack,
+  kAluPacku,
+  kAluPackh,
+  kAluSextb,
+  kAluSexth,
+  kAluClz,
+  kAluCtz,
+  kAluPcnt,
+  kAluSlt,
+  kAluSltu,
+  kAluCmov,
+  kAluCmix,
+  kAluFsl,
+  kAluFsr,
+  kAluSbset,
+  kAluSbclr,
+  kAluSbinv,
+  kAluSbext,
+  kAluBext,
+  kAluBdep,
+  kAluBfp,
+  kAluClmul,
+  kAluClmulr,
+  kAluClmulh,
+  kAluCrc32B,
+  kAluCrc32cB,
+  kAluCrc32H,
+  kAluCrc32cH,
+  kAluCrc32W,
+  kAluCrc32cW,
+  kNumAluOps
+};
+
+/**
+ * Name of the operation, e.g. "clmulr"
+ */
+const char *AluOpName(AluOp op);
+
+/**
+ * Lowest RV32B configuration (ibex_pkg::rv32b_e) implementing the operation
+ */
+unsigned int AluOpMinRv32b(AluOp op);
+
+/**
+ * Does the operation take two cycles?
+ */
+bool AluOpMultiCycle(AluOp op);
+
+/**
+ * Does the operation have a third operand? The ID stage passes it as
+ * operand a in the second cycle.
+ */
+bool AluOpTernary(AluOp op);
+
+/**
+ * Compute the results of an operation for a batch of operand vectors
+ *
+ * Implements the RISC-V base ISA and the draft bitmanip extension (v0.92)
+ * that ibex_alu implements. Each operation is a loop without data dependent
+ * branches over the whole batch, which the compiler vectorizes.
+ *
+ * @param a, b, c First, second and third operand of each vector (c is only
+ *                used by ternary operations)
+ * @param result Result of each vector
+ * @param n Number of vectors
+ */
+void AluEvaluate(AluOp op, const uint32_t *a, const uint32_t *b,
+                 const uint32_t *c, uint32_t *result, size_t n);
+
+#endif  // ALU_REF_MODEL_H_
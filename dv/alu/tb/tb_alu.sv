@@ -0,0 +1,130 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Select the bit manipulation extension with the RV32B define, e.g. with
+// --RV32B=ibex_pkg::RV32BFull in fusesoc
+`ifndef RV32B
+  `define RV32B ibex_pkg::RV32BNone
+`endif
+
+/**
+ * ALU testbench
+ *
+ * Instantiates ibex_alu together with the intermediate value register of the
+ * ID stage, which the multicycle operations use. The C++ driver in
+ * ../cpp/alu_bench.cc issues operand vectors and checks the results. It is
+ * called once per clock edge with the sampled DUT outputs, and returns the
+ * DUT inputs for the next cycle.
+ */
+module tb_alu #(
+  parameter ibex_pkg::rv32b_e RV32B = `RV32B
+) (
+  input logic clk_i,
+  input logic rst_ni
+);
+
+  import ibex_pkg::*;
+
+  import "DPI-C" function void alu_tb_init(input int rv32b);
+
+  import "DPI-C" function void alu_tb_tick(
+    // DUT outputs, sampled at the clock edge
+    input  bit        valid,
+    input  bit [31:0] result,
+    // DUT inputs for the next cycle
+    output bit [5:0]  alu_operator,
+    output bit [31:0] operand_a,
+    output bit [31:0] operand_b,
+    output bit        instr_first_cycle,
+    output bit        stop);
+
+  alu_op_e     alu_operator;
+  logic [31:0] operand_a;
+  logic [31:0] operand_b;
+  logic        instr_first_cycle;
+
+  logic        valid;
+  logic [31:0] result;
+
+  // Intermediate value register, as in ibex_id_stage
+  logic [1:0]  imd_val_we;
+  logic [31:0] imd_val_d[2];
+  logic [31:0] imd_val_q[2];
+
+  for (genvar i = 0; i < 2; i++) begin : gen_imd_val
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        imd_val_q[i] <= '0;
+      end else if (imd_val_we[i]) begin
+        imd_val_q[i] <= imd_val_d[i];
+      end
+    end
+  end
+
+  logic [31:0] unused_adder_result;
+  logic [33:0] unused_adder_result_ext;
+  logic        unused_comparison_result;
+  logic        unused_is_equal_result;
+
+  ibex_alu #(
+    .RV32B (RV32B)
+  ) u_alu (
+    .operator_i          (alu_operator),
+    .operand_a_i         (operand_a),
+    .operand_b_i         (operand_b),
+
+    .instr_first_cycle_i (instr_first_cycle),
+
+    .multdiv_operand_a_i ('0),
+    .multdiv_operand_b_i ('0),
+
+    .multdiv_sel_i       (1'b0),
+
+    .imd_val_q_i         (imd_val_q),
+    .imd_val_d_o         (imd_val_d),
+    .imd_val_we_o        (imd_val_we),
+
+    .adder_result_o      (unused_adder_result),
+    .adder_result_ext_o  (unused_adder_result_ext),
+
+    .result_o            (result),
+    .comparison_result_o (unused_comparison_result),
+    .is_equal_result_o   (unused_is_equal_result)
+  );
+
+  // The result is valid unless the ALU writes the intermediate value register,
+  // as in ibex_ex_block
+  assign valid = ~(|imd_val_we);
+
+  initial begin
+    alu_tb_init(RV32B);
+  end
+
+  // Outputs of alu_tb_tick(), applied to the DUT after the clock edge
+  bit [5:0]  alu_operator_d;
+  bit [31:0] operand_a_d;
+  bit [31:0] operand_b_d;
+  bit        instr_first_cycle_d;
+  bit        stop;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      alu_operator      <= ALU_ADD;
+      operand_a         <= '0;
+      operand_b         <= '0;
+      instr_first_cycle <= 1'b0;
+    end else begin
+      alu_tb_tick(valid, result,
+                  alu_operator_d, operand_a_d, operand_b_d, instr_first_cycle_d, stop);
+      alu_operator      <= alu_op_e'(alu_operator_d);
+      operand_a         <= operand_a_d;
+      operand_b         <= operand_b_d;
+      instr_first_cycle <= instr_first_cycle_d;
+      if (stop) begin
+        $finish();
+      end
+    end
+  end
+
+endmodule
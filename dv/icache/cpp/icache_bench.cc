@@ -0,0 +1,560 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "icache_bench.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// Base address of the code footprint branches go to
+static const uint32_t kCodeBase = 0x00100000;
+// Probability of a branch to anywhere in 16 times the footprint, to create
+// conflicts with the lines in the cache
+static const double kFarBranchProb = 1.0 / 16;
+// Probability of asserting branch_spec_i without a branch in a cycle
+static const double kSpecOnlyProb = 1.0 / 64;
+// Probability of lowering req_i in a cycle
+static const double kReqLowProb = 1.0 / 256;
+// Longest latency in the histograms, longer latencies go into the last bin
+static const size_t kMaxLatency = 63;
+
+// Must match the order of the performance probes in ibex_icache.sv
+static const char *const kCounterNames[] = {
+    "ICache Lookups",           "ICache Hits",
+    "ICache Misses",            "ICache Fills",
+    "ICache Fill Buffer Stalls", "ICache Invalidations",
+    "ICache ECC Errors"};
+static const int kNumCounters = sizeof(kCounterNames) / sizeof(*kCounterNames);
+
+// The instance accessed by the DPI functions below
+static IcacheBench *icache_bench_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void icache_tb_init(int cache_size_bytes, int line_size, int num_ways,
+                    svBit ecc, svBit spec_request, svBit branch_cache) {
+  assert(icache_bench_instance);
+  icache_bench_instance->Init(cache_size_bytes, line_size, num_ways, ecc,
+                              spec_request, branch_cache);
+}
+
+svBit icache_tb_pmp_err(const svBitVecVal *addr) {
+  return icache_bench_instance &&
+         icache_bench_instance->MemModel().PmpErr(addr[0]);
+}
+
+void icache_tb_tick(svBit valid, const svBitVecVal *rdata,
+                    const svBitVecVal *addr, svBit err, svBit err_plus2,
+                    svBit instr_req, const svBitVecVal *instr_addr,
+                    svBit instr_pmp_err, svBit busy, svBit *req,
+                    svBit *branch, svBit *branch_spec,
+                    svBitVecVal *branch_addr, svBit *ready, svBit *instr_gnt,
+                    svBit *instr_rvalid, svBitVecVal *instr_rdata,
+                    svBit *instr_err, svBit *enable, svBit *inval,
+                    svBit *stop) {
+  assert(icache_bench_instance);
+
+  IcacheBenchOutputs out;
+  out.valid = valid;
+  out.rdata = rdata[0];
+  out.addr = addr[0];
+  out.err = err;
+  out.err_plus2 = err_plus2;
+  out.instr_req = instr_req;
+  out.instr_addr = instr_addr[0];
+  out.instr_pmp_err = instr_pmp_err;
+  out.busy = busy;
+
+  IcacheBenchInputs in;
+  *stop = icache_bench_instance->Tick(out, in);
+
+  *req = in.req;
+  *branch = in.branch;
+  *branch_spec = in.branch_spec;
+  branch_addr[0] = in.branch_addr;
+  *ready = in.ready;
+  *instr_gnt = in.instr_gnt;
+  *instr_rvalid = in.instr_rvalid;
+  instr_rdata[0] = in.instr_rdata;
+  *instr_err = in.instr_err;
+  *enable = in.enable;
+  *inval = in.inval;
+}
+
+void icache_tb_counter(int index, long long value) {
+  assert(icache_bench_instance);
+  icache_bench_instance->SetCounter(index, value);
+}
+}
+
+IcacheBench::IcacheBench()
+    : max_fetches_(1000000),
+      seed_(1),
+      footprint_(0),
+      branch_prob_(1.0 / 8),
+      ready_prob_(0.9),
+      gnt_prob_(0.8),
+      latency_min_(0),
+      latency_max_(2),
+      mem_err_words_(4096),
+      pmp_err_regions_(256),
+      inval_prob_(1.0 / 100000),
+      enable_prob_(1.0 / 200000),
+      ref_(mem_),
+      hit_latency_(kMaxLatency + 1),
+      miss_latency_(kMaxLatency + 1),
+      counters_(kNumCounters) {
+  assert(!icache_bench_instance &&
+         "Only one IcacheBench instance is supported.");
+  icache_bench_instance = this;
+}
+
+IcacheBench::~IcacheBench() { icache_bench_instance = nullptr; }
+
+// Parse a probability given in percent
+static bool ParsePercent(const char *arg, double &prob) {
+  char *end;
+  double percent = strtod(arg, &end);
+  if (*end != '\0' || percent < 0.0 || percent > 100.0) {
+    std::cerr << "ERROR: Invalid percentage: " << arg << std::endl;
+    return false;
+  }
+  prob = percent / 100.0;
+  return true;
+}
+
+// Parse an average number of events N, giving a probability of 1/N
+static bool ParseRate(const char *arg, double &prob) {
+  char *end;
+  unsigned long rate = strtoul(arg, &end, 0);
+  if (*end != '\0') {
+    std::cerr << "ERROR: Invalid rate: " << arg << std::endl;
+    return false;
+  }
+  prob = rate ? 1.0 / rate : 0.0;
+  return true;
+}
+
+bool IcacheBench::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"fetches", required_argument, nullptr, 'n'},
+      {"seed", required_argument, nullptr, 'S'},
+      {"footprint", required_argument, nullptr, 'F'},
+      {"branch-rate", required_argument, nullptr, 'B'},
+      {"ready", required_argument, nullptr, 'R'},
+      {"gnt", required_argument, nullptr, 'G'},
+      {"mem-latency", required_argument, nullptr, 'L'},
+      {"mem-err", required_argument, nullptr, 'E'},
+      {"pmp-err", required_argument, nullptr, 'P'},
+      {"inval-rate", required_argument, nullptr, 'I'},
+      {"enable-rate", required_argument, nullptr, 'N'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'n':
+        max_fetches_ = strtoull(optarg, nullptr, 0);
+        break;
+      case 'S':
+        seed_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'F':
+        footprint_ = strtoul(optarg, nullptr, 0);
+        if (footprint_ < 4) {
+          std::cerr << "ERROR: Invalid footprint: " << optarg << std::endl;
+          return false;
+        }
+        break;
+      case 'B': {
+        if (!ParseRate(optarg, branch_prob_)) {
+          return false;
+        }
+        break;
+      }
+      case 'R':
+        if (!ParsePercent(optarg, ready_prob_)) {
+          return false;
+        }
+        break;
+      case 'G':
+        if (!ParsePercent(optarg, gnt_prob_) || gnt_prob_ == 0.0) {
+          std::cerr << "ERROR: The grant probability must be non-zero."
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'L': {
+        char *end;
+        latency_min_ = strtoul(optarg, &end, 0);
+        latency_max_ = *end == ':' ? strtoul(end + 1, &end, 0) : latency_min_;
+        if (*end != '\0' || latency_max_ < latency_min_) {
+          std::cerr << "ERROR: Invalid latency: " << optarg << std::endl;
+          return false;
+        }
+        break;
+      }
+      case 'E':
+        mem_err_words_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'P':
+        pmp_err_regions_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'I':
+        if (!ParseRate(optarg, inval_prob_)) {
+          return false;
+        }
+        break;
+      case 'N':
+        if (!ParseRate(optarg, enable_prob_)) {
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void IcacheBench::PrintHelp() const {
+  std::cout << "ICache testbench:\n\n"
+               "--fetches=N\n"
+               "  Stop after N instructions have been fetched (default: "
+            << max_fetches_
+            << ", 0: run until the cycle limit)\n\n"
+               "--seed=N\n"
+               "  Seed of the random stimulus (default: "
+            << seed_
+            << ")\n\n"
+               "--footprint=BYTES\n"
+               "  Size of the code branches go to (default: half the cache)\n\n"
+               "--branch-rate=N\n"
+               "  Branch after N instructions on average (default: "
+            << 1.0 / branch_prob_
+            << ")\n\n"
+               "--ready=PERCENT\n"
+               "  Probability of the core being ready in a cycle (default: "
+            << ready_prob_ * 100
+            << ")\n\n"
+               "--gnt=PERCENT\n"
+               "  Probability of the memory granting a request in a cycle\n"
+               "  (default: "
+            << gnt_prob_ * 100
+            << ")\n\n"
+               "--mem-latency=MIN[:MAX]\n"
+               "  Memory response latency in cycles after the grant cycle\n"
+               "  (default: "
+            << latency_min_ << ":" << latency_max_
+            << ")\n\n"
+               "--mem-err=N\n"
+               "  One in N memory words returns a bus error (default: "
+            << mem_err_words_
+            << ", 0: none)\n\n"
+               "--pmp-err=N\n"
+               "  One in N 256 byte regions has a PMP error (default: "
+            << pmp_err_regions_
+            << ", 0: none)\n\n"
+               "--inval-rate=N\n"
+               "  Change the memory contents and invalidate the cache every\n"
+               "  N cycles on average (default: "
+            << (inval_prob_ > 0.0 ? 1.0 / inval_prob_ : 0.0)
+            << ", 0: never)\n\n"
+               "--enable-rate=N\n"
+               "  Toggle the cache enable every N cycles on average (default: "
+            << (enable_prob_ > 0.0 ? 1.0 / enable_prob_ : 0.0)
+            << ", 0: never)\n\n";
+}
+
+void IcacheBench::PreExec() {
+  rng_.seed(seed_);
+  mem_.SetErrorRates(mem_err_words_, pmp_err_regions_);
+  mem_seed_ = rng_();
+  ref_.Reset(mem_seed_);
+
+  cycle_ = 0;
+  memset(&in_, 0, sizeof(in_));
+  branch_next_ = true;
+  mem_rsps_.clear();
+  latency_pending_ = false;
+
+  errors_ = 0;
+  fetches_ = 0;
+  fetch_errs_ = 0;
+  branches_ = 0;
+  ready_cycles_ = 0;
+  mem_grants_ = 0;
+  mem_pmp_errs_ = 0;
+  mem_beats_ = 0;
+  busy_cycles_ = 0;
+  invals_ = 0;
+  time_begin_ = std::chrono::steady_clock::now();
+}
+
+void IcacheBench::PostExec() { time_end_ = std::chrono::steady_clock::now(); }
+
+void IcacheBench::Init(unsigned int cache_size_bytes, unsigned int line_size,
+                       unsigned int num_ways, bool ecc, bool spec_request,
+                       bool branch_cache) {
+  std::ostringstream config;
+  config << cache_size_bytes << " bytes, " << num_ways << " ways, "
+         << line_size << " bit lines" << (ecc ? ", ECC" : "")
+         << (spec_request ? ", SpecRequest" : "")
+         << (branch_cache ? ", BranchCache" : "");
+  if (!footprint_) {
+    footprint_ = cache_size_bytes / 2;
+  }
+
+  std::cout << "ICache: " << config.str() << std::endl
+            << "Stimulus seed " << seed_ << ", footprint " << footprint_
+            << " bytes" << std::endl;
+}
+
+uint32_t IcacheBench::BranchTarget() {
+  uint64_t range = footprint_;
+  if (Chance(kFarBranchProb)) {
+    range *= 16;
+  }
+  return (kCodeBase + rng_() % range) & ~1u;
+}
+
+void IcacheBench::Error(const std::string &msg) {
+  std::cerr << "ERROR: Cycle " << cycle_ << ": " << msg << std::endl;
+  errors_++;
+}
+
+bool IcacheBench::Tick(const IcacheBenchOutputs &out, IcacheBenchInputs &in) {
+  // |in_| holds the inputs of the cycle ending at this clock edge
+  cycle_++;
+
+  // Core side
+  if (in_.branch) {
+    // Anything passed to the core in a branch cycle is ignored
+    ref_.Branch(in_.branch_addr);
+    branches_++;
+    latency_pending_ = true;
+    branch_cycle_ = cycle_;
+    branch_saw_rvalid_ = false;
+  } else {
+    if (latency_pending_) {
+      branch_saw_rvalid_ |= in_.instr_rvalid;
+      if (out.valid) {
+        std::vector<uint64_t> &hist =
+            branch_saw_rvalid_ ? miss_latency_ : hit_latency_;
+        hist[std::min<uint64_t>(cycle_ - branch_cycle_, kMaxLatency)]++;
+        latency_pending_ = false;
+      }
+    }
+
+    if (in_.ready) {
+      ready_cycles_++;
+    }
+
+    if (out.valid && in_.ready) {
+      fetches_++;
+      if (!ref_.Fetch(out.addr, out.rdata, out.err, out.err_plus2)) {
+        Error(ref_.Error());
+      }
+      // The core takes an exception on a fetch error, which is a branch for
+      // the cache
+      if (out.err) {
+        fetch_errs_++;
+        branch_next_ = true;
+      } else if (Chance(branch_prob_)) {
+        branch_next_ = true;
+      }
+    }
+  }
+
+  // Memory side. Each granted request has to be answered, the cache must be
+  // busy while it waits for responses.
+  if (!out.busy && (!mem_rsps_.empty() || in_.instr_rvalid)) {
+    std::ostringstream msg;
+    msg << "Not busy with " << mem_rsps_.size() + in_.instr_rvalid
+        << " outstanding memory requests";
+    Error(msg.str());
+  }
+  if (out.busy) {
+    busy_cycles_++;
+  }
+  if (in_.instr_rvalid) {
+    mem_beats_++;
+  }
+  if (out.instr_req) {
+    if (out.instr_pmp_err) {
+      // PMP errors complete the request without going to memory
+      mem_pmp_errs_++;
+    } else if (in_.instr_gnt) {
+      mem_grants_++;
+      unsigned int latency =
+          latency_min_ + rng_() % (latency_max_ - latency_min_ + 1);
+      mem_rsps_.push_back({cycle_ + 1 + latency, out.instr_addr});
+    }
+  }
+
+  // Inputs for the next cycle
+  IcacheBenchInputs next = in_;
+  next.branch = false;
+  next.branch_spec = false;
+  next.inval = false;
+  if (cycle_ == 1) {
+    next.req = true;
+    next.enable = true;
+    ref_.Enable(true);
+  }
+
+  if (branch_next_) {
+    next.req = true;
+    next.branch = true;
+    next.branch_spec = true;
+    next.branch_addr = BranchTarget();
+    branch_next_ = false;
+  } else {
+    next.req = !Chance(kReqLowProb);
+    next.branch_spec = Chance(kSpecOnlyProb);
+    if (Chance(inval_prob_)) {
+      // New memory contents, which the cache only has to return after the
+      // invalidation and a branch
+      ref_.Invalidate();
+      mem_seed_ = rng_();
+      ref_.NewSeed(mem_seed_);
+      next.inval = true;
+      invals_++;
+    } else if (Chance(enable_prob_)) {
+      next.enable = !next.enable;
+      ref_.Enable(next.enable);
+    }
+  }
+  next.ready = Chance(ready_prob_);
+
+  next.instr_gnt = Chance(gnt_prob_);
+  next.instr_rvalid = false;
+  if (!mem_rsps_.empty() && mem_rsps_.front().cycle <= cycle_ + 1) {
+    uint32_t addr = mem_rsps_.front().addr;
+    mem_rsps_.pop_front();
+    next.instr_rvalid = true;
+    next.instr_rdata = mem_.Read(mem_seed_, addr);
+    next.instr_err = mem_.MemErr(addr);
+  }
+
+  in_ = next;
+  in = next;
+  return errors_ || (max_fetches_ && fetches_ >= max_fetches_);
+}
+
+void IcacheBench::SetCounter(int index, uint64_t value) {
+  if (index >= 0 && index < kNumCounters) {
+    counters_[index] = value;
+  }
+}
+
+// Average of a latency histogram
+static double HistAvg(const std::vector<uint64_t> &hist, uint64_t &count) {
+  uint64_t sum = 0;
+  count = 0;
+  for (size_t i = 0; i < hist.size(); ++i) {
+    count += hist[i];
+    sum += i * hist[i];
+  }
+  return count ? static_cast<double>(sum) / count : 0.0;
+}
+
+std::string IcacheBench::ReportString(bool csv) const {
+  char separator = csv ? ',' : ':';
+  StatValues values;
+
+  double seconds =
+      std::chrono::duration<double>(time_end_ - time_begin_).count();
+  uint64_t hits, misses;
+  double hit_avg = HistAvg(hit_latency_, hits);
+  double miss_avg = HistAvg(miss_latency_, misses);
+
+  AddStat(values, "Cycles", cycle_);
+  AddStat(values, "Fetches", fetches_);
+  AddStat(values, "Fetch Errors", fetch_errs_);
+  AddStat(values, "Mismatches", errors_);
+  AddStat(values, "Branches", branches_);
+  AddStatRatio(values, "Fetches/Cycle",
+               cycle_ ? static_cast<double>(fetches_) / cycle_ : 0.0);
+  AddStatRatio(
+      values, "Fetches/Ready Cycle",
+      ready_cycles_ ? static_cast<double>(fetches_) / ready_cycles_ : 0.0);
+  AddStat(values, "Branches Served Without Memory", hits);
+  AddStatRatio(values, "Branch Latency Without Memory", hit_avg);
+  AddStat(values, "Branches Served From Memory", misses);
+  AddStatRatio(values, "Branch Latency From Memory", miss_avg);
+  AddStat(values, "Memory Requests", mem_grants_);
+  AddStat(values, "Memory PMP Errors", mem_pmp_errs_);
+  AddStatRatio(
+      values, "Memory Beats/Busy Cycle",
+      busy_cycles_ ? static_cast<double>(mem_beats_) / busy_cycles_ : 0.0);
+  AddStatRatio(values, "Memory Beats/Fetch",
+               fetches_ ? static_cast<double>(mem_beats_) / fetches_ : 0.0);
+  AddStat(values, "Invalidations", invals_);
+  AddStat(values, "Fetches Of Old Data", ref_.OldFetches());
+  AddStat(values, "Fetches/s", seconds > 0.0 ? fetches_ / seconds : 0);
+  for (int i = 0; i < kNumCounters; ++i) {
+    AddStat(values, kCounterNames[i], counters_[i]);
+  }
+
+  std::stringstream report_ss;
+  report_ss << FormatStats(values, csv);
+
+  // Latency histograms, one line per latency
+  if (!csv) {
+    report_ss << std::endl
+              << std::setw(8) << "Latency" << std::setw(16) << "w/o Memory"
+              << std::setw(16) << "From Memory" << std::endl;
+  }
+  for (size_t i = 0; i <= kMaxLatency; ++i) {
+    if (!hit_latency_[i] && !miss_latency_[i]) {
+      continue;
+    }
+    if (csv) {
+      report_ss << "Branch Latency " << i << separator << hit_latency_[i]
+                << separator << miss_latency_[i] << std::endl;
+    } else {
+      report_ss << std::setw(7) << i << (i == kMaxLatency ? "+" : " ")
+                << std::setw(16) << hit_latency_[i] << std::setw(16)
+                << miss_latency_[i] << std::endl;
+    }
+  }
+
+  return report_ss.str();
+}
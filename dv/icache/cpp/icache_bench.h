@@ -0,0 +1,193 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ICACHE_BENCH_H_
+#define ICACHE_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ibex_tb_driver.h"
+#include "icache_mem_model.h"
+#include "icache_ref_model.h"
+
+// Inputs of the ICache driven by the testbench in one cycle
+struct IcacheBenchInputs {
+  bool req;
+  bool branch;
+  bool branch_spec;
+  uint32_t branch_addr;
+  bool ready;
+  bool instr_gnt;
+  bool instr_rvalid;
+  uint32_t instr_rdata;
+  bool instr_err;
+  bool enable;
+  bool inval;
+};
+
+// Outputs of the ICache sampled by the testbench at a clock edge
+struct IcacheBenchOutputs {
+  bool valid;
+  uint32_t rdata;
+  uint32_t addr;
+  bool err;
+  bool err_plus2;
+  bool instr_req;
+  uint32_t instr_addr;
+  bool instr_pmp_err;
+  bool busy;
+};
+
+/**
+ * Driver, memory agent and scoreboard of the ICache testbench
+ *
+ * Called through DPI from tb/tb_icache.sv in every cycle. The core side
+ * branches to random targets within a configurable code footprint, fetches
+ * sequentially in between, applies back-pressure and occasionally invalidates
+ * or disables the cache. The memory side grants requests and responds in
+ * order after a random latency, with data from an IcacheMemModel. Every
+ * instruction passed to the core is checked by an IcacheRefModel.
+ *
+ * Besides checking, the bench measures the latency from a branch to the first
+ * instruction (separately for branches served without and with a memory
+ * response) and the fill throughput on the memory bus.
+ *
+ * The bench is configured on the command line, see PrintHelp().
+ */
+class IcacheBench : public IbexTestbench {
+ public:
+  IcacheBench();
+  ~IcacheBench();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Seed the stimulus and reset the statistics
+   */
+  virtual void PreExec();
+
+  /**
+   * Stop the wall clock time measurement
+   */
+  virtual void PostExec();
+
+  /**
+   * Set the cache configuration (the parameters of the DUT)
+   */
+  void Init(unsigned int cache_size_bytes, unsigned int line_size,
+            unsigned int num_ways, bool ecc, bool spec_request,
+            bool branch_cache);
+
+  /**
+   * Check and record the DUT outputs at a clock edge, and choose the inputs
+   * for the next cycle
+   *
+   * @return true if the simulation should stop
+   */
+  bool Tick(const IcacheBenchOutputs &out, IcacheBenchInputs &in);
+
+  /**
+   * Record the final value of a simulation-only ICache event counter
+   */
+  void SetCounter(int index, uint64_t value);
+
+  const IcacheMemModel &MemModel() const { return mem_; }
+
+  /**
+   * Did all checks pass?
+   */
+  virtual bool Passed() const { return errors_ == 0; }
+
+  /**
+   * Returns a formatted string of the bench statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  virtual std::string ReportString(bool csv) const;
+
+ private:
+  // Configuration
+  uint64_t max_fetches_;
+  unsigned int seed_;
+  uint32_t footprint_;
+  double branch_prob_;
+  double ready_prob_;
+  double gnt_prob_;
+  unsigned int latency_min_;
+  unsigned int latency_max_;
+  uint32_t mem_err_words_;
+  uint32_t pmp_err_regions_;
+  double inval_prob_;
+  double enable_prob_;
+
+  std::mt19937 rng_;
+  IcacheMemModel mem_;
+  IcacheRefModel ref_;
+
+  // State of the driver and the memory agent
+  uint64_t cycle_;
+  IcacheBenchInputs in_;
+  uint32_t mem_seed_;
+  bool branch_next_;
+  struct MemRsp {
+    uint64_t cycle;  // Clock edge at which the response can be sampled
+    uint32_t addr;
+  };
+  std::deque<MemRsp> mem_rsps_;
+
+  // Branch latency measurement
+  bool latency_pending_;
+  uint64_t branch_cycle_;
+  bool branch_saw_rvalid_;
+
+  // Statistics
+  uint64_t errors_;
+  uint64_t fetches_;
+  uint64_t fetch_errs_;
+  uint64_t branches_;
+  uint64_t ready_cycles_;
+  uint64_t mem_grants_;
+  uint64_t mem_pmp_errs_;
+  uint64_t mem_beats_;
+  uint64_t busy_cycles_;
+  uint64_t invals_;
+  std::vector<uint64_t> hit_latency_;
+  std::vector<uint64_t> miss_latency_;
+  std::vector<uint64_t> counters_;
+  std::chrono::steady_clock::time_point time_begin_;
+  std::chrono::steady_clock::time_point time_end_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  bool Chance(double prob) {
+    return std::generate_canonical<double, 32>(rng_) < prob;
+  }
+
+  /**
+   * Choose a new branch target
+   */
+  uint32_t BranchTarget();
+
+  void Error(const std::string &msg);
+};
+
+#endif  // ICACHE_BENCH_H_
@@ -0,0 +1,40 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "icache_mem_model.h"
+
+// Salts keeping the error patterns independent of the memory contents
+static const uint64_t kMemErrSalt = 0x6d656d5f65727221ULL;
+static const uint64_t kPmpErrSalt = 0x706d705f65727221ULL;
+
+// Finalizer of the SplitMix64 generator, a cheap hash with good avalanche
+static uint64_t Mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+IcacheMemModel::IcacheMemModel() : mem_err_words_(0), pmp_err_regions_(0) {}
+
+void IcacheMemModel::SetErrorRates(uint32_t mem_err_words,
+                                   uint32_t pmp_err_regions) {
+  mem_err_words_ = mem_err_words;
+  pmp_err_regions_ = pmp_err_regions;
+}
+
+uint32_t IcacheMemModel::Read(uint32_t seed, uint32_t addr) const {
+  return Mix((uint64_t(seed) << 32) | (addr >> 2));
+}
+
+bool IcacheMemModel::MemErr(uint32_t addr) const {
+  return mem_err_words_ && Mix(kMemErrSalt ^ (addr >> 2)) % mem_err_words_ == 0;
+}
+
+bool IcacheMemModel::PmpErr(uint32_t addr) const {
+  return pmp_err_regions_ &&
+         Mix(kPmpErrSalt ^ (addr >> 8)) % pmp_err_regions_ == 0;
+}
@@ -0,0 +1,60 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ICACHE_MEM_MODEL_H_
+#define ICACHE_MEM_MODEL_H_
+
+#include <cstdint>
+
+/**
+ * Backing memory of the ICache testbench
+ *
+ * The memory contents are a hash of the word address and a seed, so any
+ * address can be read without storing anything. Changing the seed models new
+ * code being written to memory, which the cache only has to pick up after an
+ * invalidation.
+ *
+ * Bus errors and PMP errors are a fixed property of an address, independent of
+ * the seed. Bus errors hit single words, PMP errors hit 256 byte regions.
+ */
+class IcacheMemModel {
+ public:
+  IcacheMemModel();
+
+  /**
+   * Set the error rates
+   *
+   * @param mem_err_words One in |mem_err_words| words has a bus error (0: no
+   *                      bus errors)
+   * @param pmp_err_regions One in |pmp_err_regions| regions has a PMP error
+   *                        (0: no PMP errors)
+   */
+  void SetErrorRates(uint32_t mem_err_words, uint32_t pmp_err_regions);
+
+  /**
+   * Contents of the word at |addr| (rounded down to a word) for |seed|
+   */
+  uint32_t Read(uint32_t seed, uint32_t addr) const;
+
+  /**
+   * Does a fetch of the word at |addr| get a bus error?
+   */
+  bool MemErr(uint32_t addr) const;
+
+  /**
+   * Does a fetch of the word at |addr| get a PMP error?
+   */
+  bool PmpErr(uint32_t addr) const;
+
+  /**
+   * Does a fetch of the word at |addr| fail for either reason?
+   */
+  bool Err(uint32_t addr) const { return MemErr(addr) || PmpErr(addr); }
+
+ private:
+  uint32_t mem_err_words_;
+  uint32_t pmp_err_regions_;
+};
+
+#endif  // ICACHE_MEM_MODEL_H_
@@ -0,0 +1,171 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "icache_ref_model.h"
+
+#include <iomanip>
+#include <sstream>
+
+IcacheRefModel::IcacheRefModel(const IcacheMemModel &mem) : mem_(mem) {
+  Reset(0);
+}
+
+void IcacheRefModel::Reset(uint32_t seed) {
+  error_.clear();
+  seeds_.assign(1, seed);
+  inval_pending_ = false;
+  inval_seed_ = 0;
+  branch_seed_ = 0;
+  enabled_ = false;
+  no_cache_ = true;
+  addr_valid_ = false;
+  next_addr_ = 0;
+  possible_old_ = 0;
+  actual_old_ = 0;
+}
+
+void IcacheRefModel::NewSeed(uint32_t seed) { seeds_.push_back(seed); }
+
+void IcacheRefModel::Branch(uint32_t addr) {
+  next_addr_ = addr;
+  addr_valid_ = true;
+
+  if (inval_pending_) {
+    // Anything older than the seed current at the invalidation is gone now
+    seeds_.erase(seeds_.begin(), seeds_.begin() + inval_seed_);
+    inval_pending_ = false;
+  }
+  branch_seed_ = seeds_.size() - 1;
+  if (!enabled_) {
+    no_cache_ = true;
+  }
+}
+
+void IcacheRefModel::Invalidate() {
+  inval_pending_ = true;
+  inval_seed_ = seeds_.size() - 1;
+}
+
+void IcacheRefModel::Enable(bool enable) {
+  enabled_ = enable;
+  if (enable) {
+    no_cache_ = false;
+  }
+}
+
+bool IcacheRefModel::Compatible1(uint32_t addr, uint32_t rdata, bool err,
+                                 uint32_t seed) const {
+  uint32_t addr_lo = addr & ~3u;
+  if (mem_.Err(addr_lo)) {
+    // The data doesn't matter if the fetch failed
+    return err;
+  }
+  if (err) {
+    return false;
+  }
+
+  uint32_t exp = mem_.Read(seed, addr_lo) >> (8 * (addr - addr_lo));
+  if ((exp & 3) != 3) {
+    return (rdata & 0xffff) == (exp & 0xffff);
+  }
+  return rdata == exp;
+}
+
+bool IcacheRefModel::Compatible2(uint32_t addr, uint32_t rdata, bool err_hi,
+                                 uint32_t seed_lo, uint32_t seed_hi) const {
+  uint32_t addr_lo = addr & ~3u;
+  uint32_t addr_hi = addr_lo + 4;
+  if (mem_.Err(addr_lo)) {
+    return false;
+  }
+  bool exp_err_hi = mem_.Err(addr_hi);
+  if (exp_err_hi != err_hi) {
+    return false;
+  }
+  if (exp_err_hi) {
+    return true;
+  }
+  uint32_t exp =
+      (mem_.Read(seed_lo, addr_lo) >> 16) | (mem_.Read(seed_hi, addr_hi) << 16);
+  return rdata == exp;
+}
+
+bool IcacheRefModel::Fetch(uint32_t addr, uint32_t rdata, bool err,
+                           bool err_plus2) {
+  std::ostringstream msg;
+  msg << std::hex << std::setfill('0');
+
+  if (!addr_valid_) {
+    msg << "Fetch at 0x" << std::setw(8) << addr << " before any branch";
+    error_ = msg.str();
+    return false;
+  }
+  if (addr != next_addr_) {
+    msg << "Fetch at 0x" << std::setw(8) << addr << ", expected 0x"
+        << std::setw(8) << next_addr_;
+    error_ = msg.str();
+    return false;
+  }
+  next_addr_ += (rdata & 3) == 3 ? 4 : 2;
+
+  bool misaligned = addr & 3;
+  bool good_bottom_word = !err || err_plus2;
+  bool uncompressed = (rdata & 3) == 3;
+  size_t min_idx = no_cache_ ? branch_seed_ : 0;
+  size_t num_seeds = seeds_.size();
+  size_t age = 0;
+  bool match = false;
+
+  if (misaligned && good_bottom_word && uncompressed) {
+    // The instruction spans two memory words, which might have been fetched
+    // with different seeds. Matching seeds are by far the most common case.
+    bool err_hi = err && err_plus2;
+    for (size_t i = num_seeds; !match && i-- > min_idx;) {
+      match = Compatible2(addr, rdata, err_hi, seeds_[i], seeds_[i]);
+      age = num_seeds - 1 - i;
+    }
+    for (size_t i = num_seeds; !match && i-- > min_idx;) {
+      for (size_t j = num_seeds; !match && j-- > min_idx;) {
+        if (i != j) {
+          match = Compatible2(addr, rdata, err_hi, seeds_[i], seeds_[j]);
+          age = num_seeds - 1 - (i < j ? i : j);
+        }
+      }
+    }
+  } else {
+    for (size_t i = num_seeds; !match && i-- > min_idx;) {
+      match = Compatible1(addr, rdata, err, seeds_[i]);
+      age = num_seeds - 1 - i;
+    }
+  }
+
+  if (!match) {
+    msg << "Fetch at 0x" << std::setw(8) << addr << " returned 0x"
+        << std::setw(8) << rdata << (err ? " (err)" : "")
+        << (err_plus2 ? " (err_plus2)" : "")
+        << ", not compatible with any memory contents. Expected";
+    for (size_t i = min_idx; i < num_seeds; ++i) {
+      uint32_t addr_lo = addr & ~3u;
+      uint32_t exp = (mem_.Read(seeds_[i], addr_lo) >> (8 * (addr & 3))) |
+                     (misaligned ? mem_.Read(seeds_[i], addr_lo + 4) << 16 : 0);
+      msg << " 0x" << std::setw(8) << exp;
+    }
+    if (mem_.Err(addr & ~3u)) {
+      msg << " (lower word err)";
+    }
+    if (misaligned && mem_.Err((addr & ~3u) + 4)) {
+      msg << " (upper word err)";
+    }
+    error_ = msg.str();
+    return false;
+  }
+
+  if (num_seeds > min_idx + 1) {
+    possible_old_++;
+    if (age > 0) {
+      actual_old_++;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,118 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef ICACHE_REF_MODEL_H_
+#define ICACHE_REF_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "icache_mem_model.h"
+
+/**
+ * Functional reference model of the ICache, used as scoreboard
+ *
+ * The cache is a performance optimization only: every instruction it passes to
+ * the core must match what a fetch from memory would have returned. The model
+ * follows the rules of the UVM scoreboard (see
+ * dv/uvm/icache/dv/env/ibex_icache_scoreboard.sv):
+ *
+ * - After a branch, fetches must come from consecutive addresses starting at
+ *   the branch target, advancing by 2 or 4 bytes depending on whether the
+ *   instruction is compressed.
+ * - Only the lower 16 bits of compressed instructions are checked.
+ * - A fetch whose (lower) word has an error must be flagged with err_o. An
+ *   uncompressed, misaligned instruction whose upper word has an error must be
+ *   flagged with err_o and err_plus2_o.
+ * - The memory contents (the seed of the IcacheMemModel) may change. The cache
+ *   may return data of any seed which was current since the last invalidation
+ *   followed by a branch. If the cache has been disabled since before the last
+ *   branch, it must return data at least as new as that branch.
+ */
+class IcacheRefModel {
+ public:
+  IcacheRefModel(const IcacheMemModel &mem);
+
+  /**
+   * Forget all state and start with memory contents |seed|
+   */
+  void Reset(uint32_t seed);
+
+  /**
+   * The memory contents changed to |seed|
+   */
+  void NewSeed(uint32_t seed);
+
+  /**
+   * The core branched to |addr|
+   */
+  void Branch(uint32_t addr);
+
+  /**
+   * The cache was invalidated
+   */
+  void Invalidate();
+
+  /**
+   * The cache was enabled or disabled
+   */
+  void Enable(bool enable);
+
+  /**
+   * Check an instruction passed to the core
+   *
+   * @return false on a mismatch, see Error()
+   */
+  bool Fetch(uint32_t addr, uint32_t rdata, bool err, bool err_plus2);
+
+  /**
+   * Description of the last mismatch
+   */
+  const std::string &Error() const { return error_; }
+
+  /**
+   * Number of fetches which could have returned data of an old seed, and the
+   * number of those which did
+   */
+  uint64_t PossibleOldFetches() const { return possible_old_; }
+  uint64_t OldFetches() const { return actual_old_; }
+
+ private:
+  const IcacheMemModel &mem_;
+  std::string error_;
+
+  // Memory seeds the cache may return data for, oldest first
+  std::vector<uint32_t> seeds_;
+  // Seeds before this index are dropped on the next branch
+  bool inval_pending_;
+  size_t inval_seed_;
+  // Seed current at the last branch
+  size_t branch_seed_;
+
+  bool enabled_;
+  bool no_cache_;
+
+  bool addr_valid_;
+  uint32_t next_addr_;
+
+  uint64_t possible_old_;
+  uint64_t actual_old_;
+
+  /**
+   * Is a fetch from the word containing |addr| compatible with |seed|?
+   */
+  bool Compatible1(uint32_t addr, uint32_t rdata, bool err,
+                   uint32_t seed) const;
+
+  /**
+   * Is a misaligned, uncompressed fetch at |addr| compatible with the lower
+   * word having |seed_lo| and the upper word |seed_hi|?
+   */
+  bool Compatible2(uint32_t addr, uint32_t rdata, bool err_hi,
+                   uint32_t seed_lo, uint32_t seed_hi) const;
+};
+
+#endif  // ICACHE_REF_MODEL_H_
@@ -0,0 +1,14 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_tb_driver.h"
+#include "icache_bench.h"
+#include "verilated_toplevel.h"
+
+int main(int argc, char **argv) {
+  tb_icache top;
+  IcacheBench bench;
+  return RunTestbench(&top, &top.clk_i, &top.rst_ni, bench, "ICache",
+                      "tb_icache_stats.csv", argc, argv);
+}
@@ -0,0 +1,192 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * ICache testbench
+ *
+ * Instantiates ibex_icache and drives both of its interfaces from the C++
+ * driver and memory agent in ../cpp/icache_bench.cc, which also checks every
+ * fetched instruction against a reference model. The C++ side is called once
+ * per clock edge with the sampled DUT outputs, and returns the DUT inputs for
+ * the next cycle.
+ */
+module tb_icache #(
+  parameter int unsigned CacheSizeBytes = 4*1024,
+  parameter bit          ICacheECC      = 1'b0,
+  parameter int unsigned LineSize       = 64,
+  parameter int unsigned NumWays        = 2,
+  parameter bit          SpecRequest    = 1'b0,
+  parameter bit          BranchCache    = 1'b0
+) (
+  input logic clk_i,
+  input logic rst_ni
+);
+
+  import "DPI-C" function void icache_tb_init(input int CacheSizeBytes,
+                                              input int LineSize,
+                                              input int NumWays,
+                                              input bit ICacheECC,
+                                              input bit SpecRequest,
+                                              input bit BranchCache);
+
+  import "DPI-C" pure function bit icache_tb_pmp_err(input bit [31:0] addr);
+
+  import "DPI-C" function void icache_tb_tick(
+    // DUT outputs, sampled at the clock edge
+    input  bit        valid,
+    input  bit [31:0] rdata,
+    input  bit [31:0] addr,
+    input  bit        err,
+    input  bit        err_plus2,
+    input  bit        instr_req,
+    input  bit [31:0] instr_addr,
+    input  bit        instr_pmp_err,
+    input  bit        busy,
+    // DUT inputs for the next cycle
+    output bit        req,
+    output bit        branch,
+    output bit        branch_spec,
+    output bit [31:0] branch_addr,
+    output bit        ready,
+    output bit        instr_gnt,
+    output bit        instr_rvalid,
+    output bit [31:0] instr_rdata,
+    output bit        instr_err,
+    output bit        enable,
+    output bit        inval,
+    output bit        stop);
+
+  import "DPI-C" function void icache_tb_counter(input int index, input longint value);
+
+  // Core interface
+  logic        req;
+  logic        branch;
+  logic        branch_spec;
+  logic [31:0] branch_addr;
+  logic        ready;
+  logic        valid;
+  logic [31:0] rdata;
+  logic [31:0] addr;
+  logic        err;
+  logic        err_plus2;
+
+  // Memory interface
+  logic        instr_req;
+  logic        instr_gnt;
+  logic [31:0] instr_addr;
+  logic [31:0] instr_rdata;
+  logic        instr_err;
+  logic        instr_pmp_err;
+  logic        instr_rvalid;
+
+  logic        enable;
+  logic        inval;
+  logic        busy;
+
+  ibex_icache #(
+    .BusWidth       (32),
+    .CacheSizeBytes (CacheSizeBytes),
+    .ICacheECC      (ICacheECC),
+    .LineSize       (LineSize),
+    .NumWays        (NumWays),
+    .SpecRequest    (SpecRequest),
+    .BranchCache    (BranchCache)
+  ) u_icache (
+    .clk_i           (clk_i),
+    .rst_ni          (rst_ni),
+
+    .req_i           (req),
+
+    .branch_i        (branch),
+    .branch_spec_i   (branch_spec),
+    .addr_i          (branch_addr),
+
+    .ready_i         (ready),
+    .valid_o         (valid),
+    .rdata_o         (rdata),
+    .addr_o          (addr),
+    .err_o           (err),
+    .err_plus2_o     (err_plus2),
+
+    .instr_req_o     (instr_req),
+    .instr_gnt_i     (instr_gnt),
+    .instr_addr_o    (instr_addr),
+    .instr_rdata_i   (instr_rdata),
+    .instr_err_i     (instr_err),
+    .instr_pmp_err_i (instr_pmp_err),
+    .instr_rvalid_i  (instr_rvalid),
+
+    .icache_enable_i (enable),
+    .icache_inval_i  (inval),
+    .busy_o          (busy)
+  );
+
+  // PMP errors are signalled in the same cycle as the request, like the PMP in ibex_core does
+  assign instr_pmp_err = instr_req & icache_tb_pmp_err(instr_addr);
+
+  initial begin
+    icache_tb_init(CacheSizeBytes, LineSize, NumWays, ICacheECC, SpecRequest, BranchCache);
+  end
+
+  // Outputs of icache_tb_tick(), applied to the DUT after the clock edge
+  bit        req_d;
+  bit        branch_d;
+  bit        branch_spec_d;
+  bit [31:0] branch_addr_d;
+  bit        ready_d;
+  bit        instr_gnt_d;
+  bit        instr_rvalid_d;
+  bit [31:0] instr_rdata_d;
+  bit        instr_err_d;
+  bit        enable_d;
+  bit        inval_d;
+  bit        stop;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      req          <= 1'b0;
+      branch       <= 1'b0;
+      branch_spec  <= 1'b0;
+      branch_addr  <= '0;
+      ready        <= 1'b0;
+      instr_gnt    <= 1'b0;
+      instr_rvalid <= 1'b0;
+      instr_rdata  <= '0;
+      instr_err    <= 1'b0;
+      enable       <= 1'b0;
+      inval        <= 1'b0;
+    end else begin
+      icache_tb_tick(valid, rdata, addr, err, err_plus2,
+                     instr_req, instr_addr, instr_pmp_err, busy,
+                     req_d, branch_d, branch_spec_d, branch_addr_d, ready_d,
+                     instr_gnt_d, instr_rvalid_d, instr_rdata_d, instr_err_d,
+                     enable_d, inval_d, stop);
+      req          <= req_d;
+      branch       <= branch_d;
+      branch_spec  <= branch_spec_d;
+      branch_addr  <= branch_addr_d;
+      ready        <= ready_d;
+      instr_gnt    <= instr_gnt_d;
+      instr_rvalid <= instr_rvalid_d;
+      instr_rdata  <= instr_rdata_d;
+      instr_err    <= instr_err_d;
+      enable       <= enable_d;
+      inval        <= inval_d;
+      if (stop) begin
+        $finish();
+      end
+    end
+  end
+
+  // Pass the simulation-only event counters of the cache (see "Performance probes" in
+  // ibex_icache.sv) to the C++ side for the report.
+  localparam int NrICacheCounters = 7;
+
+  final begin
+    for (int i = 0; i < NrICacheCounters; i++) begin
+      icache_tb_counter(i, u_icache.perf_cnt_q[i]);
+    end
+  end
+
+endmodule
@@ -0,0 +1,471 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "multdiv_bench.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// Probability of choosing an operand from kCornerOperands
+static const double kCornerProb = 1.0 / 4;
+// Probability of choosing an operand below 2^16
+static const double kSmallProb = 1.0 / 4;
+// Probability of negating a small operand
+static const double kSmallNegProb = 1.0 / 2;
+// Longest latency in the histograms, longer latencies go into the last bin
+static const size_t kMaxLatency = 63;
+
+static const uint32_t kCornerOperands[] = {
+    0x00000000, 0x00000001, 0x00000002, 0x0000ffff, 0x00010000,
+    0x7fffffff, 0x80000000, 0x80000001, 0xfffffffe, 0xffffffff};
+static const int kNumCornerOperands =
+    sizeof(kCornerOperands) / sizeof(*kCornerOperands);
+
+static const char *const kRv32mNames[] = {"RV32MNone", "RV32MSlow",
+                                          "RV32MFast", "RV32MSingleCycle"};
+
+// The instance accessed by the DPI functions below
+static MultdivBench *multdiv_bench_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void multdiv_tb_init(int rv32m) {
+  assert(multdiv_bench_instance);
+  multdiv_bench_instance->Init(rv32m);
+}
+
+svBit multdiv_tb_data_ind_timing() {
+  assert(multdiv_bench_instance);
+  return multdiv_bench_instance->DataIndTiming();
+}
+
+void multdiv_tb_tick(svBit valid, const svBitVecVal *result, svBit *mult_en,
+                     svBit *div_en, svBit *mult_sel, svBit *div_sel,
+                     svBitVecVal *md_operator, svBitVecVal *signed_mode,
+                     svBitVecVal *op_a, svBitVecVal *op_b, svBit *ready_id,
+                     svBit *stop) {
+  assert(multdiv_bench_instance);
+
+  MultdivBenchOutputs out;
+  out.valid = valid;
+  out.result = result[0];
+
+  MultdivBenchInputs in;
+  *stop = multdiv_bench_instance->Tick(out, in);
+
+  *mult_en = in.mult_en;
+  *div_en = in.div_en;
+  *mult_sel = in.mult_sel;
+  *div_sel = in.div_sel;
+  md_operator[0] = in.md_operator;
+  signed_mode[0] = in.signed_mode;
+  op_a[0] = in.op_a;
+  op_b[0] = in.op_b;
+  *ready_id = in.ready_id;
+}
+}
+
+MultdivBench::MultdivBench()
+    : max_instrs_(1000000),
+      seed_(1),
+      wb_stall_prob_(0.0),
+      idle_prob_(0.0),
+      data_ind_timing_(false),
+      latency_(kNumMultdivOps * kNumMultdivOperandClasses,
+               std::vector<uint64_t>(kMaxLatency + 1)) {
+  assert(!multdiv_bench_instance &&
+         "Only one MultdivBench instance is supported.");
+  multdiv_bench_instance = this;
+
+  for (int op = 0; op < kNumMultdivOps; ++op) {
+    ops_.push_back(static_cast<MultdivOp>(op));
+  }
+}
+
+MultdivBench::~MultdivBench() { multdiv_bench_instance = nullptr; }
+
+// Parse a probability given in percent
+static bool ParsePercent(const char *arg, double &prob) {
+  char *end;
+  double percent = strtod(arg, &end);
+  if (*end != '\0' || percent < 0.0 || percent > 100.0) {
+    std::cerr << "ERROR: Invalid percentage: " << arg << std::endl;
+    return false;
+  }
+  prob = percent / 100.0;
+  return true;
+}
+
+// Parse a comma separated list of instruction names
+static bool ParseOps(const char *arg, std::vector<MultdivOp> &ops) {
+  ops.clear();
+  std::istringstream list(arg);
+  std::string name;
+  while (std::getline(list, name, ',')) {
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    int op = 0;
+    while (op < kNumMultdivOps &&
+           name != MultdivOpName(static_cast<MultdivOp>(op))) {
+      ++op;
+    }
+    if (op == kNumMultdivOps) {
+      std::cerr << "ERROR: Unknown instruction: " << name << std::endl;
+      return false;
+    }
+    ops.push_back(static_cast<MultdivOp>(op));
+  }
+  if (ops.empty()) {
+    std::cerr << "ERROR: No instructions given." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool MultdivBench::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"instrs", required_argument, nullptr, 'n'},
+      {"seed", required_argument, nullptr, 'S'},
+      {"ops", required_argument, nullptr, 'O'},
+      {"wb-stall", required_argument, nullptr, 'W'},
+      {"idle", required_argument, nullptr, 'I'},
+      {"data-ind-timing", no_argument, nullptr, 'D'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'n':
+        max_instrs_ = strtoull(optarg, nullptr, 0);
+        break;
+      case 'S':
+        seed_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'O':
+        if (!ParseOps(optarg, ops_)) {
+          return false;
+        }
+        break;
+      case 'W':
+        if (!ParsePercent(optarg, wb_stall_prob_) || wb_stall_prob_ == 1.0) {
+          std::cerr << "ERROR: Writeback must not stall forever." << std::endl;
+          return false;
+        }
+        break;
+      case 'I':
+        if (!ParsePercent(optarg, idle_prob_) || idle_prob_ == 1.0) {
+          std::cerr << "ERROR: The bench must issue instructions."
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'D':
+        data_ind_timing_ = true;
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void MultdivBench::PrintHelp() const {
+  std::cout << "Multiplier/divider testbench:\n\n"
+               "--instrs=N\n"
+               "  Stop after N instructions (default: "
+            << max_instrs_
+            << ", 0: run until the cycle limit)\n\n"
+               "--seed=N\n"
+               "  Seed of the random stimulus (default: "
+            << seed_
+            << ")\n\n"
+               "--ops=OP[,OP...]\n"
+               "  Only issue these instructions, e.g. div,divu (default: "
+               "all RV32M\n"
+               "  instructions)\n\n"
+               "--wb-stall=PERCENT\n"
+               "  Probability of the writeback stage not accepting a result "
+               "in a cycle\n"
+               "  (default: "
+            << wb_stall_prob_ * 100
+            << ")\n\n"
+               "--idle=PERCENT\n"
+               "  Probability of a cycle without an instruction between two\n"
+               "  instructions (default: "
+            << idle_prob_ * 100
+            << ")\n\n"
+               "--data-ind-timing\n"
+               "  Enable data independent timing (cpuctrl.data_ind_timing)\n\n";
+}
+
+void MultdivBench::PreExec() {
+  rng_.seed(seed_);
+
+  cycle_ = 0;
+  memset(&in_, 0, sizeof(in_));
+  busy_ = false;
+
+  errors_ = 0;
+  instrs_ = 0;
+  wb_stalls_ = 0;
+  for (auto &hist : latency_) {
+    std::fill(hist.begin(), hist.end(), 0);
+  }
+  time_begin_ = std::chrono::steady_clock::now();
+}
+
+void MultdivBench::PostExec() { time_end_ = std::chrono::steady_clock::now(); }
+
+void MultdivBench::Init(unsigned int rv32m) {
+  std::cout << "Multiplier/divider: "
+            << (rv32m < sizeof(kRv32mNames) / sizeof(*kRv32mNames)
+                    ? kRv32mNames[rv32m]
+                    : "unknown")
+            << (data_ind_timing_ ? ", data independent timing" : "")
+            << std::endl
+            << "Stimulus seed " << seed_ << std::endl;
+}
+
+uint32_t MultdivBench::Operand() {
+  if (Chance(kCornerProb)) {
+    return kCornerOperands[rng_() % kNumCornerOperands];
+  }
+  if (Chance(kSmallProb)) {
+    uint32_t small = rng_() & 0xffff;
+    return Chance(kSmallNegProb) ? -small : small;
+  }
+  return rng_();
+}
+
+void MultdivBench::Issue(MultdivBenchInputs &next) {
+  op_ = ops_[rng_() % ops_.size()];
+  bool div = op_ >= kDiv;
+  next.mult_en = !div;
+  next.div_en = div;
+  next.mult_sel = !div;
+  next.div_sel = div;
+  next.md_operator = MultdivOperator(op_);
+  next.signed_mode = MultdivSignedMode(op_);
+  next.op_a = Operand();
+  next.op_b = Operand();
+
+  busy_ = true;
+  issue_cycle_ = cycle_ + 1;
+  result_valid_ = false;
+}
+
+void MultdivBench::Error(const std::string &msg) {
+  std::cerr << "ERROR: Cycle " << cycle_ << ": " << msg << std::endl;
+  errors_++;
+}
+
+bool MultdivBench::Tick(const MultdivBenchOutputs &out,
+                        MultdivBenchInputs &in) {
+  // |in_| holds the inputs of the cycle ending at this clock edge
+  cycle_++;
+
+  if (busy_) {
+    if (out.valid) {
+      if (!result_valid_) {
+        MultdivOperandClass cls = MultdivClassify(op_, in_.op_a, in_.op_b);
+        Histogram(op_, cls)[std::min<uint64_t>(cycle_ - issue_cycle_ + 1,
+                                               kMaxLatency)]++;
+        result_valid_ = true;
+      }
+      if (in_.ready_id) {
+        uint32_t expected = MultdivResult(op_, in_.op_a, in_.op_b);
+        if (out.result != expected) {
+          std::ostringstream msg;
+          msg << std::hex << std::setfill('0') << MultdivOpName(op_)
+              << " 0x" << std::setw(8) << in_.op_a << ", 0x" << std::setw(8)
+              << in_.op_b << ": result 0x" << std::setw(8) << out.result
+              << ", expected 0x" << std::setw(8) << expected;
+          Error(msg.str());
+        }
+        instrs_++;
+        busy_ = false;
+      } else {
+        wb_stalls_++;
+      }
+    } else if (result_valid_) {
+      std::ostringstream msg;
+      msg << MultdivOpName(op_)
+          << ": result no longer valid while waiting for writeback";
+      Error(msg.str());
+    }
+  }
+
+  // Inputs for the next cycle
+  MultdivBenchInputs next = in_;
+  if (!busy_) {
+    if (Chance(idle_prob_)) {
+      next.mult_en = false;
+      next.div_en = false;
+      next.mult_sel = false;
+      next.div_sel = false;
+    } else {
+      Issue(next);
+    }
+  }
+  next.ready_id = !Chance(wb_stall_prob_);
+
+  in_ = next;
+  in = next;
+  return errors_ || (max_instrs_ && instrs_ >= max_instrs_);
+}
+
+// Count, minimum, maximum and average of a latency histogram
+struct LatencyStats {
+  uint64_t count;
+  size_t min;
+  size_t max;
+  double avg;
+};
+
+static LatencyStats HistStats(const std::vector<uint64_t> &hist) {
+  LatencyStats stats = {0, 0, 0, 0.0};
+  uint64_t sum = 0;
+  for (size_t i = 0; i < hist.size(); ++i) {
+    if (!hist[i]) {
+      continue;
+    }
+    if (!stats.count) {
+      stats.min = i;
+    }
+    stats.max = i;
+    stats.count += hist[i];
+    sum += i * hist[i];
+  }
+  stats.avg = stats.count ? static_cast<double>(sum) / stats.count : 0.0;
+  return stats;
+}
+
+std::string MultdivBench::ReportString(bool csv) const {
+  char separator = csv ? ',' : ':';
+  StatValues values;
+
+  double seconds =
+      std::chrono::duration<double>(time_end_ - time_begin_).count();
+
+  AddStat(values, "Cycles", cycle_);
+  AddStat(values, "Instructions", instrs_);
+  AddStat(values, "Mismatches", errors_);
+  AddStat(values, "Writeback Stall Cycles", wb_stalls_);
+  AddStatRatio(values, "Instructions/Cycle",
+               cycle_ ? static_cast<double>(instrs_) / cycle_ : 0.0);
+  AddStat(values, "Instructions/s", seconds > 0.0 ? instrs_ / seconds : 0);
+
+  // Average latency per instruction over all operand classes
+  for (int op = 0; op < kNumMultdivOps; ++op) {
+    std::vector<uint64_t> op_hist(kMaxLatency + 1);
+    for (int cls = 0; cls < kNumMultdivOperandClasses; ++cls) {
+      const std::vector<uint64_t> &hist =
+          latency_[op * kNumMultdivOperandClasses + cls];
+      for (size_t i = 0; i <= kMaxLatency; ++i) {
+        op_hist[i] += hist[i];
+      }
+    }
+    LatencyStats stats = HistStats(op_hist);
+    if (stats.count) {
+      AddStatRatio(
+          values,
+          std::string(MultdivOpName(static_cast<MultdivOp>(op))) + " Latency",
+          stats.avg);
+    }
+  }
+
+  std::stringstream report_ss;
+  report_ss << FormatStats(values, csv);
+
+  // Latency statistics and histogram per instruction and operand class, one
+  // line each
+  if (!csv) {
+    report_ss << std::endl
+              << std::left << std::setw(8) << "Op" << std::setw(10) << "Class"
+              << std::right << std::setw(12) << "Count" << std::setw(6)
+              << "Min" << std::setw(8) << "Avg" << std::setw(6) << "Max"
+              << "  Histogram (latency:count)" << std::endl;
+  }
+  for (int op = 0; op < kNumMultdivOps; ++op) {
+    for (int cls = 0; cls < kNumMultdivOperandClasses; ++cls) {
+      const std::vector<uint64_t> &hist =
+          latency_[op * kNumMultdivOperandClasses + cls];
+      LatencyStats stats = HistStats(hist);
+      if (!stats.count) {
+        continue;
+      }
+      std::string name =
+          std::string(MultdivOpName(static_cast<MultdivOp>(op))) + " " +
+          MultdivOperandClassName(static_cast<MultdivOperandClass>(cls));
+      if (csv) {
+        report_ss << name << " Count" << separator << stats.count << std::endl
+                  << name << " Latency Min" << separator << stats.min
+                  << std::endl
+                  << name << " Latency Avg" << separator << std::fixed
+                  << std::setprecision(3) << stats.avg << std::endl
+                  << name << " Latency Max" << separator << stats.max
+                  << std::endl;
+        for (size_t i = 0; i <= kMaxLatency; ++i) {
+          if (hist[i]) {
+            report_ss << name << " Latency " << i << separator << hist[i]
+                      << std::endl;
+          }
+        }
+      } else {
+        report_ss << std::left << std::setw(8)
+                  << MultdivOpName(static_cast<MultdivOp>(op)) << std::setw(10)
+                  << MultdivOperandClassName(
+                         static_cast<MultdivOperandClass>(cls))
+                  << std::right << std::setw(12) << stats.count << std::setw(6)
+                  << stats.min << std::setw(8) << std::fixed
+                  << std::setprecision(2) << stats.avg << std::setw(6)
+                  << stats.max << " ";
+        for (size_t i = 0; i <= kMaxLatency; ++i) {
+          if (hist[i]) {
+            report_ss << " " << i << (i == kMaxLatency ? "+" : "") << ":"
+                      << hist[i];
+          }
+        }
+        report_ss << std::endl;
+      }
+    }
+  }
+
+  return report_ss.str();
+}
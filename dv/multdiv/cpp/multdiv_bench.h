@@ -0,0 +1,164 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MULTDIV_BENCH_H_
+#define MULTDIV_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ibex_tb_driver.h"
+#include "multdiv_ref_model.h"
+
+// Inputs of the multiplier/divider driven by the testbench in one cycle
+struct MultdivBenchInputs {
+  bool mult_en;
+  bool div_en;
+  bool mult_sel;
+  bool div_sel;
+  unsigned int md_operator;
+  unsigned int signed_mode;
+  uint32_t op_a;
+  uint32_t op_b;
+  bool ready_id;
+};
+
+// Outputs of the multiplier/divider sampled by the testbench at a clock edge
+struct MultdivBenchOutputs {
+  bool valid;
+  uint32_t result;
+};
+
+/**
+ * Driver, scoreboard and latency measurement of the multiplier/divider
+ * testbench
+ *
+ * Called through DPI from tb/tb_multdiv.sv in every cycle. Issues RV32M
+ * instructions back to back the way the ID stage does: the select signals
+ * and operands are held while an instruction executes, and the next one
+ * starts in the cycle after the result was accepted. Operands are random,
+ * with a bias towards small numbers and corner cases (zero, -1, the most
+ * negative number, ...). Every result is compared with MultdivResult().
+ *
+ * The latency of every instruction, from its first cycle in EX to the cycle
+ * the result is valid, is recorded in a histogram per instruction and operand
+ * class (see MultdivClassify()).
+ *
+ * The bench is configured on the command line, see PrintHelp().
+ */
+class MultdivBench : public IbexTestbench {
+ public:
+  MultdivBench();
+  ~MultdivBench();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Seed the stimulus and reset the statistics
+   */
+  virtual void PreExec();
+
+  /**
+   * Stop the wall clock time measurement
+   */
+  virtual void PostExec();
+
+  /**
+   * Set the RV32M implementation (the parameter of the DUT)
+   */
+  void Init(unsigned int rv32m);
+
+  /**
+   * Value of the data independent timing input of the DUT
+   */
+  bool DataIndTiming() const { return data_ind_timing_; }
+
+  /**
+   * Check and record the DUT outputs at a clock edge, and choose the inputs
+   * for the next cycle
+   *
+   * @return true if the simulation should stop
+   */
+  bool Tick(const MultdivBenchOutputs &out, MultdivBenchInputs &in);
+
+  /**
+   * Did all checks pass?
+   */
+  virtual bool Passed() const { return errors_ == 0; }
+
+  /**
+   * Returns a formatted string of the bench statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  virtual std::string ReportString(bool csv) const;
+
+ private:
+  // Configuration
+  uint64_t max_instrs_;
+  unsigned int seed_;
+  std::vector<MultdivOp> ops_;
+  double wb_stall_prob_;
+  double idle_prob_;
+  bool data_ind_timing_;
+
+  std::mt19937 rng_;
+
+  // State of the driver
+  uint64_t cycle_;
+  MultdivBenchInputs in_;
+  bool busy_;
+  MultdivOp op_;
+  uint64_t issue_cycle_;
+  bool result_valid_;
+
+  // Statistics
+  uint64_t errors_;
+  uint64_t instrs_;
+  uint64_t wb_stalls_;
+  // Latency histogram per instruction and operand class
+  std::vector<std::vector<uint64_t>> latency_;
+  std::chrono::steady_clock::time_point time_begin_;
+  std::chrono::steady_clock::time_point time_end_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  bool Chance(double prob) {
+    return std::generate_canonical<double, 32>(rng_) < prob;
+  }
+
+  /**
+   * Choose a random operand
+   */
+  uint32_t Operand();
+
+  /**
+   * Start a random instruction in the next cycle
+   */
+  void Issue(MultdivBenchInputs &next);
+
+  std::vector<uint64_t> &Histogram(MultdivOp op, MultdivOperandClass cls) {
+    return latency_[op * kNumMultdivOperandClasses + cls];
+  }
+
+  void Error(const std::string &msg);
+};
+
+#endif  // MULTDIV_BENCH_H_
@@ -0,0 +1,124 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "multdiv_ref_model.h"
+
+#include <cassert>
+
+// ibex_pkg::md_op_e
+enum {
+  kMdOpMull = 0,
+  kMdOpMulh = 1,
+  kMdOpDiv = 2,
+  kMdOpRem = 3,
+};
+
+static const char *const kOpNames[kNumMultdivOps] = {
+    "MUL", "MULH", "MULHSU", "MULHU", "DIV", "DIVU", "REM", "REMU"};
+
+static const char *const kClassNames[kNumMultdivOperandClasses] = {
+    "zero", "overflow", "negative", "small", "large"};
+
+const char *MultdivOpName(MultdivOp op) {
+  assert(op < kNumMultdivOps);
+  return kOpNames[op];
+}
+
+const char *MultdivOperandClassName(MultdivOperandClass cls) {
+  assert(cls < kNumMultdivOperandClasses);
+  return kClassNames[cls];
+}
+
+unsigned int MultdivOperator(MultdivOp op) {
+  switch (op) {
+    case kMul:
+      return kMdOpMull;
+    case kMulh:
+    case kMulhsu:
+    case kMulhu:
+      return kMdOpMulh;
+    case kDiv:
+    case kDivu:
+      return kMdOpDiv;
+    default:
+      return kMdOpRem;
+  }
+}
+
+// See ibex_decoder.sv: bit 0 marks operand a as signed, bit 1 operand b
+unsigned int MultdivSignedMode(MultdivOp op) {
+  switch (op) {
+    case kMulh:
+    case kDiv:
+    case kRem:
+      return 3;
+    case kMulhsu:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static bool IsDivision(MultdivOp op) { return op >= kDiv; }
+
+uint32_t MultdivResult(MultdivOp op, uint32_t a, uint32_t b) {
+  int32_t sa = static_cast<int32_t>(a);
+  int32_t sb = static_cast<int32_t>(b);
+  bool overflow = a == 0x80000000u && b == 0xffffffffu;
+
+  switch (op) {
+    case kMul:
+      return a * b;
+    case kMulh:
+      return static_cast<uint64_t>(static_cast<int64_t>(sa) * sb) >> 32;
+    case kMulhsu:
+      return static_cast<uint64_t>(static_cast<int64_t>(sa) *
+                                   static_cast<int64_t>(b)) >>
+             32;
+    case kMulhu:
+      return (static_cast<uint64_t>(a) * b) >> 32;
+    case kDiv:
+      if (b == 0) {
+        return 0xffffffffu;
+      }
+      return overflow ? a : static_cast<uint32_t>(sa / sb);
+    case kDivu:
+      return b ? a / b : 0xffffffffu;
+    case kRem:
+      if (b == 0) {
+        return a;
+      }
+      return overflow ? 0 : static_cast<uint32_t>(sa % sb);
+    case kRemu:
+      return b ? a % b : a;
+    default:
+      assert(0);
+      return 0;
+  }
+}
+
+MultdivOperandClass MultdivClassify(MultdivOp op, uint32_t a, uint32_t b) {
+  unsigned int signed_mode = MultdivSignedMode(op);
+  bool a_neg = (signed_mode & 1) && (a >> 31);
+  bool b_neg = (signed_mode & 2) && (b >> 31);
+
+  if (IsDivision(op)) {
+    if (b == 0) {
+      return kClassZero;
+    }
+    if (signed_mode && a == 0x80000000u && b == 0xffffffffu) {
+      return kClassOverflow;
+    }
+  } else if (a == 0 || b == 0) {
+    return kClassZero;
+  }
+
+  if (a_neg || b_neg) {
+    return kClassNegative;
+  }
+  if (a < 0x10000 && b < 0x10000) {
+    return kClassSmall;
+  }
+  return kClassLarge;
+}
@@ -0,0 +1,61 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MULTDIV_REF_MODEL_H_
+#define MULTDIV_REF_MODEL_H_
+
+#include <cstdint>
+
+// The RV32M instructions, in the order of the funct3 field of their encoding
+enum MultdivOp {
+  kMul,
+  kMulh,
+  kMulhsu,
+  kMulhu,
+  kDiv,
+  kDivu,
+  kRem,
+  kRemu,
+  kNumMultdivOps
+};
+
+// Operand classes, which determine the latency of some implementations
+enum MultdivOperandClass {
+  kClassZero,      // Multiplication with a zero operand, division by zero
+  kClassOverflow,  // Signed division of the most negative number by -1
+  kClassNegative,  // A negative operand of a signed operation
+  kClassSmall,     // Both operands below 2^16
+  kClassLarge,     // Everything else
+  kNumMultdivOperandClasses
+};
+
+/**
+ * Name of the instruction, e.g. "MULHSU"
+ */
+const char *MultdivOpName(MultdivOp op);
+
+/**
+ * Name of the operand class, e.g. "negative"
+ */
+const char *MultdivOperandClassName(MultdivOperandClass cls);
+
+/**
+ * Operator (ibex_pkg::md_op_e) and signed mode of the instruction, as the
+ * decoder sets them for the multiplier/divider
+ */
+unsigned int MultdivOperator(MultdivOp op);
+unsigned int MultdivSignedMode(MultdivOp op);
+
+/**
+ * Result of the instruction as specified by the RISC-V ISA, including
+ * division by zero and signed overflow
+ */
+uint32_t MultdivResult(MultdivOp op, uint32_t a, uint32_t b);
+
+/**
+ * Class of the operands of the instruction
+ */
+MultdivOperandClass MultdivClassify(MultdivOp op, uint32_t a, uint32_t b);
+
+#endif  // MULTDIV_REF_MODEL_H_
@@ -0,0 +1,170 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Select the multiplier/divider with the RV32M define, e.g. with
+// --RV32M=ibex_pkg::RV32MSlow in fusesoc
+`ifndef RV32M
+  `define RV32M ibex_pkg::RV32MFast
+`endif
+
+/**
+ * Multiplier/divider testbench
+ *
+ * Instantiates ibex_ex_block, which connects the multiplier/divider to the
+ * ALU adder it shares, together with the intermediate value register of the
+ * ID stage. The C++ driver in ../cpp/multdiv_bench.cc issues instructions,
+ * checks the results and measures their latency. It is called once per clock
+ * edge with the sampled DUT outputs, and returns the DUT inputs for the next
+ * cycle.
+ */
+module tb_multdiv #(
+  parameter ibex_pkg::rv32m_e RV32M = `RV32M
+) (
+  input logic clk_i,
+  input logic rst_ni
+);
+
+  import ibex_pkg::*;
+
+  import "DPI-C" function void multdiv_tb_init(input int rv32m);
+
+  import "DPI-C" function bit multdiv_tb_data_ind_timing();
+
+  import "DPI-C" function void multdiv_tb_tick(
+    // DUT outputs, sampled at the clock edge
+    input  bit        valid,
+    input  bit [31:0] result,
+    // DUT inputs for the next cycle
+    output bit        mult_en,
+    output bit        div_en,
+    output bit        mult_sel,
+    output bit        div_sel,
+    output bit [1:0]  md_operator,
+    output bit [1:0]  signed_mode,
+    output bit [31:0] op_a,
+    output bit [31:0] op_b,
+    output bit        ready_id,
+    output bit        stop);
+
+  logic        mult_en;
+  logic        div_en;
+  logic        mult_sel;
+  logic        div_sel;
+  md_op_e      md_operator;
+  logic [1:0]  signed_mode;
+  logic [31:0] op_a;
+  logic [31:0] op_b;
+  logic        ready_id;
+  logic        data_ind_timing;
+
+  logic        valid;
+  logic [31:0] result;
+
+  // Intermediate value register, as in ibex_id_stage
+  logic [1:0]  imd_val_we;
+  logic [33:0] imd_val_d[2];
+  logic [33:0] imd_val_q[2];
+
+  for (genvar i = 0; i < 2; i++) begin : gen_imd_val
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        imd_val_q[i] <= '0;
+      end else if (imd_val_we[i]) begin
+        imd_val_q[i] <= imd_val_d[i];
+      end
+    end
+  end
+
+  logic [31:0] unused_alu_adder_result;
+  logic [31:0] unused_branch_target;
+  logic        unused_branch_decision;
+
+  // The ALU operands are the register operands, as set up by the ID stage for RV32M instructions
+  ibex_ex_block #(
+    .RV32M           (RV32M),
+    .RV32B           (RV32BNone),
+    .BranchTargetALU (1'b0)
+  ) u_ex_block (
+    .clk_i                   (clk_i),
+    .rst_ni                  (rst_ni),
+
+    .alu_operator_i          (ALU_SLTU),
+    .alu_operand_a_i         (op_a),
+    .alu_operand_b_i         (op_b),
+    .alu_instr_first_cycle_i (1'b0),
+
+    .bt_a_operand_i          ('0),
+    .bt_b_operand_i          ('0),
+
+    .multdiv_operator_i      (md_operator),
+    .mult_en_i               (mult_en),
+    .div_en_i                (div_en),
+    .mult_sel_i              (mult_sel),
+    .div_sel_i               (div_sel),
+    .multdiv_signed_mode_i   (signed_mode),
+    .multdiv_operand_a_i     (op_a),
+    .multdiv_operand_b_i     (op_b),
+    .multdiv_ready_id_i      (ready_id),
+    .data_ind_timing_i       (data_ind_timing),
+
+    .imd_val_we_o            (imd_val_we),
+    .imd_val_d_o             (imd_val_d),
+    .imd_val_q_i             (imd_val_q),
+
+    .alu_adder_result_ex_o   (unused_alu_adder_result),
+    .result_ex_o             (result),
+    .branch_target_o         (unused_branch_target),
+    .branch_decision_o       (unused_branch_decision),
+
+    .ex_valid_o              (valid)
+  );
+
+  initial begin
+    multdiv_tb_init(RV32M);
+    data_ind_timing = multdiv_tb_data_ind_timing();
+  end
+
+  // Outputs of multdiv_tb_tick(), applied to the DUT after the clock edge
+  bit        mult_en_d;
+  bit        div_en_d;
+  bit        mult_sel_d;
+  bit        div_sel_d;
+  bit [1:0]  md_operator_d;
+  bit [1:0]  signed_mode_d;
+  bit [31:0] op_a_d;
+  bit [31:0] op_b_d;
+  bit        ready_id_d;
+  bit        stop;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      mult_en     <= 1'b0;
+      div_en      <= 1'b0;
+      mult_sel    <= 1'b0;
+      div_sel     <= 1'b0;
+      md_operator <= MD_OP_MULL;
+      signed_mode <= 2'b00;
+      op_a        <= '0;
+      op_b        <= '0;
+      ready_id    <= 1'b0;
+    end else begin
+      multdiv_tb_tick(valid, result,
+                      mult_en_d, div_en_d, mult_sel_d, div_sel_d, md_operator_d, signed_mode_d,
+                      op_a_d, op_b_d, ready_id_d, stop);
+      mult_en     <= mult_en_d;
+      div_en      <= div_en_d;
+      mult_sel    <= mult_sel_d;
+      div_sel     <= div_sel_d;
+      md_operator <= md_op_e'(md_operator_d);
+      signed_mode <= signed_mode_d;
+      op_a        <= op_a_d;
+      op_b        <= op_b_d;
+      ready_id    <= ready_id_d;
+      if (stop) begin
+        $finish();
+      end
+    end
+  end
+
+endmodule
@@ -0,0 +1,392 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pmp_bench.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// Accesses use 34 bit physical addresses
+static const uint64_t kAddrMask = (uint64_t(1) << 34) - 1;
+// Probability of a locked region
+static const double kLockProb = 1.0 / 4;
+// Probability of a TOR region below the one before it, i.e. an empty region
+static const double kTorDescendingProb = 1.0 / 8;
+// Probability of a NAPOT region covering the whole address space
+static const double kNapotAllProb = 1.0 / 64;
+// Probabilities of an access close to a region boundary, and inside the window
+// of the regions. All other accesses go anywhere.
+static const double kBoundaryProb = 1.0 / 2;
+static const double kWindowProb = 1.0 / 4;
+// Probability of an M-mode access, all others are U-mode
+static const double kMachineProb = 1.0 / 2;
+
+static const char *const kModeNames[] = {"OFF", "TOR", "NA4", "NAPOT"};
+
+// The instance accessed by the DPI functions below
+static PmpBench *pmp_bench_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void pmp_tb_init(int granularity, int num_chan, int num_regions) {
+  assert(pmp_bench_instance);
+  pmp_bench_instance->Init(granularity, num_chan, num_regions);
+}
+
+void pmp_tb_tick(const svBitVecVal *err, svBit *new_cfg, svBit *stop) {
+  assert(pmp_bench_instance);
+
+  bool new_cfg_b;
+  *stop = pmp_bench_instance->Tick(err[0], new_cfg_b);
+  *new_cfg = new_cfg_b;
+}
+
+void pmp_tb_region(int r, svBitVecVal *cfg, svBitVecVal *addr) {
+  assert(pmp_bench_instance);
+
+  uint8_t region_cfg;
+  uint64_t region_addr;
+  pmp_bench_instance->Region(r, region_cfg, region_addr);
+
+  // ibex_pkg::pmp_cfg_t has the fields of pmpcfg without the reserved bits
+  cfg[0] = (region_cfg & 0x1f) | ((region_cfg & kPmpCfgLock) ? 0x20 : 0);
+  addr[0] = region_addr;
+  addr[1] = region_addr >> 32;
+}
+
+void pmp_tb_req(int chan, svBitVecVal *addr, svBitVecVal *type,
+                svBitVecVal *priv) {
+  assert(pmp_bench_instance);
+
+  const PmpBenchRequest &req = pmp_bench_instance->Request(chan);
+  addr[0] = req.addr;
+  addr[1] = req.addr >> 32;
+  type[0] = req.type;
+  priv[0] = req.priv;
+}
+}
+
+PmpBench::PmpBench()
+    : max_configs_(1000),
+      accesses_per_config_(4096),
+      seed_(1),
+      granularity_(0),
+      num_chan_(0),
+      num_regions_(0) {
+  assert(!pmp_bench_instance && "Only one PmpBench instance is supported.");
+  pmp_bench_instance = this;
+}
+
+PmpBench::~PmpBench() { pmp_bench_instance = nullptr; }
+
+bool PmpBench::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"configs", required_argument, nullptr, 'n'},
+      {"accesses", required_argument, nullptr, 'A'},
+      {"seed", required_argument, nullptr, 'S'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'n':
+        max_configs_ = strtoull(optarg, nullptr, 0);
+        break;
+      case 'A':
+        accesses_per_config_ = strtoul(optarg, nullptr, 0);
+        if (!accesses_per_config_) {
+          std::cerr << "ERROR: Every configuration needs accesses."
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'S':
+        seed_ = strtoul(optarg, nullptr, 0);
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void PmpBench::PrintHelp() const {
+  std::cout << "PMP testbench:\n\n"
+               "--configs=N\n"
+               "  Stop after N region configurations (default: "
+            << max_configs_
+            << ", 0: run until the\n"
+               "  cycle limit)\n\n"
+               "--accesses=N\n"
+               "  Number of accesses checked per configuration (default: "
+            << accesses_per_config_
+            << ")\n\n"
+               "--seed=N\n"
+               "  Seed of the random stimulus (default: "
+            << seed_ << ")\n\n";
+}
+
+void PmpBench::PreExec() {
+  rng_.seed(seed_);
+
+  pos_ = accesses_per_config_;
+  req_addr_.resize(accesses_per_config_);
+  req_type_.resize(accesses_per_config_);
+  req_priv_.resize(accesses_per_config_);
+  expected_err_.resize(accesses_per_config_);
+  expected_region_.resize(accesses_per_config_);
+
+  cycle_ = 0;
+
+  errors_ = 0;
+  configs_ = 0;
+  checks_ = 0;
+  faults_ = 0;
+  std::fill(std::begin(mode_checks_), std::end(mode_checks_), 0);
+  default_checks_ = 0;
+  model_time_ = std::chrono::steady_clock::duration::zero();
+  time_begin_ = std::chrono::steady_clock::now();
+}
+
+void PmpBench::PostExec() { time_end_ = std::chrono::steady_clock::now(); }
+
+void PmpBench::Init(unsigned int granularity, unsigned int num_chan,
+                    unsigned int num_regions) {
+  assert(num_chan >= 1 && num_chan <= 32);
+  assert(num_regions >= 1 && num_regions <= kPmpMaxRegions);
+
+  granularity_ = granularity;
+  num_chan_ = num_chan;
+  num_regions_ = num_regions;
+  request_.assign(num_chan, PmpBenchRequest());
+  issued_.assign(num_chan, -1);
+
+  std::cout << "PMP: PMPGranularity=" << granularity
+            << ", PMPNumChan=" << num_chan
+            << ", PMPNumRegions=" << num_regions << std::endl
+            << "Stimulus seed " << seed_ << std::endl;
+}
+
+void PmpBench::NewConfig() {
+  // Place the regions in a window of 2^4 to 2^32 words
+  unsigned int window_bits = 4 + rng_() % 29;
+  window_size_ = window_bits == 32 ? 0xffffffff : (1u << window_bits);
+  window_base_ = rng_();
+
+  uint32_t tor_addr = window_base_;
+  for (unsigned int r = 0; r < num_regions_; ++r) {
+    // NA4 is not selectable with a granularity above 4 bytes
+    unsigned int mode = rng_() % 4;
+    if (mode == kPmpNa4 && granularity_ > 0) {
+      mode = kPmpNapot;
+    }
+
+    uint8_t cfg = (mode << kPmpCfgModeShift) | (rng_() & 7);
+    // W without R is reserved, ibex_cs_registers clears W
+    if (!(cfg & kPmpCfgRead)) {
+      cfg &= ~kPmpCfgWrite;
+    }
+    if (Chance(kLockProb)) {
+      cfg |= kPmpCfgLock;
+    }
+    cfg_[r] = cfg;
+
+    uint32_t offset = rng_() % window_size_;
+    switch (mode) {
+      case kPmpTor:
+        // Mostly ascending, so that TOR regions aren't empty
+        if (Chance(kTorDescendingProb)) {
+          tor_addr -= offset / num_regions_;
+        } else {
+          tor_addr += offset / num_regions_;
+        }
+        addr_[r] = tor_addr;
+        break;
+      case kPmpNapot:
+        if (Chance(kNapotAllProb)) {
+          addr_[r] = 0xffffffff;
+        } else {
+          // Size of 2^(size_bits + 3) bytes
+          unsigned int size_bits = rng_() % window_bits;
+          uint32_t ones = (1u << size_bits) - 1;
+          addr_[r] = ((window_base_ + offset) & ~(ones << 1)) | ones;
+        }
+        break;
+      default:
+        addr_[r] = window_base_ + offset;
+    }
+  }
+
+  configs_++;
+}
+
+uint64_t PmpBench::Address() {
+  if (Chance(kBoundaryProb)) {
+    // Around the start or end of a region, or its pmpaddr if it is off
+    unsigned int r = rng_() % num_regions_;
+    uint64_t start, end;
+    PmpRegionRange(granularity_, cfg_[r], addr_[r], r ? addr_[r - 1] : 0,
+                   start, end);
+    uint64_t boundary = (PmpCfgMode(cfg_[r]) == kPmpOff)
+                            ? static_cast<uint64_t>(addr_[r]) << 2
+                            : (rng_() & 1) ? start : end;
+    int64_t offset = static_cast<int64_t>(rng_() % 16) - 8;
+    return (boundary + offset) & kAddrMask;
+  }
+  if (Chance(kWindowProb)) {
+    uint32_t word = window_base_ + rng_() % window_size_;
+    return ((static_cast<uint64_t>(word) << 2) | (rng_() & 3)) & kAddrMask;
+  }
+  return ((static_cast<uint64_t>(rng_()) << 32) | rng_()) & kAddrMask;
+}
+
+void PmpBench::NewAccesses() {
+  for (size_t i = 0; i < accesses_per_config_; ++i) {
+    req_addr_[i] = Address();
+    req_type_[i] = rng_() % kNumPmpAccess;
+    req_priv_[i] = Chance(kMachineProb) ? kPmpPrivM : 0;
+  }
+
+  auto model_begin = std::chrono::steady_clock::now();
+  PmpCheck(granularity_, num_regions_, cfg_, addr_, req_addr_.data(),
+           req_type_.data(), req_priv_.data(), expected_err_.data(),
+           expected_region_.data(), accesses_per_config_);
+  model_time_ += std::chrono::steady_clock::now() - model_begin;
+
+  pos_ = 0;
+}
+
+void PmpBench::Region(unsigned int r, uint8_t &cfg, uint64_t &addr) const {
+  cfg = cfg_[r];
+  addr = static_cast<uint64_t>(addr_[r]) << 2;
+}
+
+void PmpBench::Error(const std::string &msg) {
+  std::cerr << "ERROR: Cycle " << cycle_ << ": " << msg << std::endl;
+  errors_++;
+}
+
+bool PmpBench::Tick(uint32_t err, bool &new_cfg) {
+  // |issued_| holds the accesses of the cycle ending at this clock edge
+  cycle_++;
+
+  for (unsigned int c = 0; c < num_chan_; ++c) {
+    if (issued_[c] < 0) {
+      continue;
+    }
+    size_t i = issued_[c];
+    bool dut_err = (err >> c) & 1;
+    if (dut_err != expected_err_[i]) {
+      std::ostringstream msg;
+      msg << "Channel " << c << ": " << (dut_err ? "fault" : "no fault")
+          << ", expected " << (expected_err_[i] ? "fault" : "no fault")
+          << " for " << (req_priv_[i] == kPmpPrivM ? "M" : "U")
+          << "-mode access type " << unsigned(req_type_[i]) << " to 0x"
+          << std::hex << req_addr_[i] << std::dec << " (matching region ";
+      if (expected_region_[i] < num_regions_) {
+        msg << unsigned(expected_region_[i]);
+      } else {
+        msg << "none";
+      }
+      msg << ")\n  Regions (cfg, pmpaddr):" << std::hex << std::setfill('0');
+      for (unsigned int r = 0; r < num_regions_; ++r) {
+        msg << " 0x" << std::setw(2) << unsigned(cfg_[r]) << ",0x"
+            << std::setw(8) << addr_[r];
+      }
+      Error(msg.str());
+    }
+    checks_++;
+    faults_ += expected_err_[i];
+    if (expected_region_[i] < num_regions_) {
+      mode_checks_[PmpCfgMode(cfg_[expected_region_[i]])]++;
+    } else {
+      default_checks_++;
+    }
+  }
+
+  // Accesses for the next cycle
+  new_cfg = false;
+  if (pos_ == accesses_per_config_ &&
+      (!max_configs_ || configs_ < max_configs_)) {
+    NewConfig();
+    NewAccesses();
+    new_cfg = true;
+  }
+  for (unsigned int c = 0; c < num_chan_; ++c) {
+    if (pos_ < accesses_per_config_) {
+      issued_[c] = pos_;
+      request_[c].addr = req_addr_[pos_];
+      request_[c].type = req_type_[pos_];
+      request_[c].priv = req_priv_[pos_];
+      pos_++;
+    } else {
+      issued_[c] = -1;
+    }
+  }
+
+  return errors_ || (pos_ == accesses_per_config_ && issued_[0] < 0);
+}
+
+std::string PmpBench::ReportString(bool csv) const {
+  StatValues values;
+
+  double seconds =
+      std::chrono::duration<double>(time_end_ - time_begin_).count();
+  double model_seconds = std::chrono::duration<double>(model_time_).count();
+
+  AddStat(values, "Cycles", cycle_);
+  AddStat(values, "Configurations", configs_);
+  AddStat(values, "Checks", checks_);
+  AddStat(values, "Mismatches", errors_);
+  AddStat(values, "Faults", faults_);
+  for (int mode = kPmpTor; mode <= kPmpNapot; ++mode) {
+    AddStat(values, std::string("Checks Matching ") + kModeNames[mode],
+            mode_checks_[mode]);
+  }
+  AddStat(values, "Checks Matching No Region", default_checks_);
+  AddStatRatio(values, "Checks/Cycle",
+               cycle_ ? static_cast<double>(checks_) / cycle_ : 0.0);
+  AddStat(values, "Checks/s", seconds > 0.0 ? checks_ / seconds : 0);
+  // Throughput of the reference model alone, to see how much of the
+  // simulation time it takes
+  AddStat(values, "Model Checks/s",
+          model_seconds > 0.0 ? configs_ * accesses_per_config_ / model_seconds
+                              : 0);
+
+  return FormatStats(values, csv);
+}
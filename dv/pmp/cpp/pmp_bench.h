@@ -0,0 +1,189 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PMP_BENCH_H_
+#define PMP_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ibex_tb_driver.h"
+#include "pmp_ref_model.h"
+
+// Access driven on one channel of the PMP in one cycle
+struct PmpBenchRequest {
+  uint64_t addr;
+  unsigned int type;
+  unsigned int priv;
+};
+
+/**
+ * Driver and scoreboard of the PMP testbench
+ *
+ * Called through DPI from tb/tb_pmp.sv in every cycle. Programs a random
+ * region configuration, then checks a set of accesses against it, one access
+ * per channel and cycle, before moving on to the next configuration.
+ *
+ * Configurations are random but legal, i.e. as ibex_cs_registers can produce
+ * them: W is only set together with R, and NA4 is only used without
+ * granularity. The regions are placed in a random window of the address
+ * space so that they overlap, which exercises the priority between them.
+ * The accesses of a configuration are a mix of addresses around the region
+ * boundaries, addresses in the window and fully random addresses, with random
+ * access types and M- or U-mode.
+ *
+ * The expected result of all accesses of a configuration is computed with a
+ * single call of PmpCheck().
+ *
+ * The bench is configured on the command line, see PrintHelp().
+ */
+class PmpBench : public IbexTestbench {
+ public:
+  PmpBench();
+  ~PmpBench();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Seed the stimulus and reset the statistics
+   */
+  virtual void PreExec();
+
+  /**
+   * Stop the wall clock time measurement
+   */
+  virtual void PostExec();
+
+  /**
+   * Set the parameters of the DUT
+   */
+  void Init(unsigned int granularity, unsigned int num_chan,
+            unsigned int num_regions);
+
+  /**
+   * Check the access faults of the last cycle, and choose the accesses of the
+   * next one
+   *
+   * @param err Access fault of each channel, one bit per channel
+   * @param new_cfg Set if the next cycle uses a new region configuration
+   * @return true if the simulation should stop
+   */
+  bool Tick(uint32_t err, bool &new_cfg);
+
+  /**
+   * Configuration of a region in the next cycle
+   *
+   * @param cfg pmpcfg entry, in the layout of the pmpcfg CSRs
+   * @param addr Region address input of the DUT, i.e. pmpaddr << 2
+   */
+  void Region(unsigned int r, uint8_t &cfg, uint64_t &addr) const;
+
+  /**
+   * Access of a channel in the next cycle
+   */
+  const PmpBenchRequest &Request(unsigned int chan) const {
+    return request_[chan];
+  }
+
+  /**
+   * Did all checks pass?
+   */
+  virtual bool Passed() const { return errors_ == 0; }
+
+  /**
+   * Returns a formatted string of the bench statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  virtual std::string ReportString(bool csv) const;
+
+ private:
+  // Configuration
+  uint64_t max_configs_;
+  size_t accesses_per_config_;
+  unsigned int seed_;
+
+  // Parameters of the DUT
+  unsigned int granularity_;
+  unsigned int num_chan_;
+  unsigned int num_regions_;
+
+  std::mt19937 rng_;
+
+  // Current region configuration
+  uint8_t cfg_[kPmpMaxRegions];
+  uint32_t addr_[kPmpMaxRegions];
+  // Window of pmpaddr values the regions are placed in
+  uint32_t window_base_;
+  uint32_t window_size_;
+
+  // Accesses of the current configuration, in structure of arrays layout for
+  // PmpCheck()
+  std::vector<uint64_t> req_addr_;
+  std::vector<uint8_t> req_type_;
+  std::vector<uint8_t> req_priv_;
+  std::vector<uint8_t> expected_err_;
+  std::vector<uint8_t> expected_region_;
+  size_t pos_;
+
+  // State of the driver
+  uint64_t cycle_;
+  std::vector<PmpBenchRequest> request_;
+  // Index of the access on each channel in the last cycle, -1 if idle
+  std::vector<long> issued_;
+
+  // Statistics
+  uint64_t errors_;
+  uint64_t configs_;
+  uint64_t checks_;
+  uint64_t faults_;
+  // Checks decided by a region of each mode, and by no region
+  uint64_t mode_checks_[4];
+  uint64_t default_checks_;
+  std::chrono::steady_clock::time_point time_begin_;
+  std::chrono::steady_clock::time_point time_end_;
+  std::chrono::steady_clock::duration model_time_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  bool Chance(double prob) {
+    return std::generate_canonical<double, 32>(rng_) < prob;
+  }
+
+  /**
+   * Choose a random region configuration
+   */
+  void NewConfig();
+
+  /**
+   * Choose the accesses of the current configuration and compute their
+   * expected results
+   */
+  void NewAccesses();
+
+  /**
+   * Choose a random access address
+   */
+  uint64_t Address();
+
+  void Error(const std::string &msg);
+};
+
+#endif  // PMP_BENCH_H_
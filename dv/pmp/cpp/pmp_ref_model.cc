@@ -0,0 +1,79 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pmp_ref_model.h"
+
+#include <cassert>
+
+void PmpRegionRange(unsigned int granularity, uint8_t cfg, uint32_t addr,
+                    uint32_t prev_addr, uint64_t &start, uint64_t &end) {
+  // pmpaddr holds bits [33:2] of the byte address
+  uint64_t base = static_cast<uint64_t>(addr) << 2;
+  uint64_t granule_mask = ~((uint64_t(1) << (granularity + 2)) - 1);
+
+  switch (PmpCfgMode(cfg)) {
+    case kPmpTor:
+      // Bits below the granularity are treated as zero
+      start = (static_cast<uint64_t>(prev_addr) << 2) & granule_mask;
+      end = base & granule_mask;
+      if (end < start) {
+        end = start;
+      }
+      break;
+    case kPmpNa4:
+      start = base;
+      end = base + 4;
+      break;
+    case kPmpNapot: {
+      // Bits [G-2:0] of pmpaddr read as one in NAPOT mode. The trailing ones
+      // and the zero above them select the size, an all ones pmpaddr matches
+      // the whole address space.
+      uint64_t napot = addr;
+      if (granularity >= 2) {
+        napot |= (uint64_t(1) << (granularity - 1)) - 1;
+      }
+      uint64_t size_mask = ((napot ^ (napot + 1)) << 2) | 3;
+      start = (napot << 2) & ~size_mask;
+      end = start + size_mask + 1;
+      break;
+    }
+    default:
+      start = 0;
+      end = 0;
+  }
+}
+
+void PmpCheck(unsigned int granularity, unsigned int num_regions,
+              const uint8_t *cfg, const uint32_t *addr,
+              const uint64_t *req_addr, const uint8_t *req_type,
+              const uint8_t *priv, uint8_t *err, uint8_t *region, size_t n) {
+  assert(num_regions <= kPmpMaxRegions);
+
+  // Without a matching region M-mode accesses are allowed, all others fault
+  for (size_t i = 0; i < n; ++i) {
+    err[i] = priv[i] != kPmpPrivM;
+    region[i] = num_regions;
+  }
+
+  for (int r = num_regions - 1; r >= 0; --r) {
+    uint64_t start, end;
+    PmpRegionRange(granularity, cfg[r], addr[r], r ? addr[r - 1] : 0, start,
+                   end);
+
+    // Whether each access type is permitted, indexed by PmpAccess
+    uint8_t perm = ((cfg[r] & kPmpCfgExec) ? 1 << kPmpExec : 0) |
+                   ((cfg[r] & kPmpCfgWrite) ? 1 << kPmpWrite : 0) |
+                   ((cfg[r] & kPmpCfgRead) ? 1 << kPmpRead : 0);
+    // M-mode accesses only fault in locked regions
+    uint8_t lock = (cfg[r] & kPmpCfgLock) ? 1 : 0;
+
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t match = (req_addr[i] >= start) & (req_addr[i] < end);
+      uint8_t denied = ~(perm >> req_type[i]) & 1;
+      uint8_t fault = (priv[i] == kPmpPrivM) ? (lock & denied) : denied;
+      err[i] = match ? fault : err[i];
+      region[i] = match ? r : region[i];
+    }
+  }
+}
@@ -0,0 +1,74 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PMP_REF_MODEL_H_
+#define PMP_REF_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Access types, must match ibex_pkg::pmp_req_e
+enum PmpAccess { kPmpExec = 0, kPmpWrite = 1, kPmpRead = 2, kNumPmpAccess };
+
+// Address matching modes, must match ibex_pkg::pmp_cfg_mode_e
+enum PmpMode { kPmpOff = 0, kPmpTor = 1, kPmpNa4 = 2, kPmpNapot = 3 };
+
+// Privilege level encoding of M-mode, see ibex_pkg::priv_lvl_e
+static const unsigned int kPmpPrivM = 3;
+
+// Fields of a pmpcfg entry, as in the pmpcfg CSRs
+static const uint8_t kPmpCfgRead = 1 << 0;
+static const uint8_t kPmpCfgWrite = 1 << 1;
+static const uint8_t kPmpCfgExec = 1 << 2;
+static const unsigned int kPmpCfgModeShift = 3;
+static const uint8_t kPmpCfgLock = 1 << 7;
+
+/**
+ * Number of PMP regions the model supports
+ */
+static const unsigned int kPmpMaxRegions = 16;
+
+static inline PmpMode PmpCfgMode(uint8_t cfg) {
+  return static_cast<PmpMode>((cfg >> kPmpCfgModeShift) & 3);
+}
+
+/**
+ * Byte address range [start, end) matched by a PMP region
+ *
+ * Follows the RISC-V privileged specification v1.11, section 3.6, for a
+ * granularity of 2^(granularity + 2) bytes. The range is empty if the region
+ * is off, or for a TOR region whose top is not above its bottom.
+ *
+ * @param granularity PMPGranularity parameter
+ * @param cfg pmpcfg entry of the region
+ * @param addr pmpaddr of the region
+ * @param prev_addr pmpaddr of the region below (0 for the first region)
+ */
+void PmpRegionRange(unsigned int granularity, uint8_t cfg, uint32_t addr,
+                    uint32_t prev_addr, uint64_t &start, uint64_t &end);
+
+/**
+ * Check a batch of accesses against a PMP configuration
+ *
+ * The regions are decoded once per batch, then each region is compared with
+ * all addresses of the batch in a loop without data dependent branches, which
+ * the compiler vectorizes. Regions are applied from the highest to the lowest
+ * numbered one, so the lowest numbered matching region decides.
+ *
+ * @param granularity PMPGranularity parameter
+ * @param num_regions Number of regions (at most kPmpMaxRegions)
+ * @param cfg, addr pmpcfg and pmpaddr of each region
+ * @param req_addr, req_type, priv 34 bit address, access type (PmpAccess) and
+ *                                 privilege level of each access
+ * @param err Whether each access faults
+ * @param region Lowest numbered region matching each access, num_regions if
+ *               none matches
+ * @param n Number of accesses
+ */
+void PmpCheck(unsigned int granularity, unsigned int num_regions,
+              const uint8_t *cfg, const uint32_t *addr,
+              const uint64_t *req_addr, const uint8_t *req_type,
+              const uint8_t *priv, uint8_t *err, uint8_t *region, size_t n);
+
+#endif  // PMP_REF_MODEL_H_
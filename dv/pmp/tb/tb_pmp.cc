@@ -0,0 +1,14 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pmp_bench.h"
+#include "ibex_tb_driver.h"
+#include "verilated_toplevel.h"
+
+int main(int argc, char **argv) {
+  tb_pmp top;
+  PmpBench bench;
+  return RunTestbench(&top, &top.clk_i, &top.rst_ni, bench, "PMP",
+                      "tb_pmp_stats.csv", argc, argv);
+}
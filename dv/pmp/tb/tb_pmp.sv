@@ -0,0 +1,125 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * PMP testbench
+ *
+ * Instantiates ibex_pmp and drives its region configuration and access
+ * channels from the C++ driver in ../cpp/pmp_bench.cc, which checks every
+ * access fault against a reference model. The C++ side is called once per
+ * clock edge with the sampled DUT outputs, and returns the DUT inputs for the
+ * next cycle.
+ */
+module tb_pmp #(
+  parameter int unsigned PMPGranularity = 0,
+  parameter int unsigned PMPNumChan     = 2,
+  parameter int unsigned PMPNumRegions  = 4
+) (
+  input logic clk_i,
+  input logic rst_ni
+);
+
+  import ibex_pkg::*;
+
+  import "DPI-C" function void pmp_tb_init(input int granularity,
+                                           input int num_chan,
+                                           input int num_regions);
+
+  import "DPI-C" function void pmp_tb_tick(
+    // DUT outputs, sampled at the clock edge
+    input  bit [PMPNumChan-1:0] err,
+    // Whether the region configuration changes in the next cycle
+    output bit                  new_cfg,
+    output bit                  stop);
+
+  // Region configuration for the next cycle, only called if it changes
+  import "DPI-C" function void pmp_tb_region(
+    input  int        r,
+    output bit [5:0]  cfg,
+    output bit [33:0] addr);
+
+  // Access of a channel in the next cycle
+  import "DPI-C" function void pmp_tb_req(
+    input  int        chan,
+    output bit [33:0] addr,
+    output bit [1:0]  req_type,
+    output bit [1:0]  priv);
+
+  pmp_cfg_t    csr_pmp_cfg  [PMPNumRegions];
+  logic [33:0] csr_pmp_addr [PMPNumRegions];
+  priv_lvl_e   priv_mode    [PMPNumChan];
+  logic [33:0] req_addr     [PMPNumChan];
+  pmp_req_e    req_type     [PMPNumChan];
+  logic        req_err      [PMPNumChan];
+
+  ibex_pmp #(
+    .PMPGranularity (PMPGranularity),
+    .PMPNumChan     (PMPNumChan),
+    .PMPNumRegions  (PMPNumRegions)
+  ) u_pmp (
+    .clk_i          (clk_i),
+    .rst_ni         (rst_ni),
+
+    .csr_pmp_cfg_i  (csr_pmp_cfg),
+    .csr_pmp_addr_i (csr_pmp_addr),
+
+    .priv_mode_i    (priv_mode),
+    .pmp_req_addr_i (req_addr),
+    .pmp_req_type_i (req_type),
+    .pmp_req_err_o  (req_err)
+  );
+
+  initial begin
+    pmp_tb_init(PMPGranularity, PMPNumChan, PMPNumRegions);
+  end
+
+  bit [PMPNumChan-1:0] err;
+  always_comb begin
+    for (int c = 0; c < PMPNumChan; c++) begin
+      err[c] = req_err[c];
+    end
+  end
+
+  // Outputs of the DPI functions, applied to the DUT after the clock edge
+  bit        new_cfg;
+  bit        stop;
+  bit [5:0]  region_cfg_d;
+  bit [33:0] region_addr_d;
+  bit [33:0] req_addr_d;
+  bit [1:0]  req_type_d;
+  bit [1:0]  priv_d;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      for (int r = 0; r < PMPNumRegions; r++) begin
+        csr_pmp_cfg[r]  <= pmp_cfg_t'('0);
+        csr_pmp_addr[r] <= '0;
+      end
+      for (int c = 0; c < PMPNumChan; c++) begin
+        priv_mode[c] <= PRIV_LVL_M;
+        req_addr[c]  <= '0;
+        req_type[c]  <= PMP_ACC_EXEC;
+      end
+    end else begin
+      pmp_tb_tick(err, new_cfg, stop);
+      if (new_cfg) begin
+        for (int r = 0; r < PMPNumRegions; r++) begin
+          pmp_tb_region(r, region_cfg_d, region_addr_d);
+          csr_pmp_cfg[r]  <= pmp_cfg_t'(region_cfg_d);
+          csr_pmp_addr[r] <= region_addr_d;
+        end
+      end
+      for (int c = 0; c < PMPNumChan; c++) begin
+        pmp_tb_req(c, req_addr_d, req_type_d, priv_d);
+        req_addr[c]  <= req_addr_d;
+        req_type[c]  <= pmp_req_e'(req_type_d);
+        priv_mode[c] <= priv_lvl_e'(priv_d);
+      end
+      if (stop) begin
+        $finish();
+      end
+    end
+  end
+
+endmodule
@@ -0,0 +1,262 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_bin_trace.h"
+
+#include <getopt.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+IbexBinTrace *IbexBinTrace::instance_ = nullptr;
+
+IbexBinTrace::IbexBinTrace(const std::string &filename)
+    : enabled_(false),
+      filename_(filename),
+      file_(nullptr),
+      chunk_records_(16384) {
+  assert(!instance_ && "Only one IbexBinTrace instance is supported.");
+  instance_ = this;
+  StartChunk();
+}
+
+IbexBinTrace::~IbexBinTrace() {
+  PostExec();
+  instance_ = nullptr;
+}
+
+bool IbexBinTrace::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"bin-trace", optional_argument, nullptr, 'B'},
+      {"bin-trace-chunk", required_argument, nullptr, 'C'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'B':
+        enabled_ = true;
+        if (optarg) {
+          filename_ = optarg;
+        }
+        break;
+      case 'C':
+        chunk_records_ = strtoul(optarg, nullptr, 0);
+        if (chunk_records_ == 0) {
+          std::cerr << "ERROR: Invalid chunk size: " << optarg << std::endl;
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void IbexBinTrace::PreExec() {
+  if (!enabled_) {
+    return;
+  }
+
+  file_ = fopen(filename_.c_str(), "wb");
+  if (!file_) {
+    std::cerr << "ERROR: Could not open binary trace " << filename_
+              << std::endl;
+    enabled_ = false;
+    return;
+  }
+
+  BinTraceFileHeader header;
+  memcpy(header.magic, kBinTraceMagic, sizeof(header.magic));
+  header.version = kBinTraceVersion;
+  header.chunk_records = chunk_records_;
+  fwrite(&header, sizeof(header), 1, file_);
+
+  std::cout << "Writing binary instruction trace to " << filename_
+            << std::endl;
+}
+
+void IbexBinTrace::PostExec() {
+  if (!file_) {
+    return;
+  }
+
+  FlushChunk();
+
+  BinTraceFooter footer;
+  footer.index_offset = ftell(file_);
+  footer.num_chunks = index_.size();
+  footer.reserved = 0;
+  memcpy(footer.magic, kBinTraceFooterMagic, sizeof(footer.magic));
+  if (!index_.empty()) {
+    fwrite(index_.data(), sizeof(BinTraceIndexEntry), index_.size(), file_);
+  }
+  fwrite(&footer, sizeof(footer), 1, file_);
+
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void IbexBinTrace::Retire(const BinTraceRecord &record) {
+  if (!file_) {
+    return;
+  }
+
+  // Reserve space for the flags, which are known at the end
+  size_t flags_pos = chunk_.size();
+  chunk_.push_back(0);
+  uint8_t flags = 0;
+
+  BinTracePutVarint(chunk_, record.cycle - prev_cycle_);
+
+  if (entry_.num_records && record.pc == BinTraceNextPc(prev_pc_, prev_insn_)) {
+    flags |= kBinTracePcSeq;
+  } else {
+    BinTracePutVarint(chunk_,
+                      BinTraceZigzag(int32_t(record.pc - prev_pc_)));
+  }
+
+  auto dict_it = dict_.find(record.insn);
+  if (dict_it == dict_.end()) {
+    flags |= kBinTraceInsnNew;
+    dict_.emplace(record.insn, dict_.size());
+    for (int i = 0; i < 4; ++i) {
+      chunk_.push_back(static_cast<char>(record.insn >> (8 * i)));
+    }
+  } else {
+    BinTracePutVarint(chunk_, dict_it->second);
+  }
+
+  if (record.rd_addr) {
+    flags |= kBinTraceRd;
+    chunk_.push_back(static_cast<char>(record.rd_addr));
+    BinTracePutVarint(chunk_, record.rd_wdata);
+  }
+
+  if (record.mem_rmask || record.mem_wmask) {
+    flags |= kBinTraceMem;
+    BinTracePutVarint(
+        chunk_, BinTraceZigzag(int32_t(record.mem_addr - prev_mem_addr_)));
+    chunk_.push_back(
+        static_cast<char>((record.mem_rmask << 4) | (record.mem_wmask & 0xf)));
+    if (record.mem_rmask) {
+      BinTracePutVarint(chunk_, record.mem_rdata);
+    }
+    if (record.mem_wmask) {
+      BinTracePutVarint(chunk_, record.mem_wdata);
+    }
+    prev_mem_addr_ = record.mem_addr;
+  }
+
+  if (record.trap) {
+    flags |= kBinTraceTrap;
+  }
+  if (record.intr) {
+    flags |= kBinTraceIntr;
+  }
+  chunk_[flags_pos] = static_cast<char>(flags);
+
+  if (!entry_.num_records) {
+    entry_.first_cycle = record.cycle;
+    entry_.pc_min = record.pc;
+    entry_.pc_max = record.pc;
+  }
+  entry_.last_cycle = record.cycle;
+  entry_.pc_min = std::min(entry_.pc_min, record.pc);
+  entry_.pc_max = std::max(entry_.pc_max, record.pc);
+  unsigned filter_bit = BinTracePcFilterBit(record.pc);
+  entry_.pc_filter[filter_bit / 64] |= uint64_t(1) << (filter_bit % 64);
+  entry_.num_records++;
+
+  prev_cycle_ = record.cycle;
+  prev_pc_ = record.pc;
+  prev_insn_ = record.insn;
+
+  if (entry_.num_records == chunk_records_) {
+    FlushChunk();
+  }
+}
+
+void IbexBinTrace::StartChunk() {
+  chunk_.clear();
+  memset(&entry_, 0, sizeof(entry_));
+  prev_cycle_ = 0;
+  prev_pc_ = 0;
+  prev_insn_ = 0;
+  prev_mem_addr_ = 0;
+  dict_.clear();
+}
+
+void IbexBinTrace::FlushChunk() {
+  if (!entry_.num_records) {
+    return;
+  }
+
+  // Fast compression keeps the cost on the simulation thread low, most of the
+  // redundancy has been removed by the encoding already
+  uLongf compressed_size = compressBound(chunk_.size());
+  compressed_.resize(compressed_size);
+  if (compress2(reinterpret_cast<Bytef *>(&compressed_[0]), &compressed_size,
+                reinterpret_cast<const Bytef *>(chunk_.data()), chunk_.size(),
+                Z_BEST_SPEED) != Z_OK) {
+    std::cerr << "ERROR: Compressing binary trace chunk failed." << std::endl;
+    StartChunk();
+    return;
+  }
+
+  BinTraceChunkHeader header;
+  header.raw_size = chunk_.size();
+  header.compressed_size = compressed_size;
+  header.num_records = entry_.num_records;
+  header.reserved = 0;
+  header.first_cycle = entry_.first_cycle;
+  header.last_cycle = entry_.last_cycle;
+
+  entry_.offset = ftell(file_);
+  fwrite(&header, sizeof(header), 1, file_);
+  fwrite(compressed_.data(), 1, compressed_size, file_);
+  index_.push_back(entry_);
+
+  StartChunk();
+}
+
+void IbexBinTrace::PrintHelp() const {
+  std::cout << "Binary instruction trace:\n\n"
+               "--bin-trace[=FILE]\n"
+               "  Write a compressed binary trace of all retired instructions\n"
+               "  to FILE (default: "
+            << filename_
+            << ")\n\n"
+               "--bin-trace-chunk=N\n"
+               "  Number of instructions per compressed chunk (default: "
+            << chunk_records_ << ")\n\n";
+}
@@ -0,0 +1,113 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_BIN_TRACE_H_
+#define IBEX_BIN_TRACE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ibex_bin_trace_format.h"
+#include "sim_ctrl_extension.h"
+
+/**
+ * Binary instruction trace writer for Verilator simulations
+ *
+ * Receives the instructions retired on RVFI from the bin_trace module (see
+ * rtl/bin_trace.sv) and writes them to a compressed, indexed trace file (see
+ * ibex_bin_trace_format.h for the format).
+ *
+ * The trace is enabled on the command line:
+ *
+ * --bin-trace[=FILE]
+ *   Write the binary trace to FILE (or the default file name).
+ *
+ * --bin-trace-chunk=N
+ *   Number of instructions per compressed chunk (default 16384). Smaller
+ *   chunks make seeking faster but compress worse.
+ */
+class IbexBinTrace : public SimCtrlExtension {
+ public:
+  /**
+   * @param filename Default name of the trace file
+   */
+  IbexBinTrace(const std::string &filename);
+  ~IbexBinTrace();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Open the trace file
+   */
+  virtual void PreExec();
+
+  /**
+   * Write the last chunk and the index, and close the trace file
+   */
+  virtual void PostExec();
+
+  /**
+   * Has the binary trace been enabled?
+   */
+  bool IsEnabled() const { return enabled_; }
+
+  /**
+   * Add a retired instruction to the trace
+   */
+  void Retire(const BinTraceRecord &record);
+
+  /**
+   * The instance the DPI functions report to, nullptr if there is none
+   */
+  static IbexBinTrace *Instance() { return instance_; }
+
+ private:
+  static IbexBinTrace *instance_;
+
+  bool enabled_;
+  std::string filename_;
+  FILE *file_;
+  uint32_t chunk_records_;
+
+  // Encoder state of the current chunk
+  std::string chunk_;
+  BinTraceIndexEntry entry_;
+  uint64_t prev_cycle_;
+  uint32_t prev_pc_;
+  uint32_t prev_insn_;
+  uint32_t prev_mem_addr_;
+  std::unordered_map<uint32_t, uint32_t> dict_;
+
+  std::vector<BinTraceIndexEntry> index_;
+  std::string compressed_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Reset the encoder state at the start of a chunk
+   */
+  void StartChunk();
+
+  /**
+   * Compress and write the current chunk
+   */
+  void FlushChunk();
+};
+
+#endif  // IBEX_BIN_TRACE_H_
@@ -0,0 +1,46 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// DPI functions of rtl/bin_trace.sv, kept apart from IbexBinTrace so the
+// trace writer can be built without Verilator (see test/).
+
+#include <cassert>
+
+#include <svdpi.h>
+
+#include "ibex_bin_trace.h"
+#include "verilator_sim_ctrl.h"
+
+// DPI Imports
+extern "C" {
+
+svBit bin_trace_enabled() {
+  return IbexBinTrace::Instance() && IbexBinTrace::Instance()->IsEnabled();
+}
+
+void bin_trace_retire(const svBitVecVal *pc, const svBitVecVal *insn,
+                      svBit trap, svBit intr, const svBitVecVal *rd_addr,
+                      const svBitVecVal *rd_wdata, const svBitVecVal *mem_addr,
+                      const svBitVecVal *mem_rmask,
+                      const svBitVecVal *mem_wmask,
+                      const svBitVecVal *mem_rdata,
+                      const svBitVecVal *mem_wdata) {
+  assert(IbexBinTrace::Instance());
+
+  BinTraceRecord record;
+  record.cycle = VerilatorSimCtrl::GetInstance().GetTime() / 2;
+  record.pc = pc[0];
+  record.insn = insn[0];
+  record.trap = trap;
+  record.intr = intr;
+  record.rd_addr = rd_addr[0];
+  record.rd_wdata = rd_wdata[0];
+  record.mem_addr = mem_addr[0];
+  record.mem_rmask = mem_rmask[0];
+  record.mem_wmask = mem_wmask[0];
+  record.mem_rdata = mem_rdata[0];
+  record.mem_wdata = mem_wdata[0];
+  IbexBinTrace::Instance()->Retire(record);
+}
+}
@@ -0,0 +1,170 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_BIN_TRACE_FORMAT_H_
+#define IBEX_BIN_TRACE_FORMAT_H_
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Binary instruction trace format
+ *
+ * A compact alternative to the text logs of ibex_tracer, written by
+ * IbexBinTrace (see ibex_bin_trace.h) and read by IbexBinTraceReader (see
+ * ibex_bin_trace_reader.h) and util/ibex_bin_trace.py.
+ *
+ * File layout (all integers little-endian):
+ *
+ *   BinTraceFileHeader
+ *   Chunk 0: BinTraceChunkHeader, zlib compressed records
+ *   Chunk 1: ...
+ *   BinTraceIndexEntry for every chunk
+ *   BinTraceFooter
+ *
+ * Every chunk holds up to |chunk_records| retired instructions and can be
+ * decoded on its own. The index at the end of the file describes the cycle
+ * and PC range of each chunk, so readers can seek to a cycle or skip chunks
+ * which don't contain a PC without decompressing them. If the simulation
+ * didn't end cleanly the index is missing; the chunks can still be found by
+ * walking the chunk headers.
+ *
+ * Within a chunk each record is encoded relative to the previous one (the
+ * state is reset at the start of every chunk):
+ *
+ *   flags           1 byte, kBinTrace* bits below
+ *   cycle delta     varint
+ *   pc              zigzag varint delta to the previous PC, unless
+ *                   kBinTracePcSeq (PC follows the previous instruction)
+ *   insn            4 bytes if kBinTraceInsnNew (and the instruction word is
+ *                   added to the chunk's dictionary), else a varint index
+ *                   into the dictionary
+ *   rd              if kBinTraceRd: 1 byte register, varint write data
+ *   mem             if kBinTraceMem: zigzag varint delta to the previous
+ *                   memory address, 1 byte masks (rmask << 4 | wmask),
+ *                   varint read data if rmask, varint write data if wmask
+ *
+ * Varints use 7 bits per byte, least significant group first, with the top
+ * bit set on all but the last byte.
+ */
+
+static const char kBinTraceMagic[8] = {'I', 'B', 'E', 'X', 'T', 'R', 'C', 'E'};
+static const char kBinTraceFooterMagic[8] = {'I', 'B', 'E', 'X',
+                                             'T', 'I', 'D', 'X'};
+static const uint32_t kBinTraceVersion = 1;
+
+// Record flags
+static const uint8_t kBinTracePcSeq = 1 << 0;
+static const uint8_t kBinTraceInsnNew = 1 << 1;
+static const uint8_t kBinTraceRd = 1 << 2;
+static const uint8_t kBinTraceMem = 1 << 3;
+static const uint8_t kBinTraceTrap = 1 << 4;
+static const uint8_t kBinTraceIntr = 1 << 5;
+
+// Number of bits in the PC filter of each index entry
+static const unsigned kBinTracePcFilterBits = 256;
+
+struct BinTraceFileHeader {
+  char magic[8];           // kBinTraceMagic
+  uint32_t version;        // kBinTraceVersion
+  uint32_t chunk_records;  // Maximum number of records per chunk
+};
+
+struct BinTraceChunkHeader {
+  uint32_t raw_size;         // Size of the records after decompression
+  uint32_t compressed_size;  // Size of the compressed records following
+  uint32_t num_records;      // Number of records in the chunk
+  uint32_t reserved;
+  uint64_t first_cycle;  // Cycle of the first record
+  uint64_t last_cycle;   // Cycle of the last record
+};
+
+struct BinTraceIndexEntry {
+  uint64_t offset;  // File offset of the BinTraceChunkHeader
+  uint64_t first_cycle;
+  uint64_t last_cycle;
+  uint32_t pc_min;  // Lowest and highest PC retired in the chunk
+  uint32_t pc_max;
+  uint32_t num_records;
+  uint32_t reserved;
+  // Bit BinTracePcFilterBit(pc) is set for every PC retired in the chunk
+  uint64_t pc_filter[kBinTracePcFilterBits / 64];
+};
+
+struct BinTraceFooter {
+  uint64_t index_offset;  // File offset of the first BinTraceIndexEntry
+  uint32_t num_chunks;
+  uint32_t reserved;
+  char magic[8];  // kBinTraceFooterMagic
+};
+
+/**
+ * One retired instruction
+ */
+struct BinTraceRecord {
+  uint64_t cycle;
+  uint32_t pc;
+  uint32_t insn;  // Compressed instructions in the lower 16 bits
+  bool trap;
+  bool intr;
+  uint8_t rd_addr;  // 0 if no register was written
+  uint32_t rd_wdata;
+  uint8_t mem_rmask;  // Both 0 if no memory access was made
+  uint8_t mem_wmask;
+  uint32_t mem_addr;
+  uint32_t mem_rdata;
+  uint32_t mem_wdata;
+};
+
+/**
+ * Bit of the PC filter of an index entry which is set for |pc|
+ */
+inline unsigned BinTracePcFilterBit(uint32_t pc) {
+  // Instructions in the same 16 byte block share a bit, so loops set only a
+  // few bits
+  return ((pc >> 4) * 0x9e3779b1u) >> (32 - 8);
+}
+
+/**
+ * Address of the instruction following |insn| at |pc|
+ */
+inline uint32_t BinTraceNextPc(uint32_t pc, uint32_t insn) {
+  return pc + ((insn & 3) == 3 ? 4 : 2);
+}
+
+inline void BinTracePutVarint(std::string &buf, uint64_t value) {
+  while (value >= 0x80) {
+    buf.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<char>(value));
+}
+
+/**
+ * Decode a varint from [|pos|, |end|), advancing |pos|
+ *
+ * @return false if the data ended before the varint did
+ */
+inline bool BinTraceGetVarint(const uint8_t *&pos, const uint8_t *end,
+                              uint64_t &value) {
+  value = 0;
+  for (unsigned shift = 0; pos < end && shift < 64; shift += 7) {
+    uint8_t byte = *pos++;
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline uint64_t BinTraceZigzag(int64_t value) {
+  return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+inline int64_t BinTraceUnzigzag(uint64_t value) {
+  return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+#endif  // IBEX_BIN_TRACE_FORMAT_H_
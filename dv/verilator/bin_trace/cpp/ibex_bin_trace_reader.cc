@@ -0,0 +1,310 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_bin_trace_reader.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+IbexBinTraceReader::IbexBinTraceReader()
+    : file_(nullptr),
+      next_chunk_(0),
+      pos_(nullptr),
+      remaining_(0),
+      has_pending_(false) {}
+
+IbexBinTraceReader::~IbexBinTraceReader() { Close(); }
+
+bool IbexBinTraceReader::Open(const std::string &filename) {
+  Close();
+  error_.clear();
+
+  file_ = fopen(filename.c_str(), "rb");
+  if (!file_) {
+    error_ = "Could not open " + filename;
+    return false;
+  }
+
+  BinTraceFileHeader header;
+  if (fread(&header, sizeof(header), 1, file_) != 1 ||
+      memcmp(header.magic, kBinTraceMagic, sizeof(header.magic)) != 0 ||
+      header.version != kBinTraceVersion) {
+    error_ = filename + " is not a version " +
+             std::to_string(kBinTraceVersion) + " binary trace";
+    Close();
+    return false;
+  }
+
+  if (!ReadIndex() && !ScanChunks()) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void IbexBinTraceReader::Close() {
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  index_.clear();
+  next_chunk_ = 0;
+  remaining_ = 0;
+  has_pending_ = false;
+}
+
+bool IbexBinTraceReader::ReadIndex() {
+  BinTraceFooter footer;
+  if (fseek(file_, -long(sizeof(footer)), SEEK_END) != 0 ||
+      fread(&footer, sizeof(footer), 1, file_) != 1 ||
+      memcmp(footer.magic, kBinTraceFooterMagic, sizeof(footer.magic)) != 0) {
+    return false;
+  }
+
+  index_.resize(footer.num_chunks);
+  if (fseek(file_, footer.index_offset, SEEK_SET) != 0 ||
+      (footer.num_chunks && fread(index_.data(), sizeof(BinTraceIndexEntry),
+                                  index_.size(), file_) != index_.size())) {
+    index_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool IbexBinTraceReader::ScanChunks() {
+  long offset = sizeof(BinTraceFileHeader);
+  BinTraceChunkHeader header;
+
+  // Chunks are written in one go, so a truncated chunk can only be the last
+  while (fseek(file_, offset, SEEK_SET) == 0 &&
+         fread(&header, sizeof(header), 1, file_) == 1) {
+    if (fseek(file_, offset + sizeof(header) + header.compressed_size - 1,
+              SEEK_SET) != 0 ||
+        fgetc(file_) == EOF) {
+      break;
+    }
+
+    BinTraceIndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = offset;
+    entry.first_cycle = header.first_cycle;
+    entry.last_cycle = header.last_cycle;
+    entry.num_records = header.num_records;
+    // The PCs are unknown without decoding the chunk
+    entry.pc_min = 0;
+    entry.pc_max = UINT32_MAX;
+    memset(entry.pc_filter, 0xff, sizeof(entry.pc_filter));
+    index_.push_back(entry);
+
+    offset += sizeof(header) + header.compressed_size;
+  }
+
+  if (index_.empty()) {
+    error_ = "No complete chunks found in trace";
+    return false;
+  }
+  return true;
+}
+
+bool IbexBinTraceReader::LoadChunk(size_t chunk) {
+  BinTraceChunkHeader header;
+  if (fseek(file_, index_[chunk].offset, SEEK_SET) != 0 ||
+      fread(&header, sizeof(header), 1, file_) != 1) {
+    error_ = "Could not read chunk " + std::to_string(chunk);
+    return false;
+  }
+
+  compressed_.resize(header.compressed_size);
+  raw_.resize(header.raw_size);
+  uLongf raw_size = header.raw_size;
+  if (fread(compressed_.data(), 1, compressed_.size(), file_) !=
+          compressed_.size() ||
+      uncompress(raw_.data(), &raw_size, compressed_.data(),
+                 compressed_.size()) != Z_OK ||
+      raw_size != header.raw_size) {
+    error_ = "Could not decompress chunk " + std::to_string(chunk);
+    return false;
+  }
+
+  next_chunk_ = chunk + 1;
+  pos_ = raw_.data();
+  remaining_ = header.num_records;
+  prev_cycle_ = 0;
+  prev_pc_ = 0;
+  prev_insn_ = 0;
+  prev_mem_addr_ = 0;
+  dict_.clear();
+  return true;
+}
+
+bool IbexBinTraceReader::Decode(BinTraceRecord &record) {
+  const uint8_t *end = raw_.data() + raw_.size();
+  uint64_t value;
+
+  if (pos_ >= end) {
+    error_ = "Unexpected end of chunk";
+    return false;
+  }
+  uint8_t flags = *pos_++;
+
+  if (!BinTraceGetVarint(pos_, end, value)) {
+    error_ = "Unexpected end of chunk";
+    return false;
+  }
+  record.cycle = prev_cycle_ + value;
+
+  if (flags & kBinTracePcSeq) {
+    record.pc = BinTraceNextPc(prev_pc_, prev_insn_);
+  } else {
+    if (!BinTraceGetVarint(pos_, end, value)) {
+      error_ = "Unexpected end of chunk";
+      return false;
+    }
+    record.pc = prev_pc_ + uint32_t(BinTraceUnzigzag(value));
+  }
+
+  if (flags & kBinTraceInsnNew) {
+    if (end - pos_ < 4) {
+      error_ = "Unexpected end of chunk";
+      return false;
+    }
+    record.insn = uint32_t(pos_[0]) | uint32_t(pos_[1]) << 8 |
+                  uint32_t(pos_[2]) << 16 | uint32_t(pos_[3]) << 24;
+    pos_ += 4;
+    dict_.push_back(record.insn);
+  } else {
+    if (!BinTraceGetVarint(pos_, end, value) || value >= dict_.size()) {
+      error_ = "Invalid instruction dictionary index";
+      return false;
+    }
+    record.insn = dict_[value];
+  }
+
+  record.rd_addr = 0;
+  record.rd_wdata = 0;
+  if (flags & kBinTraceRd) {
+    if (pos_ >= end) {
+      error_ = "Unexpected end of chunk";
+      return false;
+    }
+    record.rd_addr = *pos_++;
+    if (!BinTraceGetVarint(pos_, end, value)) {
+      error_ = "Unexpected end of chunk";
+      return false;
+    }
+    record.rd_wdata = value;
+  }
+
+  record.mem_addr = 0;
+  record.mem_rmask = 0;
+  record.mem_wmask = 0;
+  record.mem_rdata = 0;
+  record.mem_wdata = 0;
+  if (flags & kBinTraceMem) {
+    if (!BinTraceGetVarint(pos_, end, value) || pos_ >= end) {
+      error_ = "Unexpected end of chunk";
+      return false;
+    }
+    record.mem_addr = prev_mem_addr_ + uint32_t(BinTraceUnzigzag(value));
+    record.mem_rmask = *pos_ >> 4;
+    record.mem_wmask = *pos_ & 0xf;
+    pos_++;
+    if (record.mem_rmask) {
+      if (!BinTraceGetVarint(pos_, end, value)) {
+        error_ = "Unexpected end of chunk";
+        return false;
+      }
+      record.mem_rdata = value;
+    }
+    if (record.mem_wmask) {
+      if (!BinTraceGetVarint(pos_, end, value)) {
+        error_ = "Unexpected end of chunk";
+        return false;
+      }
+      record.mem_wdata = value;
+    }
+    prev_mem_addr_ = record.mem_addr;
+  }
+
+  record.trap = flags & kBinTraceTrap;
+  record.intr = flags & kBinTraceIntr;
+
+  prev_cycle_ = record.cycle;
+  prev_pc_ = record.pc;
+  prev_insn_ = record.insn;
+  remaining_--;
+  return true;
+}
+
+bool IbexBinTraceReader::Next(BinTraceRecord &record) {
+  if (has_pending_) {
+    record = pending_;
+    has_pending_ = false;
+    return true;
+  }
+
+  while (!remaining_) {
+    if (!file_ || next_chunk_ >= index_.size()) {
+      return false;
+    }
+    if (!LoadChunk(next_chunk_)) {
+      return false;
+    }
+  }
+  return Decode(record);
+}
+
+bool IbexBinTraceReader::SeekCycle(uint64_t cycle) {
+  has_pending_ = false;
+  remaining_ = 0;
+
+  // First chunk which ends at or after |cycle|
+  auto it = std::lower_bound(index_.begin(), index_.end(), cycle,
+                             [](const BinTraceIndexEntry &entry,
+                                uint64_t cycle) {
+                               return entry.last_cycle < cycle;
+                             });
+  if (it == index_.end()) {
+    next_chunk_ = index_.size();
+    return false;
+  }
+  if (!LoadChunk(it - index_.begin())) {
+    return false;
+  }
+
+  while (Next(pending_)) {
+    if (pending_.cycle >= cycle) {
+      has_pending_ = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IbexBinTraceReader::ChunkMayContainPc(size_t chunk, uint32_t pc) const {
+  const BinTraceIndexEntry &entry = index_[chunk];
+  unsigned filter_bit = BinTracePcFilterBit(pc);
+  return pc >= entry.pc_min && pc <= entry.pc_max &&
+         (entry.pc_filter[filter_bit / 64] >> (filter_bit % 64)) & 1;
+}
+
+bool IbexBinTraceReader::NextPc(uint32_t pc, BinTraceRecord &record) {
+  while (1) {
+    if (!has_pending_ && !remaining_) {
+      // Skip to the next chunk which might contain |pc|
+      while (next_chunk_ < index_.size() &&
+             !ChunkMayContainPc(next_chunk_, pc)) {
+        next_chunk_++;
+      }
+    }
+    if (!Next(record)) {
+      return false;
+    }
+    if (record.pc == pc) {
+      return true;
+    }
+  }
+}
@@ -0,0 +1,130 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_BIN_TRACE_READER_H_
+#define IBEX_BIN_TRACE_READER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ibex_bin_trace_format.h"
+
+/**
+ * Streaming reader for binary instruction traces
+ *
+ * Decodes the traces written by IbexBinTrace (see ibex_bin_trace_format.h)
+ * one record at a time, decompressing one chunk at a time. SeekCycle() and
+ * NextPc() use the chunk index to skip chunks without decompressing them.
+ *
+ * The reader only depends on zlib and can be built into tools outside of the
+ * simulation, e.g. to compare traces or build profiles:
+ *
+ *   IbexBinTraceReader reader;
+ *   if (!reader.Open("trace.bin")) { ... reader.Error() ... }
+ *   reader.SeekCycle(100000);
+ *   BinTraceRecord record;
+ *   while (reader.Next(record)) { ... }
+ */
+class IbexBinTraceReader {
+ public:
+  IbexBinTraceReader();
+  ~IbexBinTraceReader();
+
+  /**
+   * Open a trace file and read its index
+   *
+   * If the index is missing (the simulation didn't end cleanly) it is rebuilt
+   * from the chunk headers, without PC ranges.
+   *
+   * @return false on error, see Error()
+   */
+  bool Open(const std::string &filename);
+
+  void Close();
+
+  /**
+   * Description of the last error, empty if there was none
+   */
+  const std::string &Error() const { return error_; }
+
+  /**
+   * Index entries of all chunks, in trace order
+   */
+  const std::vector<BinTraceIndexEntry> &Index() const { return index_; }
+
+  /**
+   * Position the reader at the first record at or after |cycle|
+   *
+   * @return false if there is no such record
+   */
+  bool SeekCycle(uint64_t cycle);
+
+  /**
+   * Get the next record
+   *
+   * @return false at the end of the trace or on error, see Error()
+   */
+  bool Next(BinTraceRecord &record);
+
+  /**
+   * Get the next record retiring the instruction at |pc|
+   *
+   * Chunks which can't contain |pc| according to the index are skipped.
+   *
+   * @return false if there is no such record or on error, see Error()
+   */
+  bool NextPc(uint32_t pc, BinTraceRecord &record);
+
+ private:
+  FILE *file_;
+  std::string error_;
+  std::vector<BinTraceIndexEntry> index_;
+
+  // Next chunk to load and the decoded contents of the current chunk
+  size_t next_chunk_;
+  std::vector<uint8_t> raw_;
+  std::vector<uint8_t> compressed_;
+  const uint8_t *pos_;
+  uint32_t remaining_;
+
+  // A record read ahead by SeekCycle(), returned by the next call to Next()
+  bool has_pending_;
+  BinTraceRecord pending_;
+
+  // Decoder state of the current chunk
+  uint64_t prev_cycle_;
+  uint32_t prev_pc_;
+  uint32_t prev_insn_;
+  uint32_t prev_mem_addr_;
+  std::vector<uint32_t> dict_;
+
+  /**
+   * Read the index at the end of the file
+   */
+  bool ReadIndex();
+
+  /**
+   * Rebuild the index by walking the chunk headers
+   */
+  bool ScanChunks();
+
+  /**
+   * Read and decompress chunk |chunk|
+   */
+  bool LoadChunk(size_t chunk);
+
+  /**
+   * Decode the next record of the current chunk
+   */
+  bool Decode(BinTraceRecord &record);
+
+  /**
+   * Might chunk |chunk| contain |pc| according to the index?
+   */
+  bool ChunkMayContainPc(size_t chunk, uint32_t pc) const;
+};
+
+#endif  // IBEX_BIN_TRACE_READER_H_
@@ -0,0 +1,64 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Binary instruction trace for simulation
+ *
+ * Passes every instruction retired on RVFI to the C++ trace writer (see
+ * dv/verilator/bin_trace/cpp/ibex_bin_trace.h), which stores it in a compressed, indexed binary
+ * format. If the binary trace isn't enabled the module makes no DPI calls at all.
+ */
+module bin_trace (
+  input              clk_i,
+  input              rst_ni,
+
+  input              rvfi_valid_i,
+  input       [31:0] rvfi_pc_rdata_i,
+  input       [31:0] rvfi_insn_i,
+  input              rvfi_trap_i,
+  input              rvfi_intr_i,
+  input       [ 4:0] rvfi_rd_addr_i,
+  input       [31:0] rvfi_rd_wdata_i,
+  input       [31:0] rvfi_mem_addr_i,
+  input       [ 3:0] rvfi_mem_rmask_i,
+  input       [ 3:0] rvfi_mem_wmask_i,
+  input       [31:0] rvfi_mem_rdata_i,
+  input       [31:0] rvfi_mem_wdata_i
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit bin_trace_enabled();
+
+  import "DPI-C" function void bin_trace_retire(input bit [31:0] pc, input bit [31:0] insn,
+                                                input bit trap, input bit intr,
+                                                input bit [4:0] rd_addr,
+                                                input bit [31:0] rd_wdata,
+                                                input bit [31:0] mem_addr,
+                                                input bit [3:0] mem_rmask,
+                                                input bit [3:0] mem_wmask,
+                                                input bit [31:0] mem_rdata,
+                                                input bit [31:0] mem_wdata);
+`endif
+
+  logic enabled;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = bin_trace_enabled();
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (rst_ni && enabled && rvfi_valid_i) begin
+`ifdef VERILATOR
+      bin_trace_retire(rvfi_pc_rdata_i, rvfi_insn_i, rvfi_trap_i, rvfi_intr_i, rvfi_rd_addr_i,
+                       rvfi_rd_wdata_i, rvfi_mem_addr_i, rvfi_mem_rmask_i, rvfi_mem_wmask_i,
+                       rvfi_mem_rdata_i, rvfi_mem_wdata_i);
+`endif
+    end
+  end
+
+endmodule
@@ -0,0 +1,199 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Round trip test of the binary instruction trace: writes records with
+// IbexBinTrace, reads them back with IbexBinTraceReader and compares them
+// field by field. The chunks are kept small so the records cross several
+// chunk boundaries, where the encoder state and dictionary are reset.
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ibex_bin_trace.h"
+#include "ibex_bin_trace_reader.h"
+
+static const char kTraceFile[] = "ibex_bin_trace_test.bin";
+static const unsigned kChunkRecords = 16;
+static const unsigned kNumRecords = 3 * kChunkRecords + kChunkRecords / 2;
+
+static unsigned errors = 0;
+
+#define CHECK_EQ(actual, expected, what)                                  \
+  do {                                                                    \
+    if ((actual) != (expected)) {                                         \
+      std::cerr << "ERROR: " << what << ": got " << uint64_t(actual)      \
+                << ", expected " << uint64_t(expected) << std::endl;      \
+      errors++;                                                           \
+    }                                                                     \
+  } while (0)
+
+/**
+ * Generate records covering all fields of the encoding
+ *
+ * Fields which aren't stored (e.g. the write data of a record without a
+ * register write) are 0, as returned by the reader.
+ */
+static std::vector<BinTraceRecord> GenerateRecords() {
+  std::mt19937 rng(1);
+  std::vector<BinTraceRecord> records;
+  uint64_t cycle = 10;
+  uint32_t pc = 0x100080;
+  uint32_t insn = 0;
+
+  for (unsigned i = 0; i < kNumRecords; ++i) {
+    BinTraceRecord r = {};
+    cycle += 1 + rng() % 3;
+    r.cycle = cycle;
+
+    // Mostly sequential code, with backward and forward jumps. The
+    // instruction following the last one of a chunk is sequential as well,
+    // the PC must not be predicted across the chunk boundary.
+    if (i && rng() % 4 == 0) {
+      pc = rng() % 2 ? pc - 0x40 : pc + 0x1000;
+    } else if (i) {
+      pc = BinTraceNextPc(pc, insn);
+    }
+    r.pc = pc;
+
+    // Few distinct instruction words, so most are dictionary references.
+    // Compressed instructions only use the lower 16 bits.
+    static const uint32_t kInsns[] = {0x00000013, 0x00a50533, 0x4501,
+                                      0x0005a503, 0x00b52023, 0x8082};
+    insn = i % 7 == 0 ? 0x00100093 + (i << 20)
+                      : kInsns[rng() % (sizeof(kInsns) / sizeof(kInsns[0]))];
+    r.insn = insn;
+
+    if (rng() % 3) {
+      r.rd_addr = 1 + rng() % 31;
+      r.rd_wdata = i % 5 == 0 ? 0xffffffff : rng();
+    }
+
+    switch (rng() % 4) {
+      case 0:
+        r.mem_addr = 0x100000 + (rng() % 0x4000 & ~3u);
+        r.mem_rmask = 0xf;
+        r.mem_rdata = rng();
+        break;
+      case 1:
+        r.mem_addr = 0x20000 + (rng() % 0x100);
+        r.mem_wmask = 1 << (r.mem_addr & 3);
+        r.mem_wdata = rng() & 0xff;
+        break;
+      default:
+        break;
+    }
+
+    r.trap = i == 20;
+    r.intr = i == kChunkRecords;
+    records.push_back(r);
+  }
+
+  return records;
+}
+
+static void WriteTrace(const std::vector<BinTraceRecord> &records) {
+  IbexBinTrace trace("unused.bin");
+  std::string trace_arg = std::string("--bin-trace=") + kTraceFile;
+  std::string chunk_arg =
+      "--bin-trace-chunk=" + std::to_string(kChunkRecords);
+  char *argv[] = {const_cast<char *>("ibex_bin_trace_test"), &trace_arg[0],
+                  &chunk_arg[0], nullptr};
+  bool exit_app = false;
+  if (!trace.ParseCLIArguments(3, argv, exit_app) || exit_app) {
+    std::cerr << "ERROR: Parsing the trace arguments failed" << std::endl;
+    errors++;
+    return;
+  }
+
+  trace.PreExec();
+  for (const auto &r : records) {
+    trace.Retire(r);
+  }
+  trace.PostExec();
+}
+
+static void CompareRecord(const BinTraceRecord &actual,
+                          const BinTraceRecord &expected, size_t i) {
+  std::string what = "Record " + std::to_string(i) + " ";
+  CHECK_EQ(actual.cycle, expected.cycle, what + "cycle");
+  CHECK_EQ(actual.pc, expected.pc, what + "pc");
+  CHECK_EQ(actual.insn, expected.insn, what + "insn");
+  CHECK_EQ(actual.trap, expected.trap, what + "trap");
+  CHECK_EQ(actual.intr, expected.intr, what + "intr");
+  CHECK_EQ(actual.rd_addr, expected.rd_addr, what + "rd_addr");
+  CHECK_EQ(actual.rd_wdata, expected.rd_wdata, what + "rd_wdata");
+  CHECK_EQ(actual.mem_rmask, expected.mem_rmask, what + "mem_rmask");
+  CHECK_EQ(actual.mem_wmask, expected.mem_wmask, what + "mem_wmask");
+  CHECK_EQ(actual.mem_addr, expected.mem_addr, what + "mem_addr");
+  CHECK_EQ(actual.mem_rdata, expected.mem_rdata, what + "mem_rdata");
+  CHECK_EQ(actual.mem_wdata, expected.mem_wdata, what + "mem_wdata");
+}
+
+static void ReadTrace(const std::vector<BinTraceRecord> &records) {
+  IbexBinTraceReader reader;
+  if (!reader.Open(kTraceFile)) {
+    std::cerr << "ERROR: " << reader.Error() << std::endl;
+    errors++;
+    return;
+  }
+
+  // One index entry per chunk, the last one partially filled
+  const auto &index = reader.Index();
+  CHECK_EQ(index.size(), (kNumRecords + kChunkRecords - 1) / kChunkRecords,
+           "Number of chunks");
+  for (size_t c = 0; c < index.size(); ++c) {
+    size_t first = c * kChunkRecords;
+    size_t last = std::min<size_t>(first + kChunkRecords, kNumRecords) - 1;
+    std::string what = "Chunk " + std::to_string(c) + " ";
+    CHECK_EQ(index[c].num_records, last - first + 1, what + "num_records");
+    CHECK_EQ(index[c].first_cycle, records[first].cycle, what + "first_cycle");
+    CHECK_EQ(index[c].last_cycle, records[last].cycle, what + "last_cycle");
+  }
+
+  BinTraceRecord record;
+  size_t i = 0;
+  while (reader.Next(record)) {
+    if (i < records.size()) {
+      CompareRecord(record, records[i], i);
+    }
+    ++i;
+  }
+  if (!reader.Error().empty()) {
+    std::cerr << "ERROR: " << reader.Error() << std::endl;
+    errors++;
+  }
+  CHECK_EQ(i, records.size(), "Number of records");
+
+  // Seek to the first record of the second chunk, and into the third one
+  for (size_t target : {size_t(kChunkRecords), size_t(2 * kChunkRecords + 3)}) {
+    if (!reader.SeekCycle(records[target].cycle) || !reader.Next(record)) {
+      std::cerr << "ERROR: Seeking to record " << target << " failed"
+                << std::endl;
+      errors++;
+      continue;
+    }
+    CompareRecord(record, records[target], target);
+  }
+}
+
+int main(int argc, char **argv) {
+  std::vector<BinTraceRecord> records = GenerateRecords();
+
+  WriteTrace(records);
+  if (!errors) {
+    ReadTrace(records);
+  }
+  remove(kTraceFile);
+
+  if (errors) {
+    std::cout << "TEST FAILED (" << errors << " errors)" << std::endl;
+    return 1;
+  }
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
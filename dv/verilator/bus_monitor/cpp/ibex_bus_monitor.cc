@@ -0,0 +1,350 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_bus_monitor.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// The instance accessed by the DPI functions below
+static IbexBusMonitor *bus_monitor_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+svBit bus_monitor_enabled(int nr_hosts, int nr_devices) {
+  if (!bus_monitor_instance || !bus_monitor_instance->IsEnabled()) {
+    return 0;
+  }
+  bus_monitor_instance->Init(nr_hosts, nr_devices);
+  return 1;
+}
+
+void bus_monitor_tick(const svBitVecVal *host_req, const svBitVecVal *host_gnt,
+                      const svBitVecVal *host_rvalid,
+                      const svBitVecVal *device_req,
+                      const svBitVecVal *device_rvalid) {
+  assert(bus_monitor_instance);
+  bus_monitor_instance->Tick(host_req[0], host_gnt[0], host_rvalid[0],
+                             device_req[0], device_rvalid[0]);
+}
+}
+
+/**
+ * Account one cycle of a port
+ *
+ * Devices accept every request immediately, so |gnt| equals |req| for them.
+ */
+static inline void AccountPort(BusMonitorPort &port, bool req, bool gnt,
+                               bool rvalid) {
+  if (req && gnt) {
+    port.requests++;
+    port.window_reqs++;
+    port.max_gnt_wait = std::max(port.max_gnt_wait, port.gnt_wait);
+    port.gnt_wait = 0;
+    port.outstanding++;
+  } else if (req) {
+    port.gnt_wait++;
+    port.gnt_wait_cycles++;
+    port.window_wait_cycles++;
+  }
+  if (rvalid) {
+    port.responses++;
+    if (port.outstanding) {
+      port.outstanding--;
+    }
+  }
+  port.max_outstanding = std::max(port.max_outstanding, port.outstanding);
+  port.outstanding_sum += port.outstanding;
+}
+
+IbexBusMonitor::IbexBusMonitor(const std::string &series_filename)
+    : enabled_(false),
+      window_(10000),
+      series_enabled_(false),
+      series_filename_(series_filename),
+      series_file_(nullptr),
+      cycles_(0),
+      window_cycles_(0),
+      window_grants_(0),
+      peak_window_grants_(0) {
+  assert(!bus_monitor_instance &&
+         "Only one IbexBusMonitor instance is supported.");
+  bus_monitor_instance = this;
+}
+
+IbexBusMonitor::~IbexBusMonitor() {
+  PostExec();
+  bus_monitor_instance = nullptr;
+}
+
+void IbexBusMonitor::RegisterHost(int host, const std::string &name) {
+  if (static_cast<size_t>(host) >= hosts_.size()) {
+    ResizePorts(hosts_, host + 1, "Host");
+  }
+  hosts_[host].name = name;
+}
+
+void IbexBusMonitor::RegisterDevice(int device, const std::string &name) {
+  if (static_cast<size_t>(device) >= devices_.size()) {
+    ResizePorts(devices_, device + 1, "Device");
+  }
+  devices_[device].name = name;
+}
+
+void IbexBusMonitor::ResizePorts(std::vector<BusMonitorPort> &ports, int num,
+                                 const std::string &prefix) {
+  size_t old_size = ports.size();
+  ports.resize(num, BusMonitorPort());
+  for (size_t i = old_size; i < ports.size(); ++i) {
+    ports[i].name = prefix + " " + std::to_string(i);
+  }
+}
+
+bool IbexBusMonitor::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"bus-monitor", no_argument, nullptr, 'B'},
+      {"bus-monitor-window", required_argument, nullptr, 'W'},
+      {"bus-monitor-series", optional_argument, nullptr, 'S'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'B':
+        enabled_ = true;
+        break;
+      case 'W': {
+        char *end;
+        window_ = strtoull(optarg, &end, 0);
+        if (*end != '\0' || window_ == 0) {
+          std::cerr << "ERROR: Invalid bus-monitor-window: " << optarg
+                    << std::endl;
+          return false;
+        }
+      } break;
+      case 'S':
+        enabled_ = true;
+        series_enabled_ = true;
+        if (optarg) {
+          series_filename_ = optarg;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void IbexBusMonitor::PreExec() {
+  if (!series_enabled_) {
+    return;
+  }
+
+  series_file_ = fopen(series_filename_.c_str(), "w");
+  if (!series_file_) {
+    std::cerr << "ERROR: Could not open bus monitor time series "
+              << series_filename_ << std::endl;
+    return;
+  }
+
+  std::cout << "Writing bus monitor time series to " << series_filename_
+            << std::endl;
+}
+
+void IbexBusMonitor::PostExec() {
+  if (window_cycles_) {
+    EndWindow();
+  }
+  if (series_file_) {
+    fclose(series_file_);
+    series_file_ = nullptr;
+  }
+}
+
+void IbexBusMonitor::Init(int nr_hosts, int nr_devices) {
+  assert(nr_hosts <= 32 && nr_devices <= 32);
+  ResizePorts(hosts_, nr_hosts, "Host");
+  ResizePorts(devices_, nr_devices, "Device");
+
+  if (!series_file_) {
+    return;
+  }
+
+  // One line per window: the end cycle of the window, the utilisation and
+  // grant wait cycles of every host and the utilisation of every device
+  fprintf(series_file_, "Cycle");
+  for (const BusMonitorPort &host : hosts_) {
+    fprintf(series_file_, ",%s Utilisation,%s Grant Wait Cycles",
+            host.name.c_str(), host.name.c_str());
+  }
+  for (const BusMonitorPort &device : devices_) {
+    fprintf(series_file_, ",%s Utilisation", device.name.c_str());
+  }
+  fprintf(series_file_, "\n");
+}
+
+void IbexBusMonitor::Tick(uint32_t host_req, uint32_t host_gnt,
+                          uint32_t host_rvalid, uint32_t device_req,
+                          uint32_t device_rvalid) {
+  cycles_++;
+  window_cycles_++;
+  window_grants_ += __builtin_popcount(host_req & host_gnt);
+
+  // Idle ports need no accounting apart from their outstanding responses
+  for (size_t h = 0; h < hosts_.size(); ++h) {
+    BusMonitorPort &host = hosts_[h];
+    if (((host_req | host_rvalid) >> h) & 1) {
+      AccountPort(host, (host_req >> h) & 1, (host_gnt >> h) & 1,
+                  (host_rvalid >> h) & 1);
+    } else {
+      host.outstanding_sum += host.outstanding;
+    }
+  }
+
+  for (size_t d = 0; d < devices_.size(); ++d) {
+    BusMonitorPort &device = devices_[d];
+    if (((device_req | device_rvalid) >> d) & 1) {
+      bool req = (device_req >> d) & 1;
+      AccountPort(device, req, req, (device_rvalid >> d) & 1);
+    } else {
+      device.outstanding_sum += device.outstanding;
+    }
+  }
+
+  if (window_cycles_ == window_) {
+    EndWindow();
+  }
+}
+
+void IbexBusMonitor::EndWindow() {
+  peak_window_grants_ = std::max(peak_window_grants_, window_grants_);
+  window_grants_ = 0;
+
+  if (series_file_) {
+    fprintf(series_file_, "%llu", static_cast<unsigned long long>(cycles_));
+  }
+
+  for (BusMonitorPort &host : hosts_) {
+    host.peak_window_reqs = std::max(host.peak_window_reqs, host.window_reqs);
+    if (series_file_) {
+      fprintf(series_file_, ",%.3f,%llu",
+              static_cast<double>(host.window_reqs) / window_cycles_,
+              static_cast<unsigned long long>(host.window_wait_cycles));
+    }
+    host.window_reqs = 0;
+    host.window_wait_cycles = 0;
+  }
+
+  for (BusMonitorPort &device : devices_) {
+    device.peak_window_reqs =
+        std::max(device.peak_window_reqs, device.window_reqs);
+    if (series_file_) {
+      fprintf(series_file_, ",%.3f",
+              static_cast<double>(device.window_reqs) / window_cycles_);
+    }
+    device.window_reqs = 0;
+    device.window_wait_cycles = 0;
+  }
+
+  if (series_file_) {
+    fprintf(series_file_, "\n");
+  }
+  window_cycles_ = 0;
+}
+
+std::string IbexBusMonitor::ReportString(bool csv) const {
+  StatValues values;
+  auto ratio = [](uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / den : 0.0;
+  };
+
+  // Peak utilisation is relative to full windows, unless the whole simulation
+  // was shorter than one window
+  uint64_t window = std::min(window_, cycles_);
+
+  uint64_t grants = 0;
+  for (const BusMonitorPort &host : hosts_) {
+    grants += host.requests;
+  }
+
+  AddStat(values, "Bus Cycles", cycles_);
+  AddStatRatio(values, "Bus Utilisation", ratio(grants, cycles_));
+  AddStatRatio(values, "Bus Peak Window Utilisation",
+               ratio(peak_window_grants_, window));
+
+  for (const BusMonitorPort &host : hosts_) {
+    AddStat(values, host.name + " Requests", host.requests);
+    AddStat(values, host.name + " Grant Wait Cycles", host.gnt_wait_cycles);
+    AddStatRatio(values, host.name + " Grant Wait Cycles/Request",
+                 ratio(host.gnt_wait_cycles, host.requests));
+    AddStat(values, host.name + " Max Grant Wait", host.max_gnt_wait);
+    AddStat(values, host.name + " Max Outstanding", host.max_outstanding);
+    AddStatRatio(values, host.name + " Mean Outstanding",
+                 ratio(host.outstanding_sum, cycles_));
+    AddStatRatio(values, host.name + " Utilisation",
+                 ratio(host.requests, cycles_));
+    AddStatRatio(values, host.name + " Peak Window Utilisation",
+                 ratio(host.peak_window_reqs, window));
+  }
+
+  for (const BusMonitorPort &device : devices_) {
+    AddStat(values, device.name + " Requests", device.requests);
+    AddStat(values, device.name + " Responses", device.responses);
+    AddStat(values, device.name + " Max Outstanding", device.max_outstanding);
+    AddStatRatio(values, device.name + " Mean Outstanding",
+                 ratio(device.outstanding_sum, cycles_));
+    AddStatRatio(values, device.name + " Utilisation",
+                 ratio(device.requests, cycles_));
+    AddStatRatio(values, device.name + " Peak Window Utilisation",
+                 ratio(device.peak_window_reqs, window));
+  }
+
+  return FormatStats(values, csv);
+}
+
+void IbexBusMonitor::PrintHelp() const {
+  std::cout << "Bus monitor:\n\n"
+               "--bus-monitor\n"
+               "  Report requests, grant wait cycles, outstanding responses\n"
+               "  and utilisation of every bus host and device\n\n"
+               "--bus-monitor-window=CYCLES\n"
+               "  Length of the time windows for the peak utilisation and\n"
+               "  the time series (default: 10000)\n\n"
+               "--bus-monitor-series[=FILE]\n"
+               "  Write the utilisation and grant wait cycles of every time\n"
+               "  window to FILE as CSV (implies --bus-monitor)\n\n";
+}
@@ -0,0 +1,163 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_BUS_MONITOR_H_
+#define IBEX_BUS_MONITOR_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+// Statistics of one host or device port of the bus
+struct BusMonitorPort {
+  std::string name;
+  uint64_t requests;           // Granted requests
+  uint64_t responses;          // Responses received
+  uint64_t gnt_wait_cycles;    // Cycles a request waited for its grant
+  uint64_t max_gnt_wait;       // Longest wait of a request for its grant
+  uint64_t outstanding_sum;    // Sum of the outstanding responses per cycle
+  uint64_t max_outstanding;    // Most responses outstanding at once
+  uint64_t peak_window_reqs;   // Most requests granted in a time window
+  // State
+  uint64_t gnt_wait;           // Cycles the current request has waited
+  uint64_t outstanding;        // Responses currently outstanding
+  uint64_t window_reqs;        // Requests granted in the current window
+  uint64_t window_wait_cycles; // Grant wait cycles in the current window
+};
+
+/**
+ * Bus occupancy monitor for Verilator simulations
+ *
+ * Collects statistics of the traffic observed by one bus_monitor module (see
+ * rtl/bus_monitor.sv), for every host and device port of the bus:
+ *
+ * - Requests: requests granted to a host, and requests presented to a device
+ * - Grant wait cycles: cycles a host request waited for its grant, i.e. lost
+ *   the arbitration to another host
+ * - Outstanding responses: granted requests whose response has not arrived
+ *   yet, as maximum and mean over all cycles
+ * - Utilisation: requests per cycle over the whole simulation and the peak
+ *   over time windows of a fixed number of cycles
+ *
+ * A summary is reported at the end of the simulation, optionally the
+ * utilisation and grant wait cycles of every time window are written to a
+ * CSV file as a time series.
+ *
+ * The monitor is configured on the command line:
+ *
+ * --bus-monitor
+ *   Enable the monitor.
+ *
+ * --bus-monitor-window=CYCLES
+ *   Length of the time windows (default: 10000 cycles).
+ *
+ * --bus-monitor-series[=FILE]
+ *   Write the time series to FILE (or the default file name). Enables the
+ *   monitor.
+ */
+class IbexBusMonitor : public SimCtrlExtension {
+ public:
+  /**
+   * @param series_filename Default name of the time series file
+   */
+  IbexBusMonitor(const std::string &series_filename);
+  ~IbexBusMonitor();
+
+  /**
+   * Name a host port in the report
+   *
+   * @param host Index of the host on the bus
+   */
+  void RegisterHost(int host, const std::string &name);
+
+  /**
+   * Name a device port in the report
+   *
+   * @param device Index of the device on the bus
+   */
+  void RegisterDevice(int device, const std::string &name);
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Open the time series file
+   */
+  virtual void PreExec();
+
+  /**
+   * Finish the last time window and close the time series file
+   */
+  virtual void PostExec();
+
+  /**
+   * Has the monitor been enabled on the command line?
+   */
+  bool IsEnabled() const { return enabled_; }
+
+  /**
+   * Set the number of hosts and devices of the bus
+   */
+  void Init(int nr_hosts, int nr_devices);
+
+  /**
+   * Account the handshake signals of one cycle, one bit per host or device
+   */
+  void Tick(uint32_t host_req, uint32_t host_gnt, uint32_t host_rvalid,
+            uint32_t device_req, uint32_t device_rvalid);
+
+  /**
+   * Returns a formatted string of the bus statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  bool enabled_;
+  uint64_t window_;
+  bool series_enabled_;
+  std::string series_filename_;
+  FILE *series_file_;
+
+  std::vector<BusMonitorPort> hosts_;
+  std::vector<BusMonitorPort> devices_;
+
+  uint64_t cycles_;
+  uint64_t window_cycles_;
+  // Requests granted to any host in the current window, and the most granted
+  // in any window
+  uint64_t window_grants_;
+  uint64_t peak_window_grants_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Resize |ports| to |num|, naming unnamed ports |prefix| <index>
+   */
+  static void ResizePorts(std::vector<BusMonitorPort> &ports, int num,
+                          const std::string &prefix);
+
+  /**
+   * Update the statistics of the current time window and start a new one
+   */
+  void EndWindow();
+};
+
+#endif  // IBEX_BUS_MONITOR_H_
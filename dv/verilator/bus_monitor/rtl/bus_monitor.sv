@@ -0,0 +1,79 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Bus occupancy monitor for simulation
+ *
+ * Observes the host and device ports of a bus (see shared/rtl/bus.sv) and passes their handshake
+ * signals to the C++ model (see dv/verilator/bus_monitor/cpp/ibex_bus_monitor.h) once per cycle,
+ * which counts requests, grants, grant wait cycles and outstanding responses per host and device.
+ *
+ * If the monitor isn't enabled on the command line of the simulation it makes no DPI calls at all.
+ */
+module bus_monitor #(
+  // At most 32 hosts and devices are supported
+  parameter int NrHosts   = 1,
+  parameter int NrDevices = 1
+) (
+  input clk_i,
+  input rst_ni,
+
+  input host_req_i      [NrHosts],
+  input host_gnt_i      [NrHosts],
+  input host_rvalid_i   [NrHosts],
+
+  input device_req_i    [NrDevices],
+  input device_rvalid_i [NrDevices]
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit bus_monitor_enabled(input int nr_hosts, input int nr_devices);
+
+  import "DPI-C" function void bus_monitor_tick(input bit [31:0] host_req,
+                                                input bit [31:0] host_gnt,
+                                                input bit [31:0] host_rvalid,
+                                                input bit [31:0] device_req,
+                                                input bit [31:0] device_rvalid);
+`endif
+
+  logic enabled;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = bus_monitor_enabled(NrHosts, NrDevices);
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  bit [31:0] host_req, host_gnt, host_rvalid;
+  bit [31:0] device_req, device_rvalid;
+
+  always_comb begin
+    host_req = '0;
+    host_gnt = '0;
+    host_rvalid = '0;
+    for (int h = 0; h < NrHosts; h++) begin
+      host_req[h] = host_req_i[h];
+      host_gnt[h] = host_gnt_i[h];
+      host_rvalid[h] = host_rvalid_i[h];
+    end
+
+    device_req = '0;
+    device_rvalid = '0;
+    for (int d = 0; d < NrDevices; d++) begin
+      device_req[d] = device_req_i[d];
+      device_rvalid[d] = device_rvalid_i[d];
+    end
+  end
+
+  always_ff @(posedge clk_i) begin
+    if (rst_ni && enabled) begin
+`ifdef VERILATOR
+      bus_monitor_tick(host_req, host_gnt, host_rvalid, device_req, device_rvalid);
+`endif
+    end
+  end
+
+endmodule
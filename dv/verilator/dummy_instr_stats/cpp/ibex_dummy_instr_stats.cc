@@ -0,0 +1,184 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_dummy_instr_stats.h"
+
+#include <getopt.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// Fields of the cpuctrl CSR, see cpu_ctrl_t in ibex_cs_registers.sv
+static const uint32_t kCpuctrlDummyInstrEn = 1 << 2;
+static const int kCpuctrlDummyInstrMaskShift = 3;
+
+// The instance accessed by the DPI functions below
+static IbexDummyInstrStats *dummy_instr_stats_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+svBit dummy_instr_monitor_enabled() {
+  return dummy_instr_stats_instance && dummy_instr_stats_instance->IsEnabled();
+}
+
+int dummy_instr_monitor_cpuctrl() {
+  return dummy_instr_stats_instance ? dummy_instr_stats_instance->Cpuctrl()
+                                    : 0;
+}
+
+void dummy_instr_monitor_tick(svBit dummy_instr_en, int dummy_instr_mask,
+                              svBit instr_ret, svBit dummy_instr_id) {
+  assert(dummy_instr_stats_instance);
+  dummy_instr_stats_instance->Tick(dummy_instr_en, dummy_instr_mask, instr_ret,
+                                   dummy_instr_id);
+}
+}
+
+IbexDummyInstrStats::IbexDummyInstrStats()
+    : enabled_(false), cpuctrl_(0), bins_(kNumBins, DummyInstrBin{0, 0, 0, 0}) {
+  assert(!dummy_instr_stats_instance &&
+         "Only one IbexDummyInstrStats instance is supported.");
+  dummy_instr_stats_instance = this;
+}
+
+IbexDummyInstrStats::~IbexDummyInstrStats() {
+  dummy_instr_stats_instance = nullptr;
+}
+
+bool IbexDummyInstrStats::ParseCLIArguments(int argc, char **argv,
+                                            bool &exit_app) {
+  const struct option long_options[] = {
+      {"dummy-instr-stats", no_argument, nullptr, 'D'},
+      {"dummy-instr", required_argument, nullptr, 'M'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'D':
+        enabled_ = true;
+        break;
+      case 'M': {
+        enabled_ = true;
+        startup_config_ = optarg;
+        if (!strcmp(optarg, "off")) {
+          cpuctrl_ = 0;
+          break;
+        }
+        char *end;
+        long mask = strtol(optarg, &end, 0);
+        if (*end != '\0' || mask < 0 || mask > 7) {
+          std::cerr << "ERROR: Invalid dummy-instr: " << optarg << std::endl;
+          return false;
+        }
+        cpuctrl_ = kCpuctrlDummyInstrEn |
+                   (static_cast<uint32_t>(mask) << kCpuctrlDummyInstrMaskShift);
+      } break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void IbexDummyInstrStats::Tick(bool dummy_instr_en, int dummy_instr_mask,
+                               bool instr_ret, bool dummy_instr_id) {
+  DummyInstrBin &bin = bins_[dummy_instr_en ? 1 + (dummy_instr_mask & 7) : 0];
+  bin.cycles++;
+  if (instr_ret) {
+    bin.instrs++;
+  }
+  if (dummy_instr_id) {
+    bin.dummy_cycles++;
+    if (instr_ret) {
+      bin.dummy_instrs++;
+    }
+  }
+}
+
+std::string IbexDummyInstrStats::ReportString(bool csv) const {
+  StatValues values;
+  auto ratio = [](uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / den : 0.0;
+  };
+  auto add_bin = [&](const std::string &prefix, const DummyInstrBin &bin) {
+    uint64_t real_instrs = bin.instrs - bin.dummy_instrs;
+    AddStat(values, prefix + "Cycles", bin.cycles);
+    AddStat(values, prefix + "Dummy Instructions", bin.dummy_instrs);
+    AddStat(values, prefix + "Dummy Instruction Cycles", bin.dummy_cycles);
+    AddStat(values, prefix + "Real Instructions", real_instrs);
+    AddStatRatio(values, prefix + "Cycles/Real Instruction",
+                 ratio(bin.cycles, real_instrs));
+    AddStatRatio(values, prefix + "Dummy Instructions/Real Instruction",
+                 ratio(bin.dummy_instrs, real_instrs));
+    AddStatRatio(values, prefix + "Dummy Cycles/Real Instruction",
+                 ratio(bin.dummy_cycles, real_instrs));
+  };
+
+  DummyInstrBin total{0, 0, 0, 0};
+  for (const DummyInstrBin &bin : bins_) {
+    total.cycles += bin.cycles;
+    total.instrs += bin.instrs;
+    total.dummy_instrs += bin.dummy_instrs;
+    total.dummy_cycles += bin.dummy_cycles;
+  }
+
+  if (!startup_config_.empty()) {
+    values.emplace_back("Startup Dummy Instr Config", startup_config_);
+  }
+  add_bin("Total ", total);
+
+  // Only configurations used by software
+  for (int i = 0; i < kNumBins; ++i) {
+    if (!bins_[i].cycles) {
+      continue;
+    }
+    std::string prefix =
+        i ? "Mask " + std::to_string(i - 1) + " " : "Disabled ";
+    add_bin(prefix, bins_[i]);
+  }
+
+  return FormatStats(values, csv);
+}
+
+void IbexDummyInstrStats::PrintHelp() const {
+  std::cout << "Dummy instruction statistics:\n\n"
+               "--dummy-instr-stats\n"
+               "  Report the dummy instructions inserted by SecureIbex and\n"
+               "  the cycles they take, per dummy instruction configuration\n\n"
+               "--dummy-instr=off|MASK\n"
+               "  Make software enable dummy instructions with cpuctrl\n"
+               "  dummy_instr_mask MASK (0-7) at startup (implies\n"
+               "  --dummy-instr-stats)\n\n";
+}
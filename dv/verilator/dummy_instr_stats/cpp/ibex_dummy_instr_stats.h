@@ -0,0 +1,102 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_DUMMY_INSTR_STATS_H_
+#define IBEX_DUMMY_INSTR_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+// Statistics of the cycles spent with one dummy instruction configuration
+struct DummyInstrBin {
+  uint64_t cycles;
+  uint64_t instrs;        // Retired instructions, including dummies
+  uint64_t dummy_instrs;  // Retired dummy instructions
+  uint64_t dummy_cycles;  // Cycles the ID stage held a dummy instruction
+};
+
+/**
+ * Dummy instruction overhead statistics for Verilator simulations
+ *
+ * With SecureIbex, software can make the core insert dummy instructions at a
+ * pseudo-random rate by setting cpuctrl.dummy_instr_en. The frequency is
+ * selected by cpuctrl.dummy_instr_mask: the larger the mask, the longer the
+ * intervals between dummy instructions (up to 32 instructions with a mask of
+ * 7).
+ *
+ * This class counts the dummy instructions and the cycles they occupy the
+ * ID/EX stage, from one dummy_instr_monitor module (see
+ * rtl/dummy_instr_monitor.sv), broken down by the dummy instruction
+ * configuration at the time. Dummy instructions are counted by minstret, so
+ * they are subtracted to get the cycles per real instruction.
+ *
+ * The statistics are configured on the command line:
+ *
+ * --dummy-instr-stats
+ *   Enable the statistics.
+ *
+ * --dummy-instr=off|MASK
+ *   Make software enable dummy instructions with the given mask at startup
+ *   (through simulator_ctrl and crt0). Enables the statistics.
+ */
+class IbexDummyInstrStats : public SimCtrlExtension {
+ public:
+  IbexDummyInstrStats();
+  ~IbexDummyInstrStats();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Have the statistics been enabled on the command line?
+   */
+  bool IsEnabled() const { return enabled_; }
+
+  /**
+   * Bits software should set in cpuctrl at startup
+   */
+  uint32_t Cpuctrl() const { return cpuctrl_; }
+
+  /**
+   * Account one cycle
+   */
+  void Tick(bool dummy_instr_en, int dummy_instr_mask, bool instr_ret,
+            bool dummy_instr_id);
+
+  /**
+   * Returns a formatted string of the dummy instruction statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  // Bin 0 holds the cycles with dummy instructions disabled, bin 1 + MASK
+  // those with dummy_instr_mask MASK
+  static const int kNumBins = 9;
+
+  bool enabled_;
+  uint32_t cpuctrl_;
+  std::string startup_config_;  // Argument of --dummy-instr
+  std::vector<DummyInstrBin> bins_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+};
+
+#endif  // IBEX_DUMMY_INSTR_STATS_H_
@@ -0,0 +1,63 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Dummy instruction monitor for simulation
+ *
+ * Passes the dummy instruction configuration of the cpuctrl CSR, retired instructions and the
+ * cycles spent on dummy instructions (see ibex_dummy_instr.sv) to the C++ model (see
+ * dv/verilator/dummy_instr_stats/cpp/ibex_dummy_instr_stats.h) once per cycle.
+ *
+ * The C++ model also provides the cpuctrl bits software should set at startup (cpuctrl_o), which
+ * are read through simulator_ctrl, so a workload can be run at every dummy instruction frequency
+ * without changing it.
+ *
+ * If the statistics aren't enabled on the command line of the simulation it makes no DPI calls
+ * apart from the ones at startup.
+ */
+module dummy_instr_monitor (
+  input               clk_i,
+  input               rst_ni,
+
+  input               dummy_instr_en_i,    // cpuctrl.dummy_instr_en
+  input        [2:0]  dummy_instr_mask_i,  // cpuctrl.dummy_instr_mask
+  input               instr_ret_i,         // Instruction (including dummies) retired
+  input               dummy_instr_id_i,    // ID stage holds a dummy instruction
+
+  output logic [31:0] cpuctrl_o
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit dummy_instr_monitor_enabled();
+
+  import "DPI-C" function int dummy_instr_monitor_cpuctrl();
+
+  import "DPI-C" function void dummy_instr_monitor_tick(input bit dummy_instr_en,
+                                                        input int dummy_instr_mask,
+                                                        input bit instr_ret,
+                                                        input bit dummy_instr_id);
+`endif
+
+  logic enabled;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = dummy_instr_monitor_enabled();
+    cpuctrl_o = dummy_instr_monitor_cpuctrl();
+`else
+    enabled = 1'b0;
+    cpuctrl_o = '0;
+`endif
+  end
+
+  always_ff @(posedge clk_i) begin
+    if (rst_ni && enabled) begin
+`ifdef VERILATOR
+      dummy_instr_monitor_tick(dummy_instr_en_i, int'(dummy_instr_mask_i), instr_ret_i,
+                               dummy_instr_id_i);
+`endif
+    end
+  end
+
+endmodule
@@ -0,0 +1,199 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_energy.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// The instance accessed by the DPI functions below
+static IbexEnergy *energy_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+svBit energy_monitor_enabled(int nr_nets) {
+  if (!energy_instance || !energy_instance->IsEnabled()) {
+    return 0;
+  }
+  energy_instance->Init(nr_nets);
+  return 1;
+}
+
+void energy_monitor_tick(const svBitVecVal *toggles) {
+  assert(energy_instance);
+  energy_instance->Tick(toggles);
+}
+}
+
+IbexEnergy::IbexEnergy() : enabled_(false), cycle_weight_(0.0), cycles_(0) {
+  assert(!energy_instance && "Only one IbexEnergy instance is supported.");
+  energy_instance = this;
+}
+
+IbexEnergy::~IbexEnergy() { energy_instance = nullptr; }
+
+void IbexEnergy::RegisterNet(int net, const std::string &key,
+                             const std::string &name) {
+  if (static_cast<size_t>(net) >= nets_.size()) {
+    nets_.resize(net + 1, EnergyNet{"", "", 1.0, 0});
+  }
+  nets_[net].key = key;
+  nets_[net].name = name;
+}
+
+bool IbexEnergy::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"energy", no_argument, nullptr, 'E'},
+      {"energy-weight", required_argument, nullptr, 'W'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'E':
+        enabled_ = true;
+        break;
+      case 'W':
+        enabled_ = true;
+        if (!ParseWeights(optarg)) {
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return ApplyWeights();
+}
+
+bool IbexEnergy::ParseWeights(const std::string &weights) {
+  std::stringstream weights_ss(weights);
+  std::string pair;
+  while (std::getline(weights_ss, pair, ',')) {
+    std::string::size_type eq = pair.find('=');
+    char *end = nullptr;
+    double weight = 0.0;
+    if (eq != std::string::npos) {
+      weight = strtod(pair.c_str() + eq + 1, &end);
+    }
+    if (eq == std::string::npos || eq == 0 || end == pair.c_str() + eq + 1 ||
+        *end != '\0' || weight < 0.0) {
+      std::cerr << "ERROR: Invalid energy weight: " << pair << std::endl;
+      return false;
+    }
+    cli_weights_.emplace_back(pair.substr(0, eq), weight);
+  }
+  return true;
+}
+
+bool IbexEnergy::ApplyWeights() {
+  for (const auto &key_weight : cli_weights_) {
+    if (key_weight.first == "cycle") {
+      cycle_weight_ = key_weight.second;
+      continue;
+    }
+
+    auto net = std::find_if(nets_.begin(), nets_.end(),
+                            [&key_weight](const EnergyNet &n) {
+                              return n.key == key_weight.first;
+                            });
+    if (net == nets_.end()) {
+      std::cerr << "ERROR: Unknown net in energy weight: " << key_weight.first
+                << std::endl;
+      return false;
+    }
+    net->weight = key_weight.second;
+  }
+  cli_weights_.clear();
+
+  return true;
+}
+
+void IbexEnergy::Init(int nr_nets) {
+  size_t old_size = nets_.size();
+  nets_.resize(nr_nets, EnergyNet{"", "", 1.0, 0});
+  for (size_t i = old_size; i < nets_.size(); ++i) {
+    nets_[i].key = "net" + std::to_string(i);
+    nets_[i].name = "Net " + std::to_string(i);
+  }
+}
+
+void IbexEnergy::Tick(const uint32_t *toggles) {
+  cycles_++;
+  for (size_t n = 0; n < nets_.size(); ++n) {
+    nets_[n].toggles += (toggles[n / 2] >> ((n % 2) * 16)) & 0xffff;
+  }
+}
+
+double IbexEnergy::Energy() const {
+  double energy = cycles_ * cycle_weight_;
+  for (const EnergyNet &net : nets_) {
+    energy += net.toggles * net.weight;
+  }
+  return energy;
+}
+
+std::string IbexEnergy::ReportString(bool csv) const {
+  StatValues values;
+
+  double energy = Energy();
+
+  AddStat(values, "Energy Cycles", cycles_);
+  for (const EnergyNet &net : nets_) {
+    AddStat(values, net.name + " Toggles", net.toggles);
+    AddStatRatio(values, net.name + " Energy", net.toggles * net.weight);
+  }
+  AddStatRatio(values, "Cycle Energy", cycles_ * cycle_weight_);
+  AddStatRatio(values, "Total Energy", energy);
+  AddStatRatio(values, "Energy/Cycle", cycles_ ? energy / cycles_ : 0.0);
+
+  return FormatStats(values, csv);
+}
+
+void IbexEnergy::PrintHelp() const {
+  std::cout << "Energy estimation:\n\n"
+               "--energy\n"
+               "  Count the toggling bits of key nets of the core and\n"
+               "  estimate the dynamic energy from them\n\n"
+               "--energy-weight=KEY=WEIGHT[,KEY=WEIGHT...]\n"
+               "  Energy per toggling bit of the net KEY, or per cycle for\n"
+               "  KEY cycle (default: 1 per toggle, 0 per cycle). Nets:\n";
+  for (const EnergyNet &net : nets_) {
+    std::cout << "    " << net.key << ": " << net.name << "\n";
+  }
+  std::cout << "\n";
+}
@@ -0,0 +1,124 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_ENERGY_H_
+#define IBEX_ENERGY_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+struct EnergyNet {
+  std::string key;   // Identifies the net in --energy-weight
+  std::string name;  // Name of the net in the report
+  double weight;     // Energy per toggling bit
+  uint64_t toggles;  // Toggling bits over the whole simulation
+};
+
+/**
+ * Switching activity based energy estimation for Verilator simulations
+ *
+ * Counts the toggling bits of the nets observed by one energy_monitor module
+ * (see rtl/energy_monitor.sv) in every cycle, and estimates the dynamic
+ * energy as the sum of the toggles of every net multiplied with its energy per
+ * toggle, plus a fixed energy per cycle (e.g. for the clock tree).
+ *
+ * The weights have no unit, they can be given e.g. in pJ as obtained from a
+ * power analysis of the synthesized core. By default every toggle has a
+ * weight of 1 and cycles have no weight, so the estimate is the number of
+ * toggling bits. Only relative numbers are meaningful then, e.g. to compare
+ * configurations of the core running the same workload.
+ *
+ * The estimate is configured on the command line:
+ *
+ * --energy
+ *   Enable the estimation.
+ *
+ * --energy-weight=KEY=WEIGHT[,KEY=WEIGHT...]
+ *   Set the energy per toggle of the net KEY, or per cycle for the key
+ *   "cycle". Can be given multiple times. Enables the estimation.
+ */
+class IbexEnergy : public SimCtrlExtension {
+ public:
+  IbexEnergy();
+  ~IbexEnergy();
+
+  /**
+   * Name a net of the energy_monitor module
+   *
+   * @param net Index of the net in the net_i input of energy_monitor
+   * @param key Short name of the net on the command line
+   * @param name Name of the net in the report
+   */
+  void RegisterNet(int net, const std::string &key, const std::string &name);
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Has the estimation been enabled on the command line?
+   */
+  bool IsEnabled() const { return enabled_; }
+
+  /**
+   * Set the number of nets observed by the RTL
+   */
+  void Init(int nr_nets);
+
+  /**
+   * Account the toggle counts of one cycle
+   *
+   * @param toggles One 16 bit count per net, two per 32 bit word
+   */
+  void Tick(const uint32_t *toggles);
+
+  /**
+   * Estimated energy since the start of the simulation
+   */
+  double Energy() const;
+
+  /**
+   * Returns a formatted string of the toggles and energy of every net
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  bool enabled_;
+  double cycle_weight_;
+  uint64_t cycles_;
+  std::vector<EnergyNet> nets_;
+  // Weights given on the command line, applied once the nets are known
+  std::vector<std::pair<std::string, double>> cli_weights_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Parse a comma separated list of KEY=WEIGHT pairs into cli_weights_
+   */
+  bool ParseWeights(const std::string &weights);
+
+  /**
+   * Apply the weights given on the command line to the registered nets
+   */
+  bool ApplyWeights();
+};
+
+#endif  // IBEX_ENERGY_H_
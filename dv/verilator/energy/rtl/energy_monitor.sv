@@ -0,0 +1,63 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Switching activity monitor for simulation
+ *
+ * Counts the bits of every net (group of signals) which toggle from one cycle to the next, and
+ * passes the counts to the C++ model (see dv/verilator/energy/cpp/ibex_energy.h) once per cycle,
+ * which weights them to estimate the dynamic energy. Nets narrower than NetWidth must be padded
+ * with constant bits.
+ *
+ * If the monitor isn't enabled on the command line of the simulation it makes no DPI calls at all.
+ */
+module energy_monitor #(
+  parameter int NrNets   = 1,
+  // At most 65535 bits per net are supported
+  parameter int NetWidth = 32
+) (
+  input                clk_i,
+  input                rst_ni,
+
+  input [NetWidth-1:0] net_i [NrNets]
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit energy_monitor_enabled(input int nr_nets);
+
+  // One 16 bit toggle count per net, net 0 in the least significant bits
+  import "DPI-C" function void energy_monitor_tick(input bit [NrNets*16-1:0] toggles);
+`endif
+
+  logic enabled;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = energy_monitor_enabled(NrNets);
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  logic [NetWidth-1:0] net_q [NrNets];
+  bit [NrNets*16-1:0]  toggles;
+
+  always_comb begin
+    for (int n = 0; n < NrNets; n++) begin
+      toggles[n*16 +: 16] = 16'($countones(net_i[n] ^ net_q[n]));
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      net_q <= '{default: '0};
+    end else if (enabled) begin
+      net_q <= net_i;
+`ifdef VERILATOR
+      energy_monitor_tick(toggles);
+`endif
+    end
+  end
+
+endmodule
@@ -0,0 +1,206 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_fetch_monitor.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// The instance accessed by the DPI functions below
+static IbexFetchMonitor *fetch_monitor_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+svBit fetch_monitor_enabled(int max_outstanding, int fifo_depth) {
+  if (!fetch_monitor_instance || !fetch_monitor_instance->IsEnabled()) {
+    return 0;
+  }
+  fetch_monitor_instance->Init(max_outstanding, fifo_depth);
+  return 1;
+}
+
+void fetch_monitor_tick(int outstanding, int fifo_occupancy,
+                        svBit fetch_valid, svBit id_starved,
+                        svBit core_sleep) {
+  assert(fetch_monitor_instance);
+  fetch_monitor_instance->Tick(outstanding, fifo_occupancy, fetch_valid,
+                               id_starved, core_sleep);
+}
+}
+
+IbexFetchMonitor::IbexFetchMonitor()
+    : enabled_(false),
+      max_outstanding_(0),
+      cycles_(0),
+      sleep_cycles_(0),
+      starved_cycles_(0),
+      starved_fifo_empty_cycles_(0),
+      starved_at_limit_cycles_(0) {
+  assert(!fetch_monitor_instance &&
+         "Only one IbexFetchMonitor instance is supported.");
+  fetch_monitor_instance = this;
+}
+
+IbexFetchMonitor::~IbexFetchMonitor() { fetch_monitor_instance = nullptr; }
+
+bool IbexFetchMonitor::ParseCLIArguments(int argc, char **argv,
+                                         bool &exit_app) {
+  const struct option long_options[] = {
+      {"fetch-monitor", no_argument, nullptr, 'F'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'F':
+        enabled_ = true;
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+void IbexFetchMonitor::Init(int max_outstanding, int fifo_depth) {
+  max_outstanding_ = max_outstanding;
+  if (max_outstanding) {
+    outstanding_hist_.assign(max_outstanding + 1, 0);
+    starved_outstanding_hist_.assign(max_outstanding + 1, 0);
+  }
+  if (fifo_depth) {
+    fifo_hist_.assign(fifo_depth + 1, 0);
+  }
+}
+
+void IbexFetchMonitor::Tick(int outstanding, int fifo_occupancy,
+                            bool fetch_valid, bool id_starved,
+                            bool core_sleep) {
+  cycles_++;
+  if (core_sleep) {
+    sleep_cycles_++;
+    return;
+  }
+
+  if (!outstanding_hist_.empty()) {
+    outstanding = std::min(outstanding, max_outstanding_);
+    outstanding_hist_[outstanding]++;
+  }
+  if (!fifo_hist_.empty()) {
+    fifo_occupancy =
+        std::min(fifo_occupancy, static_cast<int>(fifo_hist_.size()) - 1);
+    fifo_hist_[fifo_occupancy]++;
+  }
+
+  if (!id_starved) {
+    return;
+  }
+  starved_cycles_++;
+
+  if (fetch_valid) {
+    return;
+  }
+  starved_fifo_empty_cycles_++;
+  if (!starved_outstanding_hist_.empty()) {
+    starved_outstanding_hist_[outstanding]++;
+    if (outstanding == max_outstanding_) {
+      starved_at_limit_cycles_++;
+    }
+  }
+}
+
+std::string IbexFetchMonitor::ReportString(bool csv) const {
+  StatValues values;
+  auto ratio = [](uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / den : 0.0;
+  };
+
+  uint64_t active_cycles = cycles_ - sleep_cycles_;
+
+  // One line per bin, with the share of the active cycles when pretty-printed
+  auto add_hist = [&](const std::string &name,
+                      const std::vector<uint64_t> &hist) {
+    for (size_t i = 0; i < hist.size(); ++i) {
+      std::ostringstream value_ss;
+      value_ss << hist[i];
+      if (!csv) {
+        value_ss << " (" << std::fixed << std::setprecision(1)
+                 << 100.0 * ratio(hist[i], active_cycles) << "%)";
+      }
+      values.emplace_back(name + " " + std::to_string(i), value_ss.str());
+    }
+  };
+  auto mean = [&](const std::vector<uint64_t> &hist) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < hist.size(); ++i) {
+      sum += i * hist[i];
+    }
+    return ratio(sum, active_cycles);
+  };
+
+  AddStat(values, "Fetch Cycles", cycles_);
+  AddStat(values, "Fetch Sleep Cycles", sleep_cycles_);
+  AddStat(values, "Front-End Bound Cycles", starved_cycles_);
+  AddStatRatio(values, "Front-End Bound %",
+               100.0 * ratio(starved_cycles_, active_cycles));
+  AddStat(values, "Front-End Bound Cycles FIFO Empty",
+          starved_fifo_empty_cycles_);
+  if (!starved_outstanding_hist_.empty()) {
+    AddStat(values, "Front-End Bound Cycles At Request Limit",
+            starved_at_limit_cycles_);
+    AddStatRatio(values, "Front-End Bound At Request Limit %",
+                 100.0 * ratio(starved_at_limit_cycles_, active_cycles));
+    AddStatRatio(values, "Mean Outstanding Requests", mean(outstanding_hist_));
+  }
+  if (!fifo_hist_.empty()) {
+    AddStatRatio(values, "Mean FIFO Occupancy", mean(fifo_hist_));
+  }
+
+  add_hist("Outstanding Requests", outstanding_hist_);
+  add_hist("FIFO Occupancy", fifo_hist_);
+  add_hist("Front-End Bound Outstanding Requests", starved_outstanding_hist_);
+
+  return FormatStats(values, csv);
+}
+
+void IbexFetchMonitor::PrintHelp() const {
+  std::cout << "Fetch monitor:\n\n"
+               "--fetch-monitor\n"
+               "  Report histograms of the outstanding fetch requests and the\n"
+               "  fetch FIFO occupancy, and the cycles the core was bound by\n"
+               "  instruction fetch\n\n";
+}
@@ -0,0 +1,97 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_FETCH_MONITOR_H_
+#define IBEX_FETCH_MONITOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+/**
+ * Instruction fetch occupancy monitor for Verilator simulations
+ *
+ * Collects statistics of the front end of the core from one fetch_monitor
+ * module (see rtl/fetch_monitor.sv) in every cycle the core isn't sleeping:
+ *
+ * - Histograms of the outstanding fetch requests of the prefetch buffer and
+ *   of the occupancy of the fetch FIFO (in 32 bit entries)
+ * - Front-end bound cycles: the ID stage is ready for an instruction but has
+ *   none (the "Fetch Wait" performance counter), and the subset of them in
+ *   which the fetch FIFO was empty as well
+ * - Of the cycles starved with an empty FIFO, a histogram of the outstanding
+ *   requests and the number of cycles with the maximum number of requests
+ *   outstanding. A deeper prefetch buffer can only help in the latter, in the
+ *   others the front end waits for branches or for grants.
+ *
+ * The monitor is enabled with --fetch-monitor on the command line.
+ */
+class IbexFetchMonitor : public SimCtrlExtension {
+ public:
+  IbexFetchMonitor();
+  ~IbexFetchMonitor();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Has the monitor been enabled on the command line?
+   */
+  bool IsEnabled() const { return enabled_; }
+
+  /**
+   * Set the size of the fetch unit, 0 if it doesn't provide the occupancy
+   */
+  void Init(int max_outstanding, int fifo_depth);
+
+  /**
+   * Account one cycle
+   */
+  void Tick(int outstanding, int fifo_occupancy, bool fetch_valid,
+            bool id_starved, bool core_sleep);
+
+  /**
+   * Returns a formatted string of the fetch statistics
+   *
+   * The pretty-print format adds the share of all cycles to the histogram
+   * bins.
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  bool enabled_;
+  int max_outstanding_;
+
+  uint64_t cycles_;
+  uint64_t sleep_cycles_;
+  uint64_t starved_cycles_;
+  uint64_t starved_fifo_empty_cycles_;
+  uint64_t starved_at_limit_cycles_;
+
+  // Cycles by number of outstanding requests / valid FIFO entries
+  std::vector<uint64_t> outstanding_hist_;
+  std::vector<uint64_t> fifo_hist_;
+  // Cycles starved with an empty FIFO by number of outstanding requests
+  std::vector<uint64_t> starved_outstanding_hist_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+};
+
+#endif  // IBEX_FETCH_MONITOR_H_
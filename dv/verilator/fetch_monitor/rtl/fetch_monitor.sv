@@ -0,0 +1,59 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Instruction fetch occupancy monitor for simulation
+ *
+ * Passes the number of outstanding instruction fetch requests, the occupancy of the fetch FIFO
+ * and whether the ID stage was starved of instructions to the C++ model (see
+ * dv/verilator/fetch_monitor/cpp/ibex_fetch_monitor.h) once per cycle, which builds histograms of
+ * them and determines how often the core is bound by its front end.
+ *
+ * If the monitor isn't enabled on the command line of the simulation it makes no DPI calls at all.
+ */
+module fetch_monitor #(
+  // Maximum number of outstanding fetch requests and entries of the fetch FIFO, 0 if the fetch
+  // unit doesn't provide them (e.g. with an instruction cache)
+  parameter int MaxOutstanding = 2,
+  parameter int FifoDepth      = 3
+) (
+  input       clk_i,
+  input       rst_ni,
+
+  input [3:0] outstanding_i,     // Outstanding fetch requests
+  input [3:0] fifo_occupancy_i,  // Valid entries of the fetch FIFO
+  input       fetch_valid_i,     // Fetch FIFO has an instruction for the ID stage
+  input       id_starved_i,      // ID stage is ready for an instruction but has none
+  input       core_sleep_i
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit fetch_monitor_enabled(input int max_outstanding,
+                                                    input int fifo_depth);
+
+  import "DPI-C" function void fetch_monitor_tick(input int outstanding, input int fifo_occupancy,
+                                                  input bit fetch_valid, input bit id_starved,
+                                                  input bit core_sleep);
+`endif
+
+  logic enabled;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = fetch_monitor_enabled(MaxOutstanding, FifoDepth);
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  always_ff @(posedge clk_i) begin
+    if (rst_ni && enabled) begin
+`ifdef VERILATOR
+      fetch_monitor_tick(int'(outstanding_i), int'(fifo_occupancy_i), fetch_valid_i,
+                         id_starved_i, core_sleep_i);
+`endif
+    end
+  end
+
+endmodule
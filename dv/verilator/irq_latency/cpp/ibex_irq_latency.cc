@@ -0,0 +1,155 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_irq_latency.h"
+
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+static const char *const irq_latency_state_names[kIrqLatencyStateNum] = {
+    "Other", "WFI", "Masked", "Divide", "Multiply", "LSU Busy"};
+
+// The instance accessed by the DPI functions below
+static IbexIrqLatency *irq_latency_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void irq_latency_sample(int irq, int state, long long cycles) {
+  assert(irq_latency_instance);
+  irq_latency_instance->Sample(irq, state, cycles);
+}
+
+void irq_latency_dropped(int irq) {
+  assert(irq_latency_instance);
+  irq_latency_instance->Dropped(irq);
+}
+}
+
+void IrqLatencyHist::Add(uint64_t latency) {
+  bins[latency]++;
+  count++;
+  sum += latency;
+}
+
+void IrqLatencyHist::Merge(const IrqLatencyHist &other) {
+  for (const auto &bin : other.bins) {
+    bins[bin.first] += bin.second;
+  }
+  count += other.count;
+  sum += other.sum;
+}
+
+uint64_t IrqLatencyHist::Percentile(double p) const {
+  // Nearest-rank method
+  unsigned long rank = std::ceil(p / 100.0 * count);
+  unsigned long seen = 0;
+
+  for (const auto &bin : bins) {
+    seen += bin.second;
+    if (seen >= rank) {
+      return bin.first;
+    }
+  }
+
+  return bins.empty() ? 0 : bins.rbegin()->first;
+}
+
+IbexIrqLatency::IbexIrqLatency() {
+  assert(!irq_latency_instance &&
+         "Only one IbexIrqLatency instance is supported.");
+  irq_latency_instance = this;
+}
+
+IbexIrqLatency::~IbexIrqLatency() { irq_latency_instance = nullptr; }
+
+void IbexIrqLatency::RegisterIrq(int irq, const std::string &name) {
+  GetIrq(irq).name = name;
+}
+
+void IbexIrqLatency::Sample(int irq, int state, uint64_t cycles) {
+  assert(state >= 0 && state < kIrqLatencyStateNum);
+  GetIrq(irq).hists[state].Add(cycles);
+}
+
+void IbexIrqLatency::Dropped(int irq) { GetIrq(irq).dropped++; }
+
+bool IbexIrqLatency::HasSamples() const {
+  for (const auto &irq : irqs_) {
+    for (const auto &hist : irq.second.hists) {
+      if (hist.count) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::string IbexIrqLatency::ReportString(bool csv) const {
+  std::stringstream report_ss;
+
+  for (const auto &irq_entry : irqs_) {
+    const IrqLatencyIrq &irq = irq_entry.second;
+    std::string name =
+        irq.name.empty() ? "IRQ " + std::to_string(irq_entry.first) : irq.name;
+
+    if (csv) {
+      for (int state = 0; state < kIrqLatencyStateNum; ++state) {
+        for (const auto &bin : irq.hists[state].bins) {
+          report_ss << name << ',' << irq_latency_state_names[state] << ','
+                    << bin.first << ',' << bin.second << std::endl;
+        }
+      }
+      continue;
+    }
+
+    IrqLatencyHist all;
+    for (const auto &hist : irq.hists) {
+      all.Merge(hist);
+    }
+
+    report_ss << name << " interrupt: " << all.count << " sample(s), "
+              << irq.dropped << " dropped" << std::endl;
+    if (!all.count) {
+      continue;
+    }
+
+    report_ss << "  " << std::left << std::setw(10) << "State" << std::right
+              << std::setw(10) << "Count" << std::setw(10) << "Min"
+              << std::setw(10) << "Avg" << std::setw(10) << "P99"
+              << std::setw(10) << "Max" << std::endl;
+
+    for (int state = 0; state <= kIrqLatencyStateNum; ++state) {
+      // The last row summarizes all states
+      const IrqLatencyHist &hist =
+          state < kIrqLatencyStateNum ? irq.hists[state] : all;
+      if (!hist.count) {
+        continue;
+      }
+
+      report_ss << "  " << std::left << std::setw(10)
+                << (state < kIrqLatencyStateNum ? irq_latency_state_names[state]
+                                                : "All")
+                << std::right << std::setw(10) << hist.count << std::setw(10)
+                << hist.bins.begin()->first << std::setw(10) << std::fixed
+                << std::setprecision(1)
+                << static_cast<double>(hist.sum) / hist.count << std::setw(10)
+                << hist.Percentile(99.0) << std::setw(10)
+                << hist.bins.rbegin()->first << std::endl;
+    }
+  }
+
+  return report_ss.str();
+}
+
+IrqLatencyIrq &IbexIrqLatency::GetIrq(int irq) {
+  IrqLatencyIrq &irq_entry = irqs_[irq];
+  if (irq_entry.hists.empty()) {
+    irq_entry.hists.resize(kIrqLatencyStateNum);
+    irq_entry.dropped = 0;
+  }
+  return irq_entry;
+}
@@ -0,0 +1,101 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_IRQ_LATENCY_H_
+#define IBEX_IRQ_LATENCY_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+// Core state when an interrupt is raised, keep in sync with the State*
+// parameters in rtl/irq_latency_monitor.sv
+enum IrqLatencyState {
+  kIrqLatencyStateOther = 0,
+  kIrqLatencyStateSleep,
+  kIrqLatencyStateMasked,
+  kIrqLatencyStateDivide,
+  kIrqLatencyStateMultiply,
+  kIrqLatencyStateLsuBusy,
+  kIrqLatencyStateNum
+};
+
+// Histogram of latencies in cycles
+struct IrqLatencyHist {
+  std::map<uint64_t, unsigned long> bins;  // latency -> number of samples
+  unsigned long count;
+  uint64_t sum;
+
+  IrqLatencyHist() : count(0), sum(0) {}
+  void Add(uint64_t latency);
+  void Merge(const IrqLatencyHist &other);
+  uint64_t Percentile(double p) const;
+};
+
+struct IrqLatencyIrq {
+  std::string name;
+  std::vector<IrqLatencyHist> hists;  // One per IrqLatencyState
+  unsigned long dropped;
+};
+
+/**
+ * Interrupt latency statistics for Verilator simulations
+ *
+ * Collects the latencies measured by irq_latency_monitor instances (see
+ * rtl/irq_latency_monitor.sv), i.e. the number of cycles from the assertion of
+ * an interrupt to the retirement of the first instruction of its handler.
+ * Latencies are kept in a histogram per interrupt and per core state at the
+ * time the interrupt was raised (sleeping in WFI, interrupt masked, divide or
+ * multiply in flight, LSU busy, other).
+ */
+class IbexIrqLatency : public SimCtrlExtension {
+ public:
+  IbexIrqLatency();
+  ~IbexIrqLatency();
+
+  /**
+   * Register an irq_latency_monitor instance
+   *
+   * @param irq IrqId parameter of the irq_latency_monitor instance
+   * @param name Name used in the report
+   */
+  void RegisterIrq(int irq, const std::string &name);
+
+  /**
+   * Record a latency measurement
+   */
+  void Sample(int irq, int state, uint64_t cycles);
+
+  /**
+   * Record an interrupt which was deasserted before its handler was entered
+   */
+  void Dropped(int irq);
+
+  /**
+   * Have any latencies been measured?
+   */
+  bool HasSamples() const;
+
+  /**
+   * Returns a formatted string of the latency statistics
+   *
+   * The pretty-print format contains min/avg/p99/max per interrupt and core
+   * state. The csv format contains the full histogram with one line per bin
+   * in the form "irq,state,latency,count".
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  std::map<int, IrqLatencyIrq> irqs_;
+
+  IrqLatencyIrq &GetIrq(int irq);
+};
+
+#endif  // IBEX_IRQ_LATENCY_H_
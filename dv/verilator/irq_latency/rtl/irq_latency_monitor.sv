@@ -0,0 +1,115 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Interrupt latency monitor for simulation
+ *
+ * Measures the number of cycles from the assertion of an interrupt line to the retirement (as seen
+ * on RVFI) of the first instruction of its handler, and passes each measurement to the C++ model
+ * (see dv/verilator/irq_latency/cpp/ibex_irq_latency.h), together with what the core was doing
+ * when the interrupt was raised.
+ *
+ * If the interrupt line is deasserted again before the handler is entered (e.g. because software
+ * cleared the source with interrupts disabled) the measurement is dropped.
+ */
+module irq_latency_monitor #(
+  // Identifies the interrupt to the C++ model (the mcause exception code is a good choice)
+  parameter int unsigned IrqId = 7
+) (
+  input               clk_i,
+  input               rst_ni,
+
+  input               irq_i,           // Interrupt line into the core
+  input               irq_enabled_i,   // Interrupt is enabled in mie and mstatus.MIE is set
+  input        [31:0] handler_pc_i,    // Address of the first instruction of the handler
+
+  // Core state, sampled when the interrupt is raised
+  input               core_sleep_i,
+  input               div_wait_i,
+  input               mul_wait_i,
+  input               lsu_busy_i,
+
+  // RVFI
+  input               rvfi_valid_i,
+  input               rvfi_intr_i,
+  input        [31:0] rvfi_pc_rdata_i
+);
+
+  // Core state when the interrupt is raised, keep in sync with IrqLatencyState in
+  // ibex_irq_latency.h. If several apply the first one in this list is chosen.
+  localparam int unsigned StateOther    = 0;
+  localparam int unsigned StateSleep    = 1;
+  localparam int unsigned StateMasked   = 2;
+  localparam int unsigned StateDivide   = 3;
+  localparam int unsigned StateMultiply = 4;
+  localparam int unsigned StateLsuBusy  = 5;
+
+`ifdef VERILATOR
+  import "DPI-C" function void irq_latency_sample(input int irq, input int state,
+                                                  input longint cycles);
+
+  import "DPI-C" function void irq_latency_dropped(input int irq);
+`endif
+
+  logic [63:0] cycle_q;
+  logic [63:0] assert_cycle_q;
+  logic [31:0] assert_state_q;
+  logic [31:0] assert_state;
+  logic        irq_q;
+  logic        pending_q;
+  logic        core_sleep_q;
+  logic        handler_entry;
+
+  // The core wakes up (deasserting core_sleep) in the same cycle the interrupt is raised, so look
+  // at the previous cycle to detect WFI.
+  always_comb begin
+    if (core_sleep_q) begin
+      assert_state = StateSleep;
+    end else if (!irq_enabled_i) begin
+      assert_state = StateMasked;
+    end else if (div_wait_i) begin
+      assert_state = StateDivide;
+    end else if (mul_wait_i) begin
+      assert_state = StateMultiply;
+    end else if (lsu_busy_i) begin
+      assert_state = StateLsuBusy;
+    end else begin
+      assert_state = StateOther;
+    end
+  end
+
+  assign handler_entry = rvfi_valid_i & rvfi_intr_i & (rvfi_pc_rdata_i == handler_pc_i);
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      cycle_q        <= '0;
+      assert_cycle_q <= '0;
+      assert_state_q <= '0;
+      irq_q          <= 1'b0;
+      pending_q      <= 1'b0;
+      core_sleep_q   <= 1'b0;
+    end else begin
+      cycle_q      <= cycle_q + 64'd1;
+      irq_q        <= irq_i;
+      core_sleep_q <= core_sleep_i;
+
+      if (pending_q && handler_entry) begin
+        pending_q <= 1'b0;
+`ifdef VERILATOR
+        irq_latency_sample(IrqId, assert_state_q, cycle_q - assert_cycle_q);
+`endif
+      end else if (pending_q && !irq_i) begin
+        pending_q <= 1'b0;
+`ifdef VERILATOR
+        irq_latency_dropped(IrqId);
+`endif
+      end else if (!pending_q && irq_i && !irq_q) begin
+        pending_q      <= 1'b1;
+        assert_cycle_q <= cycle_q;
+        assert_state_q <= assert_state;
+      end
+    end
+  end
+
+endmodule
@@ -0,0 +1,258 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_live_stats.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_pcounts.h"
+#include "verilator_sim_ctrl.h"
+
+extern "C" {
+extern long long mhpmcounter_get(int index);
+}
+
+// Index into ibex_counter_names
+static const int kCounterInstrRet = 2;
+
+// Set by the SIGUSR2 handler, cleared by the simulation loop
+static volatile sig_atomic_t stats_file_requested = 0;
+
+IbexLiveStats::IbexLiveStats(const std::string &scope)
+    : scope_(scope), socket_enabled_(false), socket_fd_(-1), cycle_(0) {
+  // Default file names are based on the toplevel, the last part of the scope
+  std::string toplevel = scope_.substr(scope_.rfind('.') + 1);
+  socket_path_ = toplevel + "_" + std::to_string(getpid()) + ".sock";
+  stats_filename_ = toplevel + "_stats.json";
+}
+
+IbexLiveStats::~IbexLiveStats() { PostExec(); }
+
+bool IbexLiveStats::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"stats-socket", optional_argument, nullptr, 'S'},
+      {"stats-file", required_argument, nullptr, 'F'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'S':
+        socket_enabled_ = true;
+        if (optarg) {
+          socket_path_ = optarg;
+        }
+        break;
+      case 'F':
+        stats_filename_ = optarg;
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  if (socket_enabled_) {
+    struct sockaddr_un addr;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+      std::cerr << "ERROR: Socket path too long: " << socket_path_
+                << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void IbexLiveStats::PreExec() {
+  sample_.cycle = 0;
+  sample_.time = std::chrono::steady_clock::now();
+  prev_sample_ = sample_;
+
+  struct sigaction sig_action;
+  sig_action.sa_handler = SignalHandler;
+  sigemptyset(&sig_action.sa_mask);
+  sig_action.sa_flags = 0;
+  sigaction(SIGUSR2, &sig_action, NULL);
+
+  if (!socket_enabled_) {
+    return;
+  }
+
+  socket_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (socket_fd_ < 0) {
+    std::cerr << "ERROR: Could not create stats socket: " << strerror(errno)
+              << std::endl;
+    return;
+  }
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+  // Remove a stale socket of an earlier run
+  unlink(socket_path_.c_str());
+  if (bind(socket_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(socket_fd_, 4) != 0) {
+    std::cerr << "ERROR: Could not listen on stats socket " << socket_path_
+              << ": " << strerror(errno) << std::endl;
+    close(socket_fd_);
+    socket_fd_ = -1;
+    return;
+  }
+
+  std::cout << "Simulation statistics are served on " << socket_path_
+            << std::endl;
+}
+
+void IbexLiveStats::OnClock(unsigned long sim_time) {
+  cycle_ = sim_time / 2;
+  if (cycle_ % kPollCycles) {
+    return;
+  }
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (now - sample_.time >= std::chrono::seconds(1)) {
+    prev_sample_ = sample_;
+    sample_.cycle = cycle_;
+    sample_.time = now;
+  }
+
+  if (stats_file_requested) {
+    stats_file_requested = 0;
+    WriteStatsFile();
+  }
+  if (socket_fd_ >= 0) {
+    ServeSocket();
+  }
+}
+
+void IbexLiveStats::PostExec() {
+  if (socket_fd_ >= 0) {
+    close(socket_fd_);
+    socket_fd_ = -1;
+    unlink(socket_path_.c_str());
+  }
+}
+
+std::string IbexLiveStats::SnapshotString() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  // Speed since the older of the two samples, which is one to two seconds ago
+  // (or since the start of the simulation)
+  double interval_s =
+      std::chrono::duration<double>(now - prev_sample_.time).count();
+  double speed_hz =
+      interval_s > 0.0 ? (cycle_ - prev_sample_.cycle) / interval_s : 0.0;
+
+  // The counters are read outside of any DPI call, so set the scope first
+  svSetScope(svGetScopeFromName(scope_.c_str()));
+
+  std::stringstream json;
+  json << "{\"cycle\": " << cycle_ << ", \"cycles_per_s\": " << speed_hz
+       << ", \"instret\": " << mhpmcounter_get(kCounterInstrRet)
+       << ", \"tracing\": "
+       << (VerilatorSimCtrl::GetInstance().TracingEnabled() ? "true" : "false")
+       << ", \"counters\": {";
+  bool first = true;
+  for (size_t i = 0; i < ibex_counter_names.size(); ++i) {
+    if (ibex_counter_names[i] == "NONE") {
+      continue;
+    }
+    json << (first ? "" : ", ") << "\"" << ibex_counter_names[i]
+         << "\": " << mhpmcounter_get(i);
+    first = false;
+  }
+  json << "}}" << std::endl;
+
+  return json.str();
+}
+
+void IbexLiveStats::ServeSocket() {
+  while (1) {
+    int client_fd = accept(socket_fd_, nullptr, nullptr);
+    if (client_fd < 0) {
+      // EAGAIN: no more pending connections
+      return;
+    }
+
+    // The snapshot is much smaller than the socket buffer, so this doesn't
+    // block even if the client never reads it
+    std::string snapshot = SnapshotString();
+    if (send(client_fd, snapshot.data(), snapshot.size(), MSG_NOSIGNAL) < 0) {
+      std::cerr << "WARNING: Could not send statistics: " << strerror(errno)
+                << std::endl;
+    }
+    close(client_fd);
+  }
+}
+
+void IbexLiveStats::WriteStatsFile() {
+  // Write to a temporary file first, so readers never see a partial snapshot
+  std::string tmp_filename = stats_filename_ + ".tmp";
+  FILE *stats_file = fopen(tmp_filename.c_str(), "w");
+  if (!stats_file) {
+    std::cerr << "ERROR: Could not open " << tmp_filename << std::endl;
+    return;
+  }
+  std::string snapshot = SnapshotString();
+  fwrite(snapshot.data(), 1, snapshot.size(), stats_file);
+  fclose(stats_file);
+
+  if (rename(tmp_filename.c_str(), stats_filename_.c_str()) != 0) {
+    std::cerr << "ERROR: Could not write " << stats_filename_ << std::endl;
+  }
+}
+
+void IbexLiveStats::SignalHandler(int sig) {
+  if (sig == SIGUSR2) {
+    stats_file_requested = 1;
+  }
+}
+
+void IbexLiveStats::PrintHelp() const {
+  std::cout << "Live simulation statistics:\n\n"
+               "--stats-socket[=PATH]\n"
+               "  Serve a JSON snapshot of the simulation statistics to every\n"
+               "  connection on the Unix domain socket PATH\n"
+               "  (default: " << socket_path_ << ")\n\n"
+               "--stats-file=FILE\n"
+               "  Write the snapshot to FILE on SIGUSR2\n"
+               "  (default: " << stats_filename_ << ")\n\n";
+}
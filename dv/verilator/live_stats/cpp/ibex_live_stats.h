@@ -0,0 +1,118 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_LIVE_STATS_H_
+#define IBEX_LIVE_STATS_H_
+
+#include <chrono>
+#include <string>
+
+#include "sim_ctrl_extension.h"
+
+/**
+ * Statistics of a running simulation
+ *
+ * Makes the progress of a running simulation visible to other processes
+ * (e.g. a job scheduler looking for hung or slow jobs). A snapshot contains
+ * the current cycle, the simulation speed over the last second or so, the
+ * number of retired instructions, all performance counters and whether
+ * tracing is enabled, formatted as a single line of JSON.
+ *
+ * Snapshots are requested in one of two ways:
+ *
+ * --stats-socket[=PATH]
+ *   Listen on the Unix domain socket PATH (default:
+ *   <toplevel>_<pid>.sock). Every connection receives one snapshot, after
+ *   which the socket is closed, e.g. `socat - UNIX-CONNECT:PATH`.
+ *
+ * SIGUSR2
+ *   Write a snapshot to the file given by --stats-file (default:
+ *   <toplevel>_stats.json).
+ *
+ * Requests are served from the simulation loop, so they don't need any
+ * locking, but are only checked every kPollCycles cycles. The simulation is
+ * never blocked waiting for a client.
+ */
+class IbexLiveStats : public SimCtrlExtension {
+ public:
+  /**
+   * @param scope Scope of the toplevel module, used to read the performance
+   *              counters through DPI
+   */
+  IbexLiveStats(const std::string &scope);
+  ~IbexLiveStats();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Open the socket and install the SIGUSR2 handler
+   */
+  virtual void PreExec();
+
+  /**
+   * Serve pending requests
+   */
+  virtual void OnClock(unsigned long sim_time);
+
+  /**
+   * Close and remove the socket
+   */
+  virtual void PostExec();
+
+  /**
+   * Returns the current snapshot as JSON, newline at end
+   */
+  std::string SnapshotString();
+
+ private:
+  static const unsigned long kPollCycles = 4096;
+
+  std::string scope_;
+  std::string socket_path_;
+  std::string stats_filename_;
+  bool socket_enabled_;
+  int socket_fd_;
+  unsigned long cycle_;
+
+  // Two samples of (cycle, host time) to compute the recent simulation speed.
+  // |sample_| is replaced by the current state at most once per second, with
+  // the previous sample moving to |prev_sample_|.
+  struct Sample {
+    unsigned long cycle;
+    std::chrono::steady_clock::time_point time;
+  };
+  Sample prev_sample_;
+  Sample sample_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Accept and answer all pending connections on the socket
+   */
+  void ServeSocket();
+
+  /**
+   * Write a snapshot to |stats_filename_|
+   */
+  void WriteStatsFile();
+
+  /**
+   * Signal handler for SIGUSR2
+   */
+  static void SignalHandler(int sig);
+};
+
+#endif  // IBEX_LIVE_STATS_H_
@@ -0,0 +1,271 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_mem_latency.h"
+
+#include <getopt.h>
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+
+// The instance accessed by the DPI functions below
+static IbexMemLatency *mem_latency_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+int mem_latency_enabled(int port) {
+  return mem_latency_instance && mem_latency_instance->IsEnabled(port);
+}
+
+int mem_latency_gnt_wait(int port, svBit granted) {
+  assert(mem_latency_instance);
+  return mem_latency_instance->GntWait(port, granted);
+}
+
+int mem_latency_delay(int port, const svBitVecVal *addr) {
+  assert(mem_latency_instance);
+  return mem_latency_instance->Delay(port, addr[0]);
+}
+}
+
+IbexMemLatency::IbexMemLatency() : gnt_stall_prob_(0.0), rng_(0) {
+  assert(!mem_latency_instance &&
+         "Only one IbexMemLatency instance is supported.");
+  mem_latency_instance = this;
+}
+
+IbexMemLatency::~IbexMemLatency() { mem_latency_instance = nullptr; }
+
+void IbexMemLatency::RegisterPort(int port, const std::string &name) {
+  if (ports_.size() <= static_cast<size_t>(port)) {
+    ports_.resize(port + 1);
+  }
+  ports_[port].name = name;
+}
+
+bool IbexMemLatency::ParseCLIArguments(int argc, char **argv,
+                                       bool &exit_app) {
+  const struct option long_options[] = {
+      {"mem-latency", required_argument, nullptr, 'L'},
+      {"mem-gnt-stall", required_argument, nullptr, 'G'},
+      {"mem-latency-seed", required_argument, nullptr, 'S'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'L': {
+        MemLatencyRegion region;
+        if (!ParseRegionArg(optarg, region)) {
+          std::cerr << "ERROR: Unable to parse mem-latency arguments."
+                    << std::endl;
+          return false;
+        }
+        regions_.push_back(region);
+      } break;
+      case 'G': {
+        int percent = atoi(optarg);
+        if (percent < 0 || percent > 99) {
+          std::cerr << "ERROR: mem-gnt-stall must be in the range 0 to 99, "
+                    << "got: " << optarg << std::endl;
+          return false;
+        }
+        gnt_stall_prob_ = percent / 100.0;
+      } break;
+      case 'S':
+        rng_.seed(strtoul(optarg, nullptr, 0));
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  return true;
+}
+
+bool IbexMemLatency::IsEnabled() const {
+  return !regions_.empty() || gnt_stall_prob_ > 0.0;
+}
+
+bool IbexMemLatency::IsEnabled(int port) const {
+  return IsEnabled() && static_cast<size_t>(port) < ports_.size() &&
+         !ports_[port].name.empty();
+}
+
+unsigned int IbexMemLatency::GntWait(int port, bool granted) {
+  MemLatencyPort *p = GetPort(port);
+
+  // On a grant the wait drawn last time has been applied to the granted
+  // request. On reset it is discarded.
+  if (granted) {
+    p->gnt_wait_cycles += p->pending_gnt_wait;
+  }
+
+  p->pending_gnt_wait = 0;
+  if (gnt_stall_prob_ > 0.0) {
+    // Number of stalled cycles before the first cycle with a grant
+    std::geometric_distribution<unsigned int> dist(1.0 - gnt_stall_prob_);
+    p->pending_gnt_wait = dist(rng_);
+  }
+  return p->pending_gnt_wait;
+}
+
+unsigned int IbexMemLatency::Delay(int port, uint32_t addr) {
+  MemLatencyPort *p = GetPort(port);
+  p->requests++;
+
+  for (auto &region : regions_) {
+    if (addr - region.base >= region.size) {
+      continue;
+    }
+
+    unsigned int delay = region.latency;
+    if (region.jitter) {
+      switch (region.dist) {
+        case kMemLatencyJitterGeometric: {
+          std::geometric_distribution<unsigned int> dist(1.0 /
+                                                         (1.0 + region.jitter));
+          delay += dist(rng_);
+        } break;
+        case kMemLatencyJitterUniform:
+        default: {
+          std::uniform_int_distribution<unsigned int> dist(0, region.jitter);
+          delay += dist(rng_);
+        } break;
+      }
+    }
+
+    region.requests++;
+    region.wait_cycles += delay;
+    p->rsp_wait_cycles += delay;
+    return delay;
+  }
+
+  return 0;
+}
+
+std::string IbexMemLatency::ReportString(bool csv) const {
+  StatValues values;
+
+  for (const auto &p : ports_) {
+    if (p.name.empty()) {
+      continue;
+    }
+    AddStat(values, "Memory " + p.name + " Requests", p.requests);
+    AddStat(values, "Memory " + p.name + " Response Wait Cycles",
+            p.rsp_wait_cycles);
+    AddStat(values, "Memory " + p.name + " Grant Wait Cycles",
+            p.gnt_wait_cycles);
+  }
+
+  for (const auto &region : regions_) {
+    std::stringstream region_name;
+    region_name << "Memory Region 0x" << std::hex << region.base << "+0x"
+                << region.size;
+    AddStat(values, region_name.str() + " Requests", region.requests);
+    AddStat(values, region_name.str() + " Wait Cycles", region.wait_cycles);
+  }
+
+  return FormatStats(values, csv);
+}
+
+void IbexMemLatency::PrintHelp() const {
+  std::cout << "Memory latency model:\n\n"
+               "--mem-latency=BASE,SIZE,CYCLES[,JITTER[,DIST]]\n"
+               "  Delay responses for addresses in [BASE, BASE + SIZE) by\n"
+               "  CYCLES plus a random jitter of up to JITTER cycles.\n"
+               "  DIST is either 'uniform' (default) or 'geometric' (JITTER\n"
+               "  is the mean). Can be given multiple times.\n\n"
+               "--mem-gnt-stall=PERCENT\n"
+               "  Withhold the grant of a request with a probability of\n"
+               "  PERCENT in every cycle\n\n"
+               "--mem-latency-seed=SEED\n"
+               "  Seed for the random latency and stall generation\n\n";
+}
+
+bool IbexMemLatency::ParseRegionArg(const std::string &arg,
+                                    MemLatencyRegion &region) const {
+  std::array<std::string, 5> args;
+  size_t pos = 0;
+  size_t end_pos = 0;
+  size_t i;
+
+  for (i = 0; i < args.size(); ++i) {
+    end_pos = arg.find(",", pos);
+    if (pos == end_pos) {
+      std::cerr << "ERROR: empty field in: " << arg << std::endl;
+      return false;
+    }
+    if (end_pos == std::string::npos) {
+      args[i] = arg.substr(pos);
+      break;
+    }
+    args[i] = arg.substr(pos, end_pos - pos);
+    pos = end_pos + 1;
+  }
+
+  if (i < 2 || i == args.size()) {
+    std::cerr << "ERROR: mem-latency must be in \"base,size,cycles"
+              << "[,jitter[,dist]]\" got: " << arg << std::endl;
+    return false;
+  }
+
+  region.base = strtoul(args[0].c_str(), nullptr, 0);
+  region.size = strtoul(args[1].c_str(), nullptr, 0);
+  region.latency = strtoul(args[2].c_str(), nullptr, 0);
+  region.jitter = i >= 3 ? strtoul(args[3].c_str(), nullptr, 0) : 0;
+  region.dist = kMemLatencyJitterUniform;
+  region.requests = 0;
+  region.wait_cycles = 0;
+
+  if (i == 4) {
+    if (args[4].compare("geometric") == 0) {
+      region.dist = kMemLatencyJitterGeometric;
+    } else if (args[4].compare("uniform") != 0) {
+      std::cerr << "ERROR: Unknown jitter distribution: " << args[4]
+                << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+MemLatencyPort *IbexMemLatency::GetPort(int port) {
+  if (ports_.size() <= static_cast<size_t>(port)) {
+    ports_.resize(port + 1);
+  }
+  return &ports_[port];
+}
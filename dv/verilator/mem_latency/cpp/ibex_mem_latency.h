@@ -0,0 +1,142 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_MEM_LATENCY_H_
+#define IBEX_MEM_LATENCY_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+enum MemLatencyJitter {
+  kMemLatencyJitterUniform = 0,
+  kMemLatencyJitterGeometric,
+};
+
+struct MemLatencyRegion {
+  uint32_t base;              // First address of the region
+  uint32_t size;              // Size of the region in bytes
+  unsigned int latency;       // Fixed additional response latency in cycles
+  unsigned int jitter;        // Jitter added on top of |latency|
+  MemLatencyJitter dist;      // Distribution of the jitter
+  unsigned long requests;     // Number of requests to this region
+  unsigned long wait_cycles;  // Response latency injected in this region
+};
+
+struct MemLatencyPort {
+  std::string name;
+  unsigned long requests;
+  unsigned long rsp_wait_cycles;
+  unsigned long gnt_wait_cycles;
+  unsigned int pending_gnt_wait;
+};
+
+/**
+ * Memory latency model for Verilator simulations
+ *
+ * Controls one or more mem_latency modules (see rtl/mem_latency.sv) which sit
+ * between a bus host and the memory system. Each granted request can be
+ * delayed by a fixed latency plus a random jitter, selected by the address
+ * region the request falls into. Independently, the grant of each request can
+ * be withheld for a random number of cycles to model back-pressure.
+ *
+ * The model is configured on the command line:
+ *
+ * --mem-latency=BASE,SIZE,CYCLES[,JITTER[,DIST]]
+ *   Add CYCLES (plus up to JITTER cycles, distributed according to DIST, which
+ *   is either 'uniform' (default) or 'geometric') of latency to all responses
+ *   for addresses in [BASE, BASE + SIZE). Can be given multiple times, the
+ *   first matching region applies.
+ *
+ * --mem-gnt-stall=PERCENT
+ *   Withhold the grant of a request with a probability of PERCENT in every
+ *   cycle.
+ *
+ * --mem-latency-seed=SEED
+ *   Seed for the random number generator (default: 0).
+ */
+class IbexMemLatency : public SimCtrlExtension {
+ public:
+  IbexMemLatency();
+  ~IbexMemLatency();
+
+  /**
+   * Register a mem_latency module instance
+   *
+   * Only registered instances have latency and back-pressure applied, all
+   * other instances pass requests and responses through unchanged.
+   *
+   * @param port PortId parameter of the mem_latency instance
+   * @param name Name used in the report
+   */
+  void RegisterPort(int port, const std::string &name);
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Has any latency or back-pressure been configured?
+   */
+  bool IsEnabled() const;
+
+  /**
+   * Is the mem_latency instance with the given PortId controlled by the model?
+   */
+  bool IsEnabled(int port) const;
+
+  /**
+   * Draw the number of cycles the grant of the next request on |port| is
+   * withheld for
+   *
+   * @param granted True if called on a grant, false if called on reset
+   */
+  unsigned int GntWait(int port, bool granted);
+
+  /**
+   * Draw the additional response latency of a request to |addr| granted on
+   * |port|
+   */
+  unsigned int Delay(int port, uint32_t addr);
+
+  /**
+   * Returns a formatted string of the latency model statistics
+   *
+   * The statistics can be appended to the performance counter report.
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  std::vector<MemLatencyPort> ports_;
+  std::vector<MemLatencyRegion> regions_;
+  double gnt_stall_prob_;
+  std::mt19937 rng_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Parse a region argument in the form of BASE,SIZE,CYCLES[,JITTER[,DIST]]
+   */
+  bool ParseRegionArg(const std::string &arg, MemLatencyRegion &region) const;
+
+  MemLatencyPort *GetPort(int port);
+};
+
+#endif  // IBEX_MEM_LATENCY_H_
@@ -0,0 +1,192 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Memory latency injector for simulation
+ *
+ * Sits between a host (e.g. the instruction or data port of Ibex) and the memory system it is
+ * connected to, and delays grants and responses as requested by the C++ memory latency model (see
+ * dv/verilator/mem_latency/cpp/ibex_mem_latency.h). The downstream side must follow the usual
+ * Ibex assumption of responding exactly one cycle after a granted request.
+ *
+ * - Grant back-pressure: Before each request the model decides how many cycles the grant is
+ *   withheld for.
+ * - Response latency: For each granted request the model returns a number of additional cycles
+ *   the response is delayed by. Responses are always returned in order.
+ *
+ * Without Verilator (or if the port isn't registered with the C++ model) requests and responses are
+ * passed through without additional latency.
+ */
+module mem_latency #(
+  // Identifies this port to the C++ model
+  parameter int unsigned PortId         = 0,
+  // Maximum number of requests in flight (must be a power of two)
+  parameter int unsigned MaxOutstanding = 4
+) (
+  input               clk_i,
+  input               rst_ni,
+
+  // Host side
+  input               host_req_i,
+  output logic        host_gnt_o,
+  input        [31:0] host_addr_i,
+  input               host_we_i,
+  input        [ 3:0] host_be_i,
+  input        [31:0] host_wdata_i,
+  output logic        host_rvalid_o,
+  output logic [31:0] host_rdata_o,
+  output logic        host_err_o,
+
+  // Device side
+  output logic        dev_req_o,
+  input               dev_gnt_i,
+  output logic [31:0] dev_addr_o,
+  output logic        dev_we_o,
+  output logic [ 3:0] dev_be_o,
+  output logic [31:0] dev_wdata_o,
+  input               dev_rvalid_i,
+  input        [31:0] dev_rdata_i,
+  input               dev_err_i
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function int mem_latency_enabled(input int port);
+
+  import "DPI-C" function int mem_latency_gnt_wait(input int port, input bit granted);
+
+  import "DPI-C" function int mem_latency_delay(input int port, input bit [31:0] addr);
+`endif
+
+  localparam int unsigned PtrW = $clog2(MaxOutstanding);
+
+  logic            enabled;
+  logic [63:0]     cycle_q;
+  logic [31:0]     gnt_wait_q;
+  logic            dev_gnt;
+
+  // Response queue
+  logic [63:0]     rsp_ready_q     [MaxOutstanding];
+  logic [31:0]     rsp_rdata_q     [MaxOutstanding];
+  logic            rsp_err_q       [MaxOutstanding];
+  logic [MaxOutstanding-1:0] rsp_data_q;
+  logic [PtrW:0]   rsp_wr_ptr_q, rsp_fill_ptr_q, rsp_rd_ptr_q;
+  logic [PtrW-1:0] rsp_wr_idx, rsp_fill_idx, rsp_rd_idx;
+  logic [63:0]     rsp_last_ready_q;
+  logic            rsp_full, rsp_empty, rsp_pop, head_fill;
+
+  initial begin
+`ifdef VERILATOR
+    enabled = mem_latency_enabled(PortId) != 0;
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  assign rsp_wr_idx   = rsp_wr_ptr_q[PtrW-1:0];
+  assign rsp_fill_idx = rsp_fill_ptr_q[PtrW-1:0];
+  assign rsp_rd_idx   = rsp_rd_ptr_q[PtrW-1:0];
+  assign rsp_empty    = rsp_wr_ptr_q == rsp_rd_ptr_q;
+  assign rsp_full     = (rsp_wr_idx == rsp_rd_idx) & ~rsp_empty;
+
+  //////////////////////////
+  // Request / grant path //
+  //////////////////////////
+
+  // Requests are only forwarded once the model allows them to be granted
+  assign dev_req_o   = host_req_i & (gnt_wait_q == '0) & ~rsp_full;
+  assign dev_addr_o  = host_addr_i;
+  assign dev_we_o    = host_we_i;
+  assign dev_be_o    = host_be_i;
+  assign dev_wdata_o = host_wdata_i;
+
+  assign dev_gnt    = dev_req_o & dev_gnt_i;
+  assign host_gnt_o = dev_gnt;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      // The first request after reset sees back-pressure as well
+`ifdef VERILATOR
+      gnt_wait_q <= enabled ? mem_latency_gnt_wait(PortId, 1'b0) : '0;
+`else
+      gnt_wait_q <= '0;
+`endif
+    end else if (enabled) begin
+      if (dev_gnt) begin
+        // Decide on the back-pressure applied to the next request
+`ifdef VERILATOR
+        gnt_wait_q <= mem_latency_gnt_wait(PortId, 1'b1);
+`endif
+      end else if (host_req_i & (gnt_wait_q != '0)) begin
+        gnt_wait_q <= gnt_wait_q - 32'd1;
+      end
+    end
+  end
+
+  ///////////////////
+  // Response path //
+  ///////////////////
+
+  // Incoming data belongs to the oldest request which hasn't received its data yet. If this is the
+  // head of the queue the data can be passed through directly.
+  assign head_fill     = dev_rvalid_i & (rsp_fill_ptr_q == rsp_rd_ptr_q);
+
+  assign host_rvalid_o = ~rsp_empty & (cycle_q >= rsp_ready_q[rsp_rd_idx]) &
+                         (rsp_data_q[rsp_rd_idx] | head_fill);
+  assign host_rdata_o  = rsp_data_q[rsp_rd_idx] ? rsp_rdata_q[rsp_rd_idx] : dev_rdata_i;
+  assign host_err_o    = rsp_data_q[rsp_rd_idx] ? rsp_err_q[rsp_rd_idx]   : dev_err_i;
+
+  assign rsp_pop = host_rvalid_o;
+
+  // Additional cycles the response to a request granted in this cycle is delayed by
+  function automatic logic [63:0] response_delay(logic [31:0] addr);
+`ifdef VERILATOR
+    if (enabled) begin
+      return 64'(unsigned'(mem_latency_delay(PortId, addr)));
+    end
+`endif
+    return '0;
+  endfunction
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      cycle_q          <= '0;
+      rsp_wr_ptr_q     <= '0;
+      rsp_fill_ptr_q   <= '0;
+      rsp_rd_ptr_q     <= '0;
+      rsp_data_q       <= '0;
+      rsp_last_ready_q <= '0;
+    end else begin
+      cycle_q <= cycle_q + 64'd1;
+
+      if (dev_gnt) begin : push_rsp
+        logic [63:0] ready;
+
+        // The downstream response arrives in the next cycle, responses can't overtake each other
+        ready = cycle_q + 64'd1 + response_delay(host_addr_i);
+        if (ready <= rsp_last_ready_q) begin
+          ready = rsp_last_ready_q + 64'd1;
+        end
+
+        rsp_ready_q[rsp_wr_idx] <= ready;
+        rsp_last_ready_q        <= ready;
+        rsp_wr_ptr_q            <= rsp_wr_ptr_q + 1'b1;
+      end
+
+      if (dev_rvalid_i) begin
+        rsp_rdata_q[rsp_fill_idx] <= dev_rdata_i;
+        rsp_err_q[rsp_fill_idx]   <= dev_err_i;
+        rsp_data_q[rsp_fill_idx]  <= ~(head_fill & rsp_pop);
+        rsp_fill_ptr_q            <= rsp_fill_ptr_q + 1'b1;
+      end
+
+      if (rsp_pop) begin
+        if (!head_fill) begin
+          rsp_data_q[rsp_rd_idx] <= 1'b0;
+        end
+        rsp_rd_ptr_q <= rsp_rd_ptr_q + 1'b1;
+      end
+    end
+  end
+
+endmodule
@@ -0,0 +1,345 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_mem_watch.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_stats_format.h"
+#include "verilator_sim_ctrl.h"
+
+// The instance accessed by the DPI functions below
+static IbexMemWatch *mem_watch_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+svBit mem_watch_enabled() {
+  return mem_watch_instance && mem_watch_instance->IsEnabled();
+}
+
+svBit mem_watch_access(const svBitVecVal *pc, const svBitVecVal *addr,
+                       svBit we, const svBitVecVal *be,
+                       const svBitVecVal *wdata) {
+  assert(mem_watch_instance);
+  return mem_watch_instance->Access(pc[0], addr[0], we, be[0], wdata[0]);
+}
+
+void mem_watch_rdata(const svBitVecVal *rdata) {
+  assert(mem_watch_instance);
+  mem_watch_instance->ReadData(rdata[0]);
+}
+}
+
+IbexMemWatch::IbexMemWatch(const std::string &log_filename)
+    : min_base_(0),
+      max_end_all_(0),
+      log_filename_(log_filename),
+      log_file_(nullptr) {
+  assert(!mem_watch_instance && "Only one IbexMemWatch instance is supported.");
+  mem_watch_instance = this;
+}
+
+IbexMemWatch::~IbexMemWatch() {
+  PostExec();
+  mem_watch_instance = nullptr;
+}
+
+bool IbexMemWatch::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"watch", required_argument, nullptr, 'W'},
+      {"watch-log", required_argument, nullptr, 'O'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, ":h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 0:
+        break;
+      case 'W': {
+        MemWatchRange range;
+        if (!ParseWatchArg(optarg, range)) {
+          std::cerr << "ERROR: Unable to parse watch arguments." << std::endl;
+          return false;
+        }
+        ranges_.push_back(range);
+      } break;
+      case 'O':
+        log_filename_ = optarg;
+        break;
+      case 'h':
+        PrintHelp();
+        exit_app = true;
+        break;
+      case ':':  // missing argument
+        std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+        return false;
+      case '?':
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  if (ranges_.size() > UINT16_MAX) {
+    std::cerr << "ERROR: Too many watchpoints." << std::endl;
+    return false;
+  }
+
+  BuildIndex();
+  return true;
+}
+
+void IbexMemWatch::PreExec() {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  log_file_ = fopen(log_filename_.c_str(), "wb");
+  if (!log_file_) {
+    std::cerr << "ERROR: Could not open watchpoint log " << log_filename_
+              << std::endl;
+    return;
+  }
+
+  MemWatchLogHeader header;
+  memcpy(header.magic, "IBEXWTCH", sizeof(header.magic));
+  header.version = kMemWatchLogVersion;
+  header.record_size = sizeof(MemWatchLogRecord);
+  fwrite(&header, sizeof(header), 1, log_file_);
+
+  std::cout << "Writing memory watchpoint hits to " << log_filename_
+            << std::endl;
+}
+
+void IbexMemWatch::PostExec() {
+  if (log_file_) {
+    fclose(log_file_);
+    log_file_ = nullptr;
+  }
+}
+
+bool IbexMemWatch::Access(uint32_t pc, uint32_t addr, bool we, uint8_t be,
+                          uint32_t wdata) {
+  if (!be) {
+    return false;
+  }
+
+  // Narrow the (word aligned) access down to the enabled bytes
+  uint64_t word = addr & ~uint32_t(3);
+  uint64_t first = word + __builtin_ctz(be);
+  uint64_t last = word + 31 - __builtin_clz(be);
+  if (first >= max_end_all_ || last < min_base_) {
+    return false;
+  }
+
+  Lookup(first, last, we, hits_);
+  if (hits_.empty()) {
+    return false;
+  }
+
+  MemWatchLogRecord record;
+  record.cycle = VerilatorSimCtrl::GetInstance().GetTime() / 2;
+  record.pc = pc;
+  record.addr = addr;
+  record.data = wdata;
+  record.be = be;
+  record.we = we;
+  record.watch = hits_[0];
+
+  if (we) {
+    Hit(record, hits_);
+  } else {
+    pending_reads_.push_back({record, hits_});
+  }
+  return true;
+}
+
+void IbexMemWatch::ReadData(uint32_t rdata) {
+  if (pending_reads_.empty()) {
+    return;
+  }
+
+  PendingRead &read = pending_reads_.front();
+  read.record.cycle = VerilatorSimCtrl::GetInstance().GetTime() / 2;
+  read.record.data = rdata;
+  Hit(read.record, read.hits);
+  pending_reads_.pop_front();
+}
+
+void IbexMemWatch::Hit(const MemWatchLogRecord &record,
+                       const std::vector<size_t> &hits) {
+  if (log_file_) {
+    fwrite(&record, sizeof(record), 1, log_file_);
+  }
+
+  VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
+  for (size_t watch : hits) {
+    MemWatchRange &range = ranges_[watch];
+    range.hits++;
+
+    switch (range.action) {
+      case kMemWatchStop:
+        std::cout << "Watchpoint " << watch << " hit by PC 0x" << std::hex
+                  << record.pc << " at address 0x" << record.addr << std::dec
+                  << ", stopping simulation." << std::endl;
+        simctrl.RequestStop(true);
+        break;
+      case kMemWatchTrace:
+        if (!simctrl.TracingEnabled()) {
+          simctrl.TraceOn();
+        }
+        break;
+      case kMemWatchLog:
+      default:
+        break;
+    }
+  }
+}
+
+void IbexMemWatch::BuildIndex() {
+  sorted_.resize(ranges_.size());
+  for (size_t i = 0; i < ranges_.size(); ++i) {
+    sorted_[i] = i;
+  }
+  std::sort(sorted_.begin(), sorted_.end(), [this](size_t a, size_t b) {
+    return ranges_[a].base < ranges_[b].base;
+  });
+
+  max_end_.resize(sorted_.size());
+  max_end_all_ = 0;
+  min_base_ = sorted_.empty() ? 0 : ranges_[sorted_[0]].base;
+  for (size_t i = 0; i < sorted_.size(); ++i) {
+    max_end_all_ = std::max(max_end_all_, ranges_[sorted_[i]].end);
+    max_end_[i] = max_end_all_;
+  }
+}
+
+void IbexMemWatch::Lookup(uint64_t first, uint64_t last, bool we,
+                          std::vector<size_t> &hits) const {
+  hits.clear();
+
+  // All ranges starting at or before |last| are candidates. Walking them
+  // backwards, the running maximum of the end addresses tells when no earlier
+  // range can reach |first| any more.
+  size_t pos = std::upper_bound(sorted_.begin(), sorted_.end(), last,
+                                [this](uint64_t addr, size_t idx) {
+                                  return addr < ranges_[idx].base;
+                                }) -
+               sorted_.begin();
+
+  while (pos > 0 && max_end_[pos - 1] > first) {
+    --pos;
+    const MemWatchRange &range = ranges_[sorted_[pos]];
+    if (range.end > first && (we ? range.write : range.read)) {
+      hits.push_back(sorted_[pos]);
+    }
+  }
+
+  // Report hits in command line order
+  std::sort(hits.begin(), hits.end());
+}
+
+std::string IbexMemWatch::ReportString(bool csv) const {
+  StatValues values;
+
+  for (const auto &range : ranges_) {
+    std::stringstream name;
+    name << "Watchpoint 0x" << std::hex << range.base << "+0x"
+         << (range.end - range.base) << " Hits";
+    AddStat(values, name.str(), range.hits);
+  }
+
+  return FormatStats(values, csv);
+}
+
+void IbexMemWatch::PrintHelp() const {
+  std::cout << "Memory watchpoints:\n\n"
+               "--watch=ADDR,LEN[,r|w|rw][,stop|trace]\n"
+               "  Log reads and/or writes (default: both) to\n"
+               "  [ADDR, ADDR + LEN). 'stop' ends the simulation on a hit,\n"
+               "  'trace' enables tracing from the first hit onwards.\n"
+               "  Can be given multiple times.\n\n"
+               "--watch-log=FILE\n"
+               "  Write the binary log of watchpoint hits to FILE\n\n";
+}
+
+bool IbexMemWatch::ParseWatchArg(const std::string &arg,
+                                 MemWatchRange &range) const {
+  std::array<std::string, 4> args;
+  size_t pos = 0;
+  size_t end_pos = 0;
+  size_t i;
+
+  for (i = 0; i < args.size(); ++i) {
+    end_pos = arg.find(",", pos);
+    if (pos == end_pos) {
+      std::cerr << "ERROR: empty field in: " << arg << std::endl;
+      return false;
+    }
+    if (end_pos == std::string::npos) {
+      args[i] = arg.substr(pos);
+      break;
+    }
+    args[i] = arg.substr(pos, end_pos - pos);
+    pos = end_pos + 1;
+  }
+
+  if (i < 1 || i == args.size()) {
+    std::cerr << "ERROR: watch must be in \"addr,len[,r|w|rw][,stop|trace]\""
+              << " got: " << arg << std::endl;
+    return false;
+  }
+
+  uint64_t len = strtoull(args[1].c_str(), nullptr, 0);
+  range.base = strtoul(args[0].c_str(), nullptr, 0);
+  range.end = range.base + len;
+  range.read = true;
+  range.write = true;
+  range.action = kMemWatchLog;
+  range.hits = 0;
+
+  if (len == 0) {
+    std::cerr << "ERROR: Empty watch range: " << arg << std::endl;
+    return false;
+  }
+
+  for (size_t j = 2; j <= i; ++j) {
+    if (args[j].compare("r") == 0 || args[j].compare("w") == 0 ||
+        args[j].compare("rw") == 0) {
+      range.read = args[j].find('r') != std::string::npos;
+      range.write = args[j].find('w') != std::string::npos;
+    } else if (args[j].compare("stop") == 0) {
+      range.action = kMemWatchStop;
+    } else if (args[j].compare("trace") == 0) {
+      range.action = kMemWatchTrace;
+    } else {
+      std::cerr << "ERROR: Unknown watch option: " << args[j] << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
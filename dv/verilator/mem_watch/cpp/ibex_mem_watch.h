@@ -0,0 +1,189 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_MEM_WATCH_H_
+#define IBEX_MEM_WATCH_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+enum MemWatchAction {
+  kMemWatchLog = 0,  // Only log the access
+  kMemWatchStop,     // Stop the simulation after the access
+  kMemWatchTrace,    // Enable waveform tracing from the access onwards
+};
+
+struct MemWatchRange {
+  uint32_t base;          // First address of the range
+  uint64_t end;           // First address after the range
+  bool read;              // Watch reads
+  bool write;             // Watch writes
+  MemWatchAction action;  // Action taken on a hit
+  unsigned long hits;     // Number of accesses which hit the range
+};
+
+/**
+ * Binary log file format
+ *
+ * The log starts with a MemWatchLogHeader, followed by one MemWatchLogRecord
+ * per hit. All fields are little-endian.
+ */
+struct MemWatchLogHeader {
+  char magic[8];         // "IBEXWTCH"
+  uint32_t version;      // kMemWatchLogVersion
+  uint32_t record_size;  // sizeof(MemWatchLogRecord)
+};
+
+struct MemWatchLogRecord {
+  uint64_t cycle;  // Clock cycle of the grant (writes) or response (reads)
+  uint32_t pc;     // PC of the instruction making the access
+  uint32_t addr;   // Word address of the access
+  uint32_t data;   // Write data or read data
+  uint8_t be;      // Byte enables of the access
+  uint8_t we;      // 1 for writes, 0 for reads
+  uint16_t watch;  // Index of the first range hit, in command line order
+};
+
+static const uint32_t kMemWatchLogVersion = 1;
+
+/**
+ * Memory watchpoints for Verilator simulations
+ *
+ * Checks the accesses observed by one mem_watch module (see rtl/mem_watch.sv)
+ * against a set of address ranges and logs every hit to a compact binary log
+ * file. The ranges are kept sorted by base address together with the running
+ * maximum of their end addresses: a lookup is a binary search followed by a
+ * backward walk over the ranges which may still overlap the access. This is
+ * cheap for many small ranges, but degrades to a walk over all earlier ranges
+ * if one of them is wide.
+ *
+ * The watchpoints are configured on the command line:
+ *
+ * --watch=ADDR,LEN[,r|w|rw][,stop|trace]
+ *   Watch accesses to [ADDR, ADDR + LEN), reads, writes or both (default).
+ *   'stop' ends the simulation after the first hit, 'trace' enables waveform
+ *   tracing (if compiled in) from the first hit onwards. Can be given multiple
+ *   times.
+ *
+ * --watch-log=FILE
+ *   Write the binary log to FILE instead of the default file name.
+ */
+class IbexMemWatch : public SimCtrlExtension {
+ public:
+  /**
+   * @param log_filename Default name of the binary log file
+   */
+  IbexMemWatch(const std::string &log_filename);
+  ~IbexMemWatch();
+
+  /**
+   * Parse command line arguments
+   *
+   * Process all recognized command-line arguments from argc/argv.
+   *
+   * @param argc, argv Standard C command line arguments
+   * @param exit_app Indicate that program should terminate
+   * @return Return code, true == success
+   */
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app);
+
+  /**
+   * Open the log file
+   */
+  virtual void PreExec();
+
+  /**
+   * Flush and close the log file
+   */
+  virtual void PostExec();
+
+  /**
+   * Have any watchpoints been configured?
+   */
+  bool IsEnabled() const { return !ranges_.empty(); }
+
+  /**
+   * Check a granted request against the watched ranges
+   *
+   * Hits on writes are logged immediately. For reads the hit is logged once
+   * ReadData() provides the data, reads which hit are queued until then.
+   *
+   * @return true if the request hit a watched range
+   */
+  bool Access(uint32_t pc, uint32_t addr, bool we, uint8_t be,
+              uint32_t wdata);
+
+  /**
+   * Log the data of the oldest queued read which hit a watched range
+   */
+  void ReadData(uint32_t rdata);
+
+  /**
+   * Returns a formatted string of the number of hits per range
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  std::vector<MemWatchRange> ranges_;
+
+  // Range indices sorted by base address, and for each position the maximum
+  // end address of all ranges up to it
+  std::vector<size_t> sorted_;
+  std::vector<uint64_t> max_end_;
+  uint32_t min_base_;
+  uint64_t max_end_all_;
+
+  std::string log_filename_;
+  FILE *log_file_;
+
+  // A read which hit watched ranges and waits for its data
+  struct PendingRead {
+    MemWatchLogRecord record;
+    std::vector<size_t> hits;  // Ranges hit, in command line order
+  };
+
+  // Ranges hit by the last access
+  std::vector<size_t> hits_;
+  // Reads in flight which hit watched ranges, oldest first. More than one
+  // read can be in flight, e.g. for misaligned loads.
+  std::deque<PendingRead> pending_reads_;
+
+  /**
+   * Print help how to use this tool
+   */
+  void PrintHelp() const;
+
+  /**
+   * Parse a watchpoint argument in the form of ADDR,LEN[,r|w|rw][,stop|trace]
+   */
+  bool ParseWatchArg(const std::string &arg, MemWatchRange &range) const;
+
+  /**
+   * Build the sorted range list from |ranges_|
+   */
+  void BuildIndex();
+
+  /**
+   * Find all ranges which overlap [|first|, |last|] and watch the access type
+   *
+   * @param hits Indices of the ranges found, in command line order
+   */
+  void Lookup(uint64_t first, uint64_t last, bool we,
+              std::vector<size_t> &hits) const;
+
+  /**
+   * Log an access and take the actions of all ranges in |hits|
+   */
+  void Hit(const MemWatchLogRecord &record, const std::vector<size_t> &hits);
+};
+
+#endif  // IBEX_MEM_WATCH_H_
@@ -0,0 +1,92 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Memory watchpoint monitor for simulation
+ *
+ * Observes a bus host port (e.g. the data port of Ibex) and passes every granted request to the
+ * C++ watchpoint model (see dv/verilator/mem_watch/cpp/ibex_mem_watch.h), which checks it against
+ * the watched address ranges. Writes are logged on the grant, reads once their data returns.
+ *
+ * Responses are assumed to arrive in order, one per granted request (reads and writes), with at
+ * most MaxOutstanding requests in flight. The Ibex LSU has up to two: the second request of a
+ * misaligned access is sent before the response to the first one arrives. If no watchpoints are
+ * configured the monitor makes no DPI calls at all.
+ */
+module mem_watch #(
+  parameter int unsigned MaxOutstanding = 2
+) (
+  input              clk_i,
+  input              rst_ni,
+
+  input              req_i,
+  input              gnt_i,
+  input       [31:0] addr_i,
+  input              we_i,
+  input       [ 3:0] be_i,
+  input       [31:0] wdata_i,
+  input              rvalid_i,
+  input       [31:0] rdata_i,
+
+  // PC of the instruction issuing the request
+  input       [31:0] pc_i
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function bit mem_watch_enabled();
+
+  import "DPI-C" function bit mem_watch_access(input bit [31:0] pc, input bit [31:0] addr,
+                                               input bit we, input bit [3:0] be,
+                                               input bit [31:0] wdata);
+
+  import "DPI-C" function void mem_watch_rdata(input bit [31:0] rdata);
+`endif
+
+  localparam int unsigned CountW = $clog2(MaxOutstanding + 1);
+
+  logic enabled;
+
+  // One bit per outstanding request, set for reads which hit a watched range. The oldest request
+  // is at bit 0, bits at and above |outstanding_q| are zero.
+  logic [2**CountW-1:0] read_hit_q;
+  logic [CountW-1:0]    outstanding_q;
+  // Position of a request granted in this cycle, after the response of this cycle is removed
+  logic [CountW-1:0]    push_idx;
+
+  assign push_idx = outstanding_q - CountW'(rvalid_i);
+
+  initial begin
+`ifdef VERILATOR
+    enabled = mem_watch_enabled();
+`else
+    enabled = 1'b0;
+`endif
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      read_hit_q    <= '0;
+      outstanding_q <= '0;
+    end else if (enabled) begin
+`ifdef VERILATOR
+      if (rvalid_i) begin
+        if (read_hit_q[0]) begin
+          mem_watch_rdata(rdata_i);
+        end
+        read_hit_q <= read_hit_q >> 1;
+      end
+
+      if (req_i && gnt_i) begin
+        // Hits on writes are logged immediately, hits on reads once the data returns
+        if (mem_watch_access(pc_i, addr_i, we_i, be_i, wdata_i) && !we_i) begin
+          read_hit_q[push_idx] <= 1'b1;
+        end
+      end
+
+      outstanding_q <= outstanding_q + CountW'(req_i && gnt_i) - CountW'(rvalid_i);
+`endif
+    end
+  end
+
+endmodule
@@ -2,8 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <numeric>
-#include <sstream>
+#include <cassert>
 #include <string>
 #include <vector>
 
@@ -11,9 +10,12 @@
 
 extern "C" {
 extern long long mhpmcounter_get(int index);
+extern int icache_counter_num();
+extern long long icache_counter_get(int index);
 }
 
 #include "ibex_pcounts.h"
+#include "ibex_stats_format.h"
 
 // see mhpmcounter_incr signals in rtl/ibex_cs_registers.sv for details
 
@@ -32,34 +34,35 @@ const std::vector<std::string> ibex_counter_names = {
     "Multiply Wait",
     "Divide Wait"};
 
-std::string ibex_pcount_string(bool csv) {
-  char seperator = csv ? ',' : ':';
-  std::string::size_type longest_name_length;
+// see perf_event signals in rtl/ibex_icache.sv for details
 
-  if (!csv) {
-    longest_name_length = 0;
-    for (const std::string &counter_name : ibex_counter_names) {
-      longest_name_length = std::max(longest_name_length, counter_name.length());
-    }
+const std::vector<std::string> ibex_icache_counter_names = {
+    "ICache Lookups",
+    "ICache Hits",
+    "ICache Misses",
+    "ICache Fills",
+    "ICache Fill Buffer Stalls",
+    "ICache Invalidations",
+    "ICache ECC Errors"};
 
-    // Add 1 to always get at least once space after the seperator
-    longest_name_length++;
-  }
+std::string ibex_pcount_string(bool csv) {
+  // The ICache counters only exist if the core has been built with an ICache
+  int num_icache_counters = icache_counter_num();
+  assert(num_icache_counters == 0 ||
+         static_cast<size_t>(num_icache_counters) ==
+             ibex_icache_counter_names.size());
 
-  std::stringstream pcount_ss;
+  StatValues values;
 
   for (int i = 0; i < ibex_counter_names.size(); ++i) {
-    pcount_ss << ibex_counter_names[i] << seperator;
-
-    if (!csv) {
-      int padding = longest_name_length - ibex_counter_names[i].length();
-
-      for (int j = 0; j < padding; ++j)
-        pcount_ss << ' ';
-    }
+    values.emplace_back(ibex_counter_names[i],
+                        std::to_string(mhpmcounter_get(i)));
+  }
 
-    pcount_ss << mhpmcounter_get(i) << std::endl;
+  for (int i = 0; i < num_icache_counters; ++i) {
+    values.emplace_back(ibex_icache_counter_names[i],
+                        std::to_string(icache_counter_get(i)));
   }
 
-  return pcount_ss.str();
+  return FormatStats(values, csv);
 }
@@ -10,6 +10,7 @@
 #include <vector>
 
 extern const std::vector<std::string> ibex_counter_names;
+extern const std::vector<std::string> ibex_icache_counter_names;
 
 /**
  * Returns a formatted string of performance counter values
@@ -19,20 +20,12 @@ extern const std::vector<std::string> ibex_counter_names;
  * mhpmcounter array should be compatible with the type of pcounts here and so
  * can be passed in directly to this function.
  *
- * There are two options for string formatting, csv or pretty-print. Both
- * produce one counter name and value per line. csv just separates them with a
- * comma and no further formatting. pretty-print uses a colon and aligns the
- * values.
+ * If the core has been built with an instruction cache, the simulation-only
+ * event counters of ibex_icache (hits, misses, fills, ...) are appended after
+ * the mhpmcounter values, using the names in ibex_icache_counter_names.
  *
- * csv (csv == true):
- * countername1, 1234
- * longercountername1, 43980
- * ...
- *
- * pretty-print (csv == false):
- * countername1:       1234
- * longercountername1: 43980
- * ...
+ * The counters are formatted with FormatStats(), as csv or pretty-print with
+ * one counter name and value per line.
  *
  * @param csv Choose csv or pretty-print formatting
  * @return String of formatted performance counter values, newline at end
@@ -0,0 +1,45 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_stats_format.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+void AddStat(StatValues &values, const std::string &name, uint64_t value) {
+  values.emplace_back(name, std::to_string(value));
+}
+
+void AddStatRatio(StatValues &values, const std::string &name, double value) {
+  std::ostringstream value_ss;
+  value_ss << std::fixed << std::setprecision(3) << value;
+  values.emplace_back(name, value_ss.str());
+}
+
+std::string FormatStats(const StatValues &values, bool csv) {
+  char separator = csv ? ',' : ':';
+
+  std::string::size_type longest_name_length = 0;
+  if (!csv) {
+    for (const auto &value : values) {
+      longest_name_length = std::max(longest_name_length, value.first.length());
+    }
+
+    // Add 1 to always get at least one space after the separator
+    longest_name_length++;
+  }
+
+  std::stringstream stats_ss;
+
+  for (const auto &value : values) {
+    stats_ss << value.first << separator;
+    if (!csv) {
+      stats_ss << std::string(longest_name_length - value.first.length(), ' ');
+    }
+    stats_ss << value.second << std::endl;
+  }
+
+  return stats_ss.str();
+}
@@ -0,0 +1,50 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_STATS_FORMAT_H_
+#define IBEX_STATS_FORMAT_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Statistic names and their formatted values, in report order
+typedef std::vector<std::pair<std::string, std::string>> StatValues;
+
+/**
+ * Appends an integer statistic to |values|
+ */
+void AddStat(StatValues &values, const std::string &name, uint64_t value);
+
+/**
+ * Appends a ratio (or other real valued statistic) to |values|, formatted with
+ * three decimal places
+ */
+void AddStatRatio(StatValues &values, const std::string &name, double value);
+
+/**
+ * Returns a formatted string of statistics
+ *
+ * There are two options for string formatting, csv or pretty-print. Both
+ * produce one name and value per line. csv just separates them with a comma
+ * and no further formatting. pretty-print uses a colon and aligns the values.
+ *
+ * csv (csv == true):
+ * countername1,1234
+ * longercountername1,43980
+ * ...
+ *
+ * pretty-print (csv == false):
+ * countername1:       1234
+ * longercountername1: 43980
+ * ...
+ *
+ * @param values Names and values to format
+ * @param csv Choose csv or pretty-print formatting
+ * @return String of formatted statistics, newline at end
+ */
+std::string FormatStats(const StatValues &values, bool csv);
+
+#endif  // IBEX_STATS_FORMAT_H_
@@ -0,0 +1,52 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_tb_driver.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "verilator_sim_ctrl.h"
+
+int RunTestbench(VerilatedToplevel *top, CData *sig_clk, CData *sig_rst_n,
+                 IbexTestbench &bench, const std::string &name,
+                 const std::string &csv_filename, int argc, char **argv) {
+  VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
+  simctrl.SetTop(top, sig_clk, sig_rst_n,
+                 VerilatorSimCtrlFlags::ResetPolarityNegative);
+  simctrl.RegisterExtension(&bench);
+
+  bool exit_app = false;
+  int ret_code = simctrl.ParseCommandArgs(argc, argv, exit_app);
+  if (exit_app) {
+    return ret_code;
+  }
+
+  std::string title = name + " Testbench";
+  std::cout << title << std::endl
+            << std::string(title.size(), '=') << std::endl
+            << std::endl;
+
+  simctrl.RunSimulation();
+
+  if (!simctrl.WasSimulationSuccessful()) {
+    return 1;
+  }
+
+  title = name + " Statistics";
+  std::cout << "\n"
+            << title << std::endl
+            << std::string(title.size(), '=') << std::endl;
+  std::cout << bench.ReportString(false);
+
+  std::ofstream stats_csv(csv_filename);
+  stats_csv << bench.ReportString(true);
+
+  if (!bench.Passed()) {
+    std::cout << "\nTEST FAILED" << std::endl;
+    return 1;
+  }
+  std::cout << "\nTEST PASSED" << std::endl;
+  return 0;
+}
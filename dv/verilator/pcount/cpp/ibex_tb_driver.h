@@ -0,0 +1,50 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_TB_DRIVER_H_
+#define IBEX_TB_DRIVER_H_
+
+#include <string>
+
+#include "sim_ctrl_extension.h"
+#include "verilated_toplevel.h"
+
+/**
+ * Driver and scoreboard of a unit testbench run by RunTestbench()
+ */
+class IbexTestbench : public SimCtrlExtension {
+ public:
+  /**
+   * Did all checks pass?
+   */
+  virtual bool Passed() const = 0;
+
+  /**
+   * Returns a formatted string of the bench statistics
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  virtual std::string ReportString(bool csv) const = 0;
+};
+
+/**
+ * Runs a unit testbench and reports its statistics
+ *
+ * Parses the command line, runs the simulation, prints the statistics of
+ * |bench| and writes them to |csv_filename|.
+ *
+ * @param top Verilated toplevel of the testbench
+ * @param sig_clk, sig_rst_n Clock and active-low reset of the toplevel
+ * @param bench Driver registered as extension of the simulation
+ * @param name Name of the unit under test used in the headings, e.g. "ALU"
+ * @param csv_filename File the statistics are written to
+ * @param argc, argv Standard C command line arguments
+ * @return Exit code of the testbench, 0 if all checks passed
+ */
+int RunTestbench(VerilatedToplevel *top, CData *sig_clk, CData *sig_rst_n,
+                 IbexTestbench &bench, const std::string &name,
+                 const std::string &csv_filename, int argc, char **argv);
+
+#endif  // IBEX_TB_DRIVER_H_
@@ -0,0 +1,212 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_roi.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <svdpi.h>
+
+#include "ibex_pcounts.h"
+
+extern "C" {
+extern long long mhpmcounter_get(int index);
+}
+
+// Indices into ibex_counter_names
+static const int kCounterCycles = 0;
+static const int kCounterInstrRet = 2;
+
+// The instance accessed by the DPI functions below
+static IbexRoi *roi_instance = nullptr;
+
+// DPI Imports
+extern "C" {
+
+void ibex_roi_marker(int id, svBit is_begin) {
+  if (roi_instance) {
+    roi_instance->Marker(static_cast<uint32_t>(id), is_begin);
+  }
+}
+}
+
+void RoiStat::Add(double value) {
+  if (count == 0 || value < min) {
+    min = value;
+  }
+  if (count == 0 || value > max) {
+    max = value;
+  }
+  sum += value;
+  count++;
+}
+
+IbexRoi::IbexRoi() : unmatched_ends_(0) {
+  assert(!roi_instance && "Only one IbexRoi instance is supported.");
+  roi_instance = this;
+}
+
+IbexRoi::~IbexRoi() { roi_instance = nullptr; }
+
+void IbexRoi::AddValue(const std::string &name,
+                       std::function<double()> sample) {
+  value_names_.push_back(name);
+  value_samples_.push_back(sample);
+}
+
+void IbexRoi::Marker(uint32_t id, bool is_begin) {
+  if (is_begin) {
+    records_[id].open.push_back(TakeSnapshot());
+    return;
+  }
+
+  auto record_it = records_.find(id);
+  if (record_it == records_.end() || record_it->second.open.empty()) {
+    std::cerr << "WARNING: End of region " << id
+              << " without a matching begin, ignoring it." << std::endl;
+    unmatched_ends_++;
+    return;
+  }
+
+  RoiRecord &record = record_it->second;
+  RoiSnapshot end = TakeSnapshot();
+  const RoiSnapshot &begin = record.open.back();
+
+  record.counters.resize(end.counters.size());
+  for (size_t i = 0; i < end.counters.size(); ++i) {
+    record.counters[i].Add(end.counters[i] - begin.counters[i]);
+  }
+
+  record.values.resize(end.values.size());
+  for (size_t i = 0; i < end.values.size(); ++i) {
+    record.values[i].Add(end.values[i] - begin.values[i]);
+  }
+
+  uint64_t cycles =
+      end.counters[kCounterCycles] - begin.counters[kCounterCycles];
+  uint64_t instrs =
+      end.counters[kCounterInstrRet] - begin.counters[kCounterInstrRet];
+  if (instrs) {
+    record.cpi.Add(static_cast<double>(cycles) / instrs);
+  }
+
+  record.wall_time_us.Add(
+      std::chrono::duration_cast<std::chrono::microseconds>(end.wall_time -
+                                                            begin.wall_time)
+          .count());
+
+  record.open.pop_back();
+}
+
+bool IbexRoi::HasRegions() const { return !records_.empty(); }
+
+std::string IbexRoi::ReportString(bool csv) const {
+  std::stringstream report_ss;
+
+  if (csv) {
+    report_ss << "id,name,count,min,mean,max" << std::endl;
+  }
+
+  for (const auto &id_record : records_) {
+    uint32_t id = id_record.first;
+    const RoiRecord &record = id_record.second;
+
+    std::vector<std::string> names;
+    std::vector<const RoiStat *> stats;
+
+    for (size_t i = 0; i < record.counters.size(); ++i) {
+      // Skip unused counter slots
+      if (ibex_counter_names[i] == "NONE") {
+        continue;
+      }
+      names.push_back(ibex_counter_names[i]);
+      stats.push_back(&record.counters[i]);
+    }
+    for (size_t i = 0; i < record.values.size(); ++i) {
+      names.push_back(value_names_[i]);
+      stats.push_back(&record.values[i]);
+    }
+    names.push_back("CPI");
+    stats.push_back(&record.cpi);
+    names.push_back("Wall Time (us)");
+    stats.push_back(&record.wall_time_us);
+
+    if (csv) {
+      if (record.wall_time_us.count == 0) {
+        continue;
+      }
+      for (size_t i = 0; i < names.size(); ++i) {
+        const RoiStat &stat = *stats[i];
+        report_ss << id << ',' << names[i] << ',' << stat.count << ','
+                  << stat.min << ','
+                  << (stat.count ? stat.sum / stat.count : 0.0) << ','
+                  << stat.max << std::endl;
+      }
+      continue;
+    }
+
+    report_ss << "Region " << id << ": " << record.wall_time_us.count
+              << " execution(s)";
+    if (!record.open.empty()) {
+      report_ss << ", " << record.open.size() << " not ended";
+    }
+    report_ss << std::endl;
+
+    if (record.wall_time_us.count == 0) {
+      continue;
+    }
+
+    std::string::size_type longest_name_length = 0;
+    for (const std::string &name : names) {
+      longest_name_length = std::max(longest_name_length, name.length());
+    }
+
+    // Add 1 to always get at least one space after the colon
+    longest_name_length++;
+
+    report_ss << std::string(longest_name_length + 3, ' ') << std::setw(14)
+              << "min" << std::setw(14) << "mean" << std::setw(14) << "max"
+              << std::endl;
+
+    for (size_t i = 0; i < names.size(); ++i) {
+      const RoiStat &stat = *stats[i];
+      report_ss << "  " << names[i] << ':'
+                << std::string(longest_name_length - names[i].length(), ' ');
+      if (stat.count) {
+        report_ss << std::fixed << std::setprecision(2) << std::setw(14)
+                  << stat.min << std::setw(14) << stat.sum / stat.count
+                  << std::setw(14) << stat.max;
+      } else {
+        report_ss << std::setw(14) << '-' << std::setw(14) << '-'
+                  << std::setw(14) << '-';
+      }
+      report_ss << std::defaultfloat << std::endl;
+    }
+  }
+
+  if (!csv && unmatched_ends_) {
+    report_ss << unmatched_ends_ << " region end(s) without a matching begin"
+              << std::endl;
+  }
+
+  return report_ss.str();
+}
+
+RoiSnapshot IbexRoi::TakeSnapshot() const {
+  RoiSnapshot snapshot;
+
+  for (size_t i = 0; i < ibex_counter_names.size(); ++i) {
+    snapshot.counters.push_back(mhpmcounter_get(i));
+  }
+  for (const auto &sample : value_samples_) {
+    snapshot.values.push_back(sample());
+  }
+  snapshot.wall_time = std::chrono::steady_clock::now();
+
+  return snapshot;
+}
@@ -0,0 +1,107 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_ROI_H_
+#define IBEX_ROI_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sim_ctrl_extension.h"
+
+// Minimum, maximum and mean of a value over all executions of a region
+struct RoiStat {
+  unsigned long count;
+  double min;
+  double max;
+  double sum;
+
+  RoiStat() : count(0), min(0.0), max(0.0), sum(0.0) {}
+  void Add(double value);
+};
+
+struct RoiSnapshot {
+  std::vector<uint64_t> counters;
+  std::vector<double> values;
+  std::chrono::steady_clock::time_point wall_time;
+};
+
+struct RoiRecord {
+  std::vector<RoiSnapshot> open;  // Currently open (possibly nested) regions
+  std::vector<RoiStat> counters;  // Counter deltas, see ibex_counter_names
+  std::vector<RoiStat> values;    // Deltas of the values added by AddValue()
+  RoiStat cpi;                    // Cycles per retired instruction
+  RoiStat wall_time_us;           // Host time spent simulating the region
+};
+
+/**
+ * Region of interest (ROI) statistics for Verilator simulations
+ *
+ * Software marks regions of interest with sim_roi_begin(id) and
+ * sim_roi_end(id) (see examples/sw/simple_system/common), which are passed to
+ * this class through the ibex_roi_marker() DPI function. At every marker all
+ * performance counters are sampled through mhpmcounter_get(). At the end of a
+ * region the counter deltas, the CPI and the host wall time spent in it are
+ * recorded.
+ *
+ * Further values (e.g. an energy estimate) can be added with AddValue(), their
+ * deltas are recorded in the same way as those of the performance counters.
+ *
+ * Regions can be nested and executed multiple times, statistics of repeated
+ * executions of the same ID are aggregated into min/mean/max values.
+ */
+class IbexRoi : public SimCtrlExtension {
+ public:
+  IbexRoi();
+  ~IbexRoi();
+
+  /**
+   * Handle a region marker
+   *
+   * Must be called from a DPI context in which mhpmcounter_get() is visible.
+   *
+   * @param id Region identifier written by software
+   * @param is_begin True for sim_roi_begin(), false for sim_roi_end()
+   */
+  void Marker(uint32_t id, bool is_begin);
+
+  /**
+   * Sample a value at every marker and report its delta per region
+   *
+   * @param name Name of the value in the report
+   * @param sample Returns the current value, which must not decrease
+   */
+  void AddValue(const std::string &name, std::function<double()> sample);
+
+  /**
+   * Have any regions been marked by software?
+   */
+  bool HasRegions() const;
+
+  /**
+   * Returns a formatted string of the per-region statistics
+   *
+   * The pretty-print format contains one block per region, the csv format one
+   * line per region and value in the form "id,name,count,min,mean,max",
+   * after a header row with these column names.
+   *
+   * @param csv Choose csv or pretty-print formatting
+   * @return String of formatted statistics, newline at end
+   */
+  std::string ReportString(bool csv) const;
+
+ private:
+  std::map<uint32_t, RoiRecord> records_;
+  std::vector<std::string> value_names_;
+  std::vector<std::function<double()>> value_samples_;
+  unsigned long unmatched_ends_;
+
+  RoiSnapshot TakeSnapshot() const;
+};
+
+#endif  // IBEX_ROI_H_
@@ -0,0 +1,188 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_sparse_mem.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#include <svdpi.h>
+
+// The instances accessed by the DPI functions below, indexed by MemId
+static std::map<int, IbexSparseMem *> sparse_mem_instances;
+
+// DPI Imports
+extern "C" {
+
+int sparse_mem_read(int mem, const svBitVecVal *offset) {
+  IbexSparseMem *sparse_mem = IbexSparseMem::GetInstance(mem);
+  assert(sparse_mem && "No IbexSparseMem instance for MemId");
+  return sparse_mem->ReadWord(offset[0]);
+}
+
+void sparse_mem_write(int mem, const svBitVecVal *offset,
+                      const svBitVecVal *data, const svBitVecVal *be) {
+  IbexSparseMem *sparse_mem = IbexSparseMem::GetInstance(mem);
+  assert(sparse_mem && "No IbexSparseMem instance for MemId");
+  sparse_mem->WriteWord(offset[0], data[0], be[0]);
+}
+}
+
+const unsigned int IbexSparseMem::kPageBits;
+const size_t IbexSparseMem::kPageSize;
+
+IbexSparseMem::IbexSparseMem(int mem_id, size_t size_byte)
+    : mem_id_(mem_id),
+      size_byte_(size_byte),
+      last_page_idx_(0),
+      last_page_(nullptr),
+      shared_storage_(nullptr),
+      shared_header_(nullptr) {
+  auto ret = sparse_mem_instances.emplace(mem_id, this);
+  assert(ret.second && "IbexSparseMem with this MemId already exists.");
+  (void)ret;
+}
+
+IbexSparseMem::~IbexSparseMem() { sparse_mem_instances.erase(mem_id_); }
+
+IbexSparseMem *IbexSparseMem::GetInstance(int mem_id) {
+  auto it = sparse_mem_instances.find(mem_id);
+  return it == sparse_mem_instances.end() ? nullptr : it->second;
+}
+
+bool IbexSparseMem::Write(size_t offset, const uint8_t *data,
+                          size_t len_bytes) {
+  if (offset > size_byte_ || len_bytes > size_byte_ - offset) {
+    std::cerr << "ERROR: Write of " << len_bytes << " bytes at offset 0x"
+              << std::hex << offset << std::dec
+              << " exceeds the size of the memory (" << size_byte_
+              << " bytes)." << std::endl;
+    return false;
+  }
+
+  if (shared_header_) {
+    MemShmBeginWrite(shared_header_);
+  }
+
+  while (len_bytes) {
+    size_t page_offset = offset & (kPageSize - 1);
+    size_t chunk = std::min(len_bytes, kPageSize - page_offset);
+
+    memcpy(GetPage(offset >> kPageBits, true) + page_offset, data, chunk);
+
+    offset += chunk;
+    data += chunk;
+    len_bytes -= chunk;
+  }
+
+  if (shared_header_) {
+    MemShmEndWrite(shared_header_);
+  }
+
+  return true;
+}
+
+bool IbexSparseMem::Read(size_t offset, uint8_t *data, size_t len_bytes) {
+  if (offset > size_byte_ || len_bytes > size_byte_ - offset) {
+    return false;
+  }
+
+  while (len_bytes) {
+    size_t page_offset = offset & (kPageSize - 1);
+    size_t chunk = std::min(len_bytes, kPageSize - page_offset);
+
+    uint8_t *page = GetPage(offset >> kPageBits, false);
+    if (page) {
+      memcpy(data, page + page_offset, chunk);
+    } else {
+      memset(data, 0, chunk);
+    }
+
+    offset += chunk;
+    data += chunk;
+    len_bytes -= chunk;
+  }
+
+  return true;
+}
+
+uint32_t IbexSparseMem::ReadWord(uint32_t offset) {
+  assert((offset & 0x3) == 0);
+
+  uint8_t *page = GetPage(offset >> kPageBits, false);
+  if (!page) {
+    return 0;
+  }
+
+  uint32_t word;
+  memcpy(&word, page + (offset & (kPageSize - 1)), sizeof(word));
+  return word;
+}
+
+void IbexSparseMem::WriteWord(uint32_t offset, uint32_t data, uint8_t be) {
+  assert((offset & 0x3) == 0);
+
+  uint8_t *bytes =
+      GetPage(offset >> kPageBits, true) + (offset & (kPageSize - 1));
+
+  if (shared_header_) {
+    MemShmBeginWrite(shared_header_);
+  }
+  for (int i = 0; i < 4; ++i) {
+    if (be & (1 << i)) {
+      bytes[i] = (data >> (8 * i)) & 0xff;
+    }
+  }
+  if (shared_header_) {
+    MemShmEndWrite(shared_header_);
+  }
+}
+
+bool IbexSparseMem::UseSharedStorage(uint8_t *storage, MemShmHeader *header) {
+  for (const auto &page : pages_) {
+    size_t page_offset = page.first << kPageBits;
+    if (page_offset >= size_byte_) {
+      continue;
+    }
+    memcpy(storage + page_offset, page.second.get(),
+           std::min(kPageSize, size_byte_ - page_offset));
+  }
+  pages_.clear();
+
+  // The storage is a sparse file mapping, so host memory is still only
+  // allocated for pages which are touched.
+  shared_storage_ = storage;
+  shared_header_ = header;
+  last_page_ = nullptr;
+  return true;
+}
+
+uint8_t *IbexSparseMem::GetPage(size_t page_idx, bool alloc) {
+  if (last_page_ && last_page_idx_ == page_idx) {
+    return last_page_;
+  }
+
+  if (shared_storage_) {
+    assert((page_idx << kPageBits) < size_byte_);
+    return shared_storage_ + (page_idx << kPageBits);
+  }
+
+  auto it = pages_.find(page_idx);
+  if (it == pages_.end()) {
+    if (!alloc) {
+      return nullptr;
+    }
+    // Value-initialize, untouched memory reads as zero
+    it = pages_.emplace(page_idx, std::unique_ptr<uint8_t[]>(
+                                      new uint8_t[kPageSize]()))
+             .first;
+  }
+
+  last_page_idx_ = page_idx;
+  last_page_ = it->second.get();
+  return last_page_;
+}
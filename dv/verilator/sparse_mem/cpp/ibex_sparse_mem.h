@@ -0,0 +1,98 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_SPARSE_MEM_H_
+#define IBEX_SPARSE_MEM_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "verilator_memutil.h"
+
+/**
+ * Sparse, host-backed storage for sparse_ram_2p (see rtl/sparse_ram_2p.sv)
+ *
+ * Memory contents are kept in pages of kPageSize bytes which are only
+ * allocated when they are first written, reads from untouched pages return
+ * zero. The RTL accesses the memory word by word through DPI, memory images
+ * are written directly into the pages by VerilatorMemUtil, e.g.
+ *
+ *   IbexSparseMem ram(0, 1024 * 1024);
+ *   memutil.RegisterMemoryArea("ram", "TOP.top.u_ram", 32, &ram);
+ *
+ * One instance has to exist for every sparse_ram_2p instance, |mem_id| matches
+ * the MemId parameter of the RTL instance.
+ */
+class IbexSparseMem : public HostMem {
+ public:
+  static const unsigned int kPageBits = 12;
+  static const size_t kPageSize = size_t(1) << kPageBits;
+
+  /**
+   * @param mem_id MemId parameter of the sparse_ram_2p instance
+   * @param size_byte Size of the memory in bytes
+   */
+  IbexSparseMem(int mem_id, size_t size_byte);
+  ~IbexSparseMem();
+
+  /**
+   * Write a block of data, allocating pages as required
+   */
+  virtual bool Write(size_t offset, const uint8_t *data, size_t len_bytes);
+
+  /**
+   * Read a block of data, untouched memory reads as zero
+   */
+  bool Read(size_t offset, uint8_t *data, size_t len_bytes);
+
+  /**
+   * Word access from the DPI functions, |offset| must be word aligned
+   */
+  uint32_t ReadWord(uint32_t offset);
+  void WriteWord(uint32_t offset, uint32_t data, uint8_t be);
+
+  /**
+   * Number of pages allocated so far (none once shared storage is used)
+   */
+  size_t PagesAllocated() const { return pages_.size(); }
+
+  virtual size_t SizeBytes() const { return size_byte_; }
+
+  /**
+   * Move all pages into flat (shared-memory) storage
+   *
+   * Used by VerilatorMemUtil with --mem-shm, memory accesses then go directly
+   * to |storage| and modifications are published through |header|.
+   */
+  virtual bool UseSharedStorage(uint8_t *storage, MemShmHeader *header);
+
+  /**
+   * Returns the instance for |mem_id|, or nullptr if none exists
+   */
+  static IbexSparseMem *GetInstance(int mem_id);
+
+ private:
+  int mem_id_;
+  size_t size_byte_;
+  std::unordered_map<size_t, std::unique_ptr<uint8_t[]>> pages_;
+
+  // Most recently accessed page, accesses are highly local
+  size_t last_page_idx_;
+  uint8_t *last_page_;
+
+  // Flat storage and its shared-memory header, see UseSharedStorage()
+  uint8_t *shared_storage_;
+  MemShmHeader *shared_header_;
+
+  /**
+   * Returns the page with index |page_idx|
+   *
+   * @param alloc Allocate the page if it doesn't exist yet
+   * @return The page, or nullptr if it doesn't exist and |alloc| is false
+   */
+  uint8_t *GetPage(size_t page_idx, bool alloc);
+};
+
+#endif  // IBEX_SPARSE_MEM_H_
@@ -0,0 +1,142 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Dual-port RAM with 1 cycle read/write delay, 32 bit words, host-backed storage
+ *
+ * Drop-in replacement for ram_2p (see shared/rtl/ram_2p.sv) for simulation. In Verilator the
+ * memory contents live in a page-granular sparse map in C++ (see
+ * dv/verilator/sparse_mem/cpp/ibex_sparse_mem.h), accessed through DPI. Only pages which are
+ * written allocate host memory, so large address spaces neither slow down compilation nor increase
+ * the size of the model. Other simulators use a SystemVerilog associative array instead.
+ *
+ * MemInitFile is not supported, memories are initialized through VerilatorMemUtil.
+ */
+module sparse_ram_2p #(
+    parameter int          Depth = 128,
+    // Identifies this memory to the C++ model
+    parameter int unsigned MemId = 0
+) (
+    input               clk_i,
+    input               rst_ni,
+
+    input               a_req_i,
+    input               a_we_i,
+    input        [ 3:0] a_be_i,
+    input        [31:0] a_addr_i,
+    input        [31:0] a_wdata_i,
+    output logic        a_rvalid_o,
+    output logic [31:0] a_rdata_o,
+
+    input               b_req_i,
+    input               b_we_i,
+    input        [ 3:0] b_be_i,
+    input        [31:0] b_addr_i,
+    input        [31:0] b_wdata_i,
+    output logic        b_rvalid_o,
+    output logic [31:0] b_rdata_o
+);
+
+`ifdef VERILATOR
+  import "DPI-C" function int sparse_mem_read(input int mem, input bit [31:0] offset);
+
+  import "DPI-C" function void sparse_mem_write(input int mem, input bit [31:0] offset,
+                                                input bit [31:0] data, input bit [3:0] be);
+
+  // The word access DPI exports of prim_util_memload.svh, so that the memory can be accessed like
+  // a generic ram if no generic ram exists in the design. Memory images are written directly into
+  // the C++ model by VerilatorMemUtil.
+  export "DPI-C" function simutil_verilator_set_mem;
+
+  function int simutil_verilator_set_mem(input int         index,
+                                         input bit [255:0] val);
+    if (index >= Depth) begin
+      return 0;
+    end
+
+    sparse_mem_write(MemId, 32'(index) << 2, val[31:0], 4'hF);
+    return 1;
+  endfunction
+
+  export "DPI-C" function simutil_verilator_get_mem;
+
+  function int simutil_verilator_get_mem(input int          index,
+                                         output bit [255:0] val);
+    if (index >= Depth) begin
+      return 0;
+    end
+
+    val = 0;
+    val[31:0] = sparse_mem_read(MemId, 32'(index) << 2);
+    return 1;
+  endfunction
+`else
+  logic [31:0] mem [bit [31:0]];
+`endif
+
+  localparam int Aw = $clog2(Depth);
+
+  // Byte offsets into the memory
+  logic [31:0] a_offset;
+  logic [31:0] b_offset;
+  assign a_offset = {{(30-Aw){1'b0}}, a_addr_i[Aw-1+2:2], 2'b00};
+  assign b_offset = {{(30-Aw){1'b0}}, b_addr_i[Aw-1+2:2], 2'b00};
+
+  logic [31-Aw:0] unused_a_addr_parts;
+  assign unused_a_addr_parts = {a_addr_i[31:Aw+2], a_addr_i[1:0]};
+  logic [31-Aw:0] unused_b_addr_parts;
+  assign unused_b_addr_parts = {b_addr_i[31:Aw+2], b_addr_i[1:0]};
+
+  function automatic logic [31:0] mem_read(logic [31:0] offset);
+`ifdef VERILATOR
+    return sparse_mem_read(MemId, offset);
+`else
+    return mem.exists(offset) ? mem[offset] : '0;
+`endif
+  endfunction
+
+  function automatic void mem_write(logic [31:0] offset, logic [31:0] data, logic [3:0] be);
+`ifdef VERILATOR
+    sparse_mem_write(MemId, offset, data, be);
+`else
+    logic [31:0] word;
+    word = mem.exists(offset) ? mem[offset] : '0;
+    for (int i = 0; i < 4; i++) begin
+      if (be[i]) begin
+        word[8*i+:8] = data[8*i+:8];
+      end
+    end
+    mem[offset] = word;
+`endif
+  endfunction
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      a_rvalid_o <= '0;
+      b_rvalid_o <= '0;
+    end else begin
+      a_rvalid_o <= a_req_i;
+      b_rvalid_o <= b_req_i;
+    end
+  end
+
+  // A single process for both ports so that reads always observe the memory contents from before
+  // the writes of the same cycle, as with the non-blocking writes of prim_generic_ram_2p. Like
+  // there, read data is only updated by reads.
+  always_ff @(posedge clk_i) begin
+    if (a_req_i && !a_we_i) begin
+      a_rdata_o <= mem_read(a_offset);
+    end
+    if (b_req_i && !b_we_i) begin
+      b_rdata_o <= mem_read(b_offset);
+    end
+    if (a_req_i && a_we_i) begin
+      mem_write(a_offset, a_wdata_i, a_be_i);
+    end
+    if (b_req_i && b_we_i) begin
+      mem_write(b_offset, b_wdata_i, b_be_i);
+    end
+  end
+
+endmodule
@@ -0,0 +1,409 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <gelf.h>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <libelf.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "ibex_bus_monitor.h"
+#include "ibex_pcounts.h"
+#include "ibex_sparse_mem.h"
+#include "ibex_stats_format.h"
+#include "sim_ctrl_extension.h"
+#include "verilated_toplevel.h"
+#include "verilator_memutil.h"
+#include "verilator_sim_ctrl.h"
+
+extern "C" {
+extern int multicore_num_cores();
+extern void mhpmcounter_select_core(int core);
+extern long long mhpmcounter_get(int index);
+extern long long bus_grants_get(int host);
+extern long long bus_stalls_get(int host);
+}
+
+// Each core sees its slice of the shared RAM at this address, see
+// rtl/ibex_multicore_system.sv
+static const uint32_t kCoreRamBase = 0x100000;
+static const size_t kCoreRamSize = 1024 * 1024;
+
+// Indices of the cycle and retired instruction counters for mhpmcounter_get()
+static const int kCounterCycles = 0;
+static const int kCounterInstrRet = 2;
+
+/**
+ * View of the RAM slices of one or all cores in the shared RAM
+ *
+ * Registered as memory area with VerilatorMemUtil so that programs are loaded
+ * into the slice of a core as they would be into the RAM of
+ * ibex_simple_system.
+ */
+class CoreRamView : public HostMem {
+ public:
+  /**
+   * @param first_core, num_cores Cores whose slices images are written to
+   */
+  CoreRamView(IbexSparseMem *ram, int first_core, int num_cores)
+      : ram_(ram), first_core_(first_core), num_cores_(num_cores) {}
+
+  virtual bool Write(size_t offset, const uint8_t *data, size_t len_bytes) {
+    if (offset > kCoreRamSize || len_bytes > kCoreRamSize - offset) {
+      std::cerr << "ERROR: Image does not fit into the 1 MB RAM of a core"
+                << std::endl;
+      return false;
+    }
+    for (int core = first_core_; core < first_core_ + num_cores_; ++core) {
+      if (!ram_->Write(core * kCoreRamSize + offset, data, len_bytes)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  virtual size_t SizeBytes() const { return kCoreRamSize; }
+
+ private:
+  IbexSparseMem *ram_;
+  int first_core_;
+  int num_cores_;
+};
+
+/**
+ * Entry points of the programs of all cores
+ *
+ * Sees the same --meminit and --raminit arguments as VerilatorMemUtil, and
+ * takes the entry point of every ELF image loaded for a core as its boot
+ * address (the entry point being the reset vector at boot address + 0x80).
+ * Images for "ram" are loaded for all cores, images for "ram<N>" only for
+ * core N.
+ */
+class MulticoreBoot : public SimCtrlExtension {
+ public:
+  explicit MulticoreBoot(int num_cores)
+      : boot_addr_(num_cores, kCoreRamBase) {}
+
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+    const struct option long_options[] = {
+        {"raminit", required_argument, nullptr, 'm'},
+        {"meminit", required_argument, nullptr, 'l'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    // Reset the command parsing index in-case other utils have already parsed
+    // some arguments
+    optind = 1;
+    while (1) {
+      int c = getopt_long(argc, argv, ":m:l:h", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      // Disable error reporting by getopt
+      opterr = 0;
+
+      switch (c) {
+        case 0:
+          break;
+        case 'm':
+          if (!SetEntryPoint("ram", optarg)) {
+            return false;
+          }
+          break;
+        case 'l': {
+          // Format is name,file[,type], type and errors are handled by
+          // VerilatorMemUtil
+          std::string arg(optarg);
+          size_t name_end = arg.find(',');
+          if (name_end == std::string::npos) {
+            break;
+          }
+          std::string file = arg.substr(name_end + 1);
+          size_t file_end = file.find(',');
+          if (file_end != std::string::npos) {
+            if (file.substr(file_end + 1) != "elf") {
+              break;
+            }
+            file = file.substr(0, file_end);
+          }
+          if (!SetEntryPoint(arg.substr(0, name_end), file)) {
+            return false;
+          }
+        } break;
+        case 'h':
+          PrintHelp();
+          exit_app = true;
+          break;
+        case ':':  // missing argument
+          std::cerr << "ERROR: Missing argument." << std::endl << std::endl;
+          return false;
+        case '?':
+        default:;
+          // Ignore unrecognized options since they might be consumed by
+          // other utils
+      }
+    }
+
+    return true;
+  }
+
+  uint32_t BootAddr(int core) const { return boot_addr_[core]; }
+
+ private:
+  std::vector<uint32_t> boot_addr_;
+
+  void PrintHelp() const {
+    std::cout << "Multi-core system:\n\n"
+                 "--meminit=ram,FILE\n"
+                 "  Load FILE for all cores\n\n"
+                 "--meminit=ram<N>,FILE\n"
+                 "  Load FILE for core N only, e.g. after a program for all "
+                 "cores\n\n"
+                 "Every core boots at the entry point of the last ELF file "
+                 "loaded for it.\n\n";
+  }
+
+  /**
+   * Take the entry point of |file| as boot address of the cores of memory
+   * area |name|
+   */
+  bool SetEntryPoint(const std::string &name, const std::string &file) {
+    int first_core, num_cores;
+    if (name == "ram") {
+      first_core = 0;
+      num_cores = boot_addr_.size();
+    } else if (name.compare(0, 3, "ram") == 0 && name.size() > 3 &&
+               name.find_first_not_of("0123456789", 3) == std::string::npos) {
+      first_core = std::stoi(name.substr(3));
+      num_cores = 1;
+      if (first_core >= static_cast<int>(boot_addr_.size())) {
+        // Reported as unknown memory area by VerilatorMemUtil
+        return true;
+      }
+    } else {
+      return true;
+    }
+
+    uint32_t entry;
+    if (!ReadEntryPoint(file, entry)) {
+      // vmem images have no entry point, the cores boot at the RAM base
+      return true;
+    }
+    if ((entry & 0xFF) != 0x80) {
+      std::cerr << "ERROR: Entry point 0x" << std::hex << entry << std::dec
+                << " of " << file << " is not a reset vector (boot address "
+                << "+ 0x80, with a 256 byte aligned boot address)" << std::endl;
+      return false;
+    }
+    for (int core = first_core; core < first_core + num_cores; ++core) {
+      boot_addr_[core] = entry - 0x80;
+    }
+    return true;
+  }
+
+  /**
+   * Read the entry point of an ELF file
+   *
+   * @return false if |file| is not a readable ELF file
+   */
+  static bool ReadEntryPoint(const std::string &file, uint32_t &entry) {
+    if (elf_version(EV_CURRENT) == EV_NONE) {
+      return false;
+    }
+
+    int fd = open(file.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return false;
+    }
+
+    bool found = false;
+    Elf *elf_desc = elf_begin(fd, ELF_C_READ, nullptr);
+    if (elf_desc) {
+      GElf_Ehdr ehdr;
+      if (elf_kind(elf_desc) == ELF_K_ELF && gelf_getehdr(elf_desc, &ehdr)) {
+        entry = ehdr.e_entry;
+        found = true;
+      }
+      elf_end(elf_desc);
+    }
+    close(fd);
+    return found;
+  }
+};
+
+static MulticoreBoot *multicore_boot;
+
+// DPI Imports
+extern "C" {
+int multicore_boot_addr(int core) {
+  return multicore_boot->BootAddr(core);
+}
+}
+
+/**
+ * Returns a formatted string of the bus arbitration statistics of all cores
+ *
+ * @param csv Choose csv or pretty-print formatting
+ * @return String of formatted statistics, newline at end
+ */
+static std::string BusReportString(int num_cores, bool csv) {
+  StatValues values;
+
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t grants = 0;
+  uint64_t stalls = 0;
+  for (int core = 0; core < num_cores; ++core) {
+    mhpmcounter_select_core(core);
+    cycles = std::max(cycles, static_cast<uint64_t>(
+                                  mhpmcounter_get(kCounterCycles)));
+    instructions += mhpmcounter_get(kCounterInstrRet);
+    // Hosts of core N: data at 2 * N, instruction fetch at 2 * N + 1
+    grants += bus_grants_get(2 * core) + bus_grants_get(2 * core + 1);
+    stalls += bus_stalls_get(2 * core) + bus_stalls_get(2 * core + 1);
+  }
+
+  AddStat(values, "Cores", num_cores);
+  AddStat(values, "Cycles", cycles);
+  AddStat(values, "Instructions Retired", instructions);
+  AddStatRatio(values, "Instructions/Cycle",
+               cycles ? static_cast<double>(instructions) / cycles : 0.0);
+  AddStat(values, "Bus Grants", grants);
+  AddStatRatio(values, "Bus Utilisation",
+               cycles ? static_cast<double>(grants) / cycles : 0.0);
+  AddStat(values, "Arbitration Stalls", stalls);
+  AddStatRatio(values, "Arbitration Stalls/Request",
+               grants ? static_cast<double>(stalls) / grants : 0.0);
+
+  for (int core = 0; core < num_cores; ++core) {
+    std::string prefix = "Core " + std::to_string(core) + " ";
+    mhpmcounter_select_core(core);
+    uint64_t core_instructions = mhpmcounter_get(kCounterInstrRet);
+    uint64_t fetch_grants = bus_grants_get(2 * core + 1);
+    uint64_t fetch_stalls = bus_stalls_get(2 * core + 1);
+    uint64_t data_grants = bus_grants_get(2 * core);
+    uint64_t data_stalls = bus_stalls_get(2 * core);
+
+    AddStat(values, prefix + "Instructions Retired", core_instructions);
+    AddStatRatio(values, prefix + "Cycles/Instruction",
+                 core_instructions ? static_cast<double>(mhpmcounter_get(
+                                         kCounterCycles)) /
+                                         core_instructions
+                                   : 0.0);
+    AddStat(values, prefix + "Fetch Grants", fetch_grants);
+    AddStat(values, prefix + "Fetch Arbitration Stalls", fetch_stalls);
+    AddStat(values, prefix + "Data Grants", data_grants);
+    AddStat(values, prefix + "Data Arbitration Stalls", data_stalls);
+    AddStatRatio(values, prefix + "Arbitration Stalls/Request",
+                 fetch_grants + data_grants
+                     ? static_cast<double>(fetch_stalls + data_stalls) /
+                           (fetch_grants + data_grants)
+                     : 0.0);
+  }
+
+  return FormatStats(values, csv);
+}
+
+int main(int argc, char **argv) {
+  ibex_multicore_system top;
+  VerilatorMemUtil memutil;
+  VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
+  simctrl.SetTop(&top, &top.IO_CLK, &top.IO_RST_N,
+                 VerilatorSimCtrlFlags::ResetPolarityNegative);
+
+  // Set the scope to the root scope for the DPI functions exported by the
+  // toplevel
+  svSetScope(svGetScopeFromName("TOP.ibex_multicore_system"));
+  int num_cores = multicore_num_cores();
+
+  // The shared RAM, "ram" loads a program for all cores, "ram<N>" for core N
+  // only
+  IbexSparseMem shared_ram(0, num_cores * kCoreRamSize);
+  const char *ram_scope = "TOP.ibex_multicore_system.u_ram";
+  std::vector<std::unique_ptr<CoreRamView>> ram_views;
+  ram_views.emplace_back(new CoreRamView(&shared_ram, 0, num_cores));
+  memutil.RegisterMemoryArea("ram", ram_scope, 32, ram_views.back().get());
+  for (int core = 0; core < num_cores; ++core) {
+    ram_views.emplace_back(new CoreRamView(&shared_ram, core, 1));
+    memutil.RegisterMemoryArea("ram" + std::to_string(core), ram_scope, 32,
+                               ram_views.back().get());
+  }
+  simctrl.RegisterExtension(&memutil);
+
+  MulticoreBoot boot(num_cores);
+  multicore_boot = &boot;
+  simctrl.RegisterExtension(&boot);
+
+  // Host and device numbers match the bus layout of ibex_multicore_system
+  IbexBusMonitor bus_monitor("ibex_multicore_system_bus.csv");
+  bus_monitor.RegisterDevice(0, "RAM");
+  bus_monitor.RegisterDevice(1, "Timer");
+  for (int core = 0; core < num_cores; ++core) {
+    std::string prefix = "Core " + std::to_string(core);
+    bus_monitor.RegisterHost(2 * core, prefix + " Data");
+    bus_monitor.RegisterHost(2 * core + 1, prefix + " Fetch");
+    bus_monitor.RegisterDevice(2 + core, prefix + " SimCtrl");
+  }
+  simctrl.RegisterExtension(&bus_monitor);
+
+  bool exit_app = false;
+  int ret_code = simctrl.ParseCommandArgs(argc, argv, exit_app);
+  if (exit_app) {
+    return ret_code;
+  }
+
+  std::string title =
+      "Simulation of Ibex with " + std::to_string(num_cores) + " cores";
+  std::cout << title << std::endl
+            << std::string(title.length(), '=') << std::endl
+            << std::endl;
+
+  simctrl.RunSimulation();
+
+  if (!simctrl.WasSimulationSuccessful()) {
+    return 1;
+  }
+
+  svSetScope(svGetScopeFromName("TOP.ibex_multicore_system"));
+
+  for (int core = 0; core < num_cores; ++core) {
+    mhpmcounter_select_core(core);
+
+    std::string title = "Performance Counters of Core " + std::to_string(core);
+    std::cout << "\n" << title << std::endl
+              << std::string(title.length(), '=') << std::endl;
+    std::cout << ibex_pcount_string(false);
+
+    std::ofstream pcount_csv("ibex_multicore_system_pcount_core" +
+                             std::to_string(core) + ".csv");
+    pcount_csv << ibex_pcount_string(true);
+  }
+
+  std::cout << "\nBus Arbitration" << std::endl
+            << "===============" << std::endl;
+  std::cout << BusReportString(num_cores, false);
+
+  if (bus_monitor.IsEnabled()) {
+    std::cout << "\nBus Monitor" << std::endl
+              << "===========" << std::endl;
+    std::cout << bus_monitor.ReportString(false);
+  }
+
+  std::ofstream stats_csv("ibex_multicore_system_stats.csv");
+  stats_csv << BusReportString(num_cores, true);
+  if (bus_monitor.IsEnabled()) {
+    stats_csv << bus_monitor.ReportString(true);
+  }
+
+  return 0;
+}
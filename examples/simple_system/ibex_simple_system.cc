@@ -2,31 +2,142 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <string>
 
+#include "ibex_bin_trace.h"
+#include "ibex_bus_monitor.h"
+#include "ibex_dummy_instr_stats.h"
+#include "ibex_energy.h"
+#include "ibex_fetch_monitor.h"
+#include "ibex_irq_latency.h"
+#include "ibex_live_stats.h"
+#include "ibex_mem_latency.h"
+#include "ibex_mem_watch.h"
 #include "ibex_pcounts.h"
+#include "ibex_roi.h"
+#include "ibex_sparse_mem.h"
+#include "ibex_stats_format.h"
 #include "verilated_toplevel.h"
 #include "verilator_memutil.h"
 #include "verilator_sim_ctrl.h"
 
+extern "C" {
+extern unsigned int ram_size_get();
+extern int harvard_mem_get();
+extern long long mhpmcounter_get(int index);
+}
+
+// Indices of counters for mhpmcounter_get()
+static const int kCounterCycles = 0;
+static const int kCounterInstrRet = 2;
+static const int kCounterFetchWait = 4;
+
+/**
+ * Returns a formatted string of the memory configuration and the cycles per
+ * instruction, to compare the HarvardMem configurations of the system
+ */
+static std::string MemoryReportString(bool csv) {
+  StatValues values;
+
+  uint64_t cycles = mhpmcounter_get(kCounterCycles);
+  uint64_t instructions = mhpmcounter_get(kCounterInstrRet);
+  uint64_t fetch_wait = mhpmcounter_get(kCounterFetchWait);
+
+  // Instruction fetch and data accesses use separate RAM ports (Harvard), or
+  // share the bus to a single port (unified)
+  AddStat(values, "Harvard Memory", harvard_mem_get());
+  AddStatRatio(values, "Cycles/Instruction",
+               instructions ? static_cast<double>(cycles) / instructions : 0.0);
+  AddStatRatio(values, "Fetch Wait/Instruction",
+               instructions ? static_cast<double>(fetch_wait) / instructions
+                            : 0.0);
+
+  return FormatStats(values, csv);
+}
+
 int main(int argc, char **argv) {
   ibex_simple_system top;
   VerilatorMemUtil memutil;
+  IbexMemLatency mem_latency;
+  IbexRoi roi;
+  IbexIrqLatency irq_latency;
+  IbexMemWatch mem_watch("ibex_simple_system_watch.bin");
+  IbexLiveStats live_stats("TOP.ibex_simple_system");
+  IbexBinTrace bin_trace("ibex_simple_system_trace.bin");
+  IbexBusMonitor bus_monitor("ibex_simple_system_bus.csv");
+  IbexEnergy energy;
+  IbexFetchMonitor fetch_monitor;
+  IbexDummyInstrStats dummy_instr_stats;
   VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
   simctrl.SetTop(&top, &top.IO_CLK, &top.IO_RST_N,
                  VerilatorSimCtrlFlags::ResetPolarityNegative);
 
-  memutil.RegisterMemoryArea(
-      "ram", "TOP.ibex_simple_system.u_ram.u_ram.gen_generic.u_impl_generic");
+  // Set the scope to the root scope for the DPI functions exported by the
+  // toplevel
+  svSetScope(svGetScopeFromName("TOP.ibex_simple_system"));
+
+  // The RAM is either a generic ram or, if built with SparseRam, a
+  // sparse_ram_2p whose contents live in |sparse_ram|
+  IbexSparseMem sparse_ram(0, ram_size_get());
+  const char *generic_ram_scope =
+      "TOP.ibex_simple_system.gen_ram.u_ram.u_ram.gen_generic.u_impl_generic";
+  if (svGetScopeFromName(generic_ram_scope)) {
+    memutil.RegisterMemoryArea("ram", generic_ram_scope);
+  } else {
+    memutil.RegisterMemoryArea(
+        "ram", "TOP.ibex_simple_system.gen_sparse_ram.u_ram", 32, &sparse_ram);
+  }
   simctrl.RegisterExtension(&memutil);
 
+  // Port numbers match the PortId parameters of the mem_latency instances
+  mem_latency.RegisterPort(0, "Instr");
+  mem_latency.RegisterPort(1, "Data");
+  simctrl.RegisterExtension(&mem_latency);
+  simctrl.RegisterExtension(&roi);
+
+  // IRQ number matches the IrqId parameter of the irq_latency_monitor instance
+  irq_latency.RegisterIrq(7, "Timer");
+  simctrl.RegisterExtension(&irq_latency);
+  simctrl.RegisterExtension(&mem_watch);
+  simctrl.RegisterExtension(&live_stats);
+  simctrl.RegisterExtension(&bin_trace);
+
+  // Host and device numbers match the bus_host_e and bus_device_e enums of
+  // ibex_simple_system. Instruction fetch is only a host on the bus if it was
+  // built without HarvardMem.
+  bus_monitor.RegisterHost(0, "Core Data");
+  bus_monitor.RegisterHost(1, "Core Instr");
+  bus_monitor.RegisterDevice(0, "RAM");
+  bus_monitor.RegisterDevice(1, "SimCtrl");
+  bus_monitor.RegisterDevice(2, "Timer");
+  simctrl.RegisterExtension(&bus_monitor);
+
+  // Net numbers match the energy_net array of ibex_simple_system
+  energy.RegisterNet(0, "rf_write", "RegFile Write");
+  energy.RegisterNet(1, "rf_read", "RegFile Read");
+  energy.RegisterNet(2, "alu", "ALU Operands");
+  energy.RegisterNet(3, "multdiv", "MultDiv Operands");
+  energy.RegisterNet(4, "instr_bus", "Instr Bus");
+  energy.RegisterNet(5, "data_bus", "Data Bus");
+  energy.RegisterNet(6, "icache", "ICache Arrays");
+  simctrl.RegisterExtension(&energy);
+  simctrl.RegisterExtension(&fetch_monitor);
+  simctrl.RegisterExtension(&dummy_instr_stats);
+
   bool exit_app = false;
   int ret_code = simctrl.ParseCommandArgs(argc, argv, exit_app);
   if (exit_app) {
     return ret_code;
   }
 
+  // Report the energy of every region of interest next to its counters
+  if (energy.IsEnabled()) {
+    roi.AddValue("Energy", [&energy]() { return energy.Energy(); });
+  }
+
   std::cout << "Simulation of Ibex" << std::endl
             << "==================" << std::endl
             << std::endl;
@@ -46,8 +157,86 @@ int main(int argc, char **argv) {
             << "====================" << std::endl;
   std::cout << ibex_pcount_string(false);
 
+  std::cout << "\nMemory System" << std::endl
+            << "=============" << std::endl;
+  std::cout << MemoryReportString(false);
+
+  // Report the injected latency next to the counters to see how sensitive the
+  // workload is to it
+  if (mem_latency.IsEnabled()) {
+    std::cout << "\nMemory Latency Model" << std::endl
+              << "====================" << std::endl;
+    std::cout << mem_latency.ReportString(false);
+  }
+
+  if (bus_monitor.IsEnabled()) {
+    std::cout << "\nBus Monitor" << std::endl
+              << "===========" << std::endl;
+    std::cout << bus_monitor.ReportString(false);
+  }
+
+  if (fetch_monitor.IsEnabled()) {
+    std::cout << "\nInstruction Fetch" << std::endl
+              << "=================" << std::endl;
+    std::cout << fetch_monitor.ReportString(false);
+  }
+
+  if (dummy_instr_stats.IsEnabled()) {
+    std::cout << "\nDummy Instructions" << std::endl
+              << "==================" << std::endl;
+    std::cout << dummy_instr_stats.ReportString(false);
+  }
+
+  if (energy.IsEnabled()) {
+    std::cout << "\nEnergy Estimate" << std::endl
+              << "===============" << std::endl;
+    std::cout << energy.ReportString(false);
+  }
+
   std::ofstream pcount_csv("ibex_simple_system_pcount.csv");
   pcount_csv << ibex_pcount_string(true);
+  pcount_csv << MemoryReportString(true);
+  if (mem_latency.IsEnabled()) {
+    pcount_csv << mem_latency.ReportString(true);
+  }
+  if (bus_monitor.IsEnabled()) {
+    pcount_csv << bus_monitor.ReportString(true);
+  }
+  if (fetch_monitor.IsEnabled()) {
+    pcount_csv << fetch_monitor.ReportString(true);
+  }
+  if (dummy_instr_stats.IsEnabled()) {
+    pcount_csv << dummy_instr_stats.ReportString(true);
+  }
+  if (energy.IsEnabled()) {
+    pcount_csv << energy.ReportString(true);
+  }
+
+  // Statistics of the regions of interest marked by software with
+  // sim_roi_begin() / sim_roi_end()
+  if (roi.HasRegions()) {
+    std::cout << "\nRegions of Interest" << std::endl
+              << "===================" << std::endl;
+    std::cout << roi.ReportString(false);
+
+    std::ofstream roi_csv("ibex_simple_system_roi.csv");
+    roi_csv << roi.ReportString(true);
+  }
+
+  if (mem_watch.IsEnabled()) {
+    std::cout << "\nMemory Watchpoints" << std::endl
+              << "==================" << std::endl;
+    std::cout << mem_watch.ReportString(false);
+  }
+
+  if (irq_latency.HasSamples()) {
+    std::cout << "\nInterrupt Latency (cycles)" << std::endl
+              << "==========================" << std::endl;
+    std::cout << irq_latency.ReportString(false);
+
+    std::ofstream irq_latency_csv("ibex_simple_system_irq_latency.csv");
+    irq_latency_csv << irq_latency.ReportString(true);
+  }
 
   return 0;
 }
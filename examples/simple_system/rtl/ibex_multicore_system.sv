@@ -0,0 +1,477 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// VCS does not support overriding enum and string parameters via command line. Instead, a `define
+// is used that can be set from the command line. If no value has been specified, this gives a
+// default. Other simulators don't take the detour via `define and can override the corresponding
+// parameters directly.
+`ifndef RV32M
+  `define RV32M ibex_pkg::RV32MFast
+`endif
+
+`ifndef RV32B
+  `define RV32B ibex_pkg::RV32BNone
+`endif
+
+`ifndef RegFile
+  `define RegFile ibex_pkg::RegFileFF
+`endif
+
+/**
+ * Ibex multi-core simple system
+ *
+ * A variant of ibex_simple_system with NrCores ibex cores which share a single RAM, used to
+ * measure how contention for the shared memory scales with the number of cores.
+ *
+ * Instruction fetch and data accesses of all cores are hosts on one bus, so every access to the
+ * RAM is arbitrated against the accesses of all other cores. Each core has its own hart ID and its
+ * own simulator_ctrl, and sees the same memory map as a core in ibex_simple_system:
+ *
+ * * 0x00020000 - The simulator_ctrl of the core (1 kB)
+ * * 0x00030000 - Timer, shared by all cores (1 kB)
+ * * 0x00100000 - 1 MB slice of the shared RAM private to the core, where simple_system programs
+ *                are linked
+ *
+ * so that unmodified simple_system programs can run on every core. Core N accesses its RAM slice
+ * at RamBase + N * 1 MB in the shared RAM and its simulator_ctrl at SimCtrlBase + N * 1 kB, where
+ * the slices and simulator_ctrls of all cores are also visible to the other cores.
+ *
+ * The simulation ends once all cores have halted through their simulator_ctrl.
+ *
+ * The RAM is a sparse_ram_2p whose contents live in the C++ model (see dv/verilator/sparse_mem),
+ * which loads the program of each core into its slice (see ibex_multicore_system.cc).
+ */
+
+module ibex_multicore_system (
+  input IO_CLK,
+  input IO_RST_N
+);
+
+  parameter int unsigned        NrCores                  = 2;
+  // Arbitrate the bus round robin instead of with fixed priority (lower cores first)
+  parameter bit                 BusRoundRobin            = 1'b1;
+  parameter bit                 SecureIbex               = 1'b0;
+  parameter bit                 PMPEnable                = 1'b0;
+  parameter int unsigned        PMPGranularity           = 0;
+  parameter int unsigned        PMPNumRegions            = 4;
+  parameter bit                 RV32E                    = 1'b0;
+  parameter ibex_pkg::rv32m_e   RV32M                    = `RV32M;
+  parameter ibex_pkg::rv32b_e   RV32B                    = `RV32B;
+  parameter ibex_pkg::regfile_e RegFile                  = `RegFile;
+  parameter bit                 BranchTargetALU          = 1'b0;
+  parameter bit                 WritebackStage           = 1'b0;
+  parameter bit                 ICache                   = 1'b0;
+  parameter bit                 ICacheECC                = 1'b0;
+  parameter bit                 BranchPredictor          = 1'b0;
+
+  logic clk_sys = 1'b0, rst_sys_n;
+
+  // Hosts of core N: data at 2 * N, instruction fetch at 2 * N + 1
+  localparam int NrHosts = 2 * NrCores;
+
+  // Devices: the RAM, the timer and one simulator_ctrl per core starting at SimCtrl0
+  localparam int Ram = 0;
+  localparam int Timer = 1;
+  localparam int SimCtrl0 = 2;
+  localparam int NrDevices = SimCtrl0 + NrCores;
+
+  // Each core has a 1 MB slice of the RAM
+  localparam int unsigned RamSize = 32'h100000 << $clog2(NrCores);
+  localparam logic [31:0] RamBase = 32'h80000000;
+  localparam logic [31:0] SimCtrlBase = 32'h40000;
+
+  // Addresses of the RAM slice and the simulator_ctrl of a core as seen by the core itself
+  localparam logic [31:0] CoreRamBase = 32'h100000;
+  localparam logic [31:0] CoreSimCtrlBase = 32'h20000;
+
+  // Map an address of core |core| onto the bus
+  function automatic logic [31:0] core_addr_map(int unsigned core, logic [31:0] addr);
+    if ((addr & ~32'hFFFFF) == CoreRamBase) begin
+      return RamBase + (32'(core) << 20) + {12'b0, addr[19:0]};
+    end
+    if ((addr & ~32'h3FF) == CoreSimCtrlBase) begin
+      return SimCtrlBase + (32'(core) << 10) + {22'b0, addr[9:0]};
+    end
+    return addr;
+  endfunction
+
+  // interrupts
+  logic timer_irq;
+
+  // host and device signals
+  logic           host_req    [NrHosts];
+  logic           host_gnt    [NrHosts];
+  logic [31:0]    host_addr   [NrHosts];
+  logic           host_we     [NrHosts];
+  logic [ 3:0]    host_be     [NrHosts];
+  logic [31:0]    host_wdata  [NrHosts];
+  logic           host_rvalid [NrHosts];
+  logic [31:0]    host_rdata  [NrHosts];
+  logic           host_err    [NrHosts];
+
+  // devices (slaves)
+  logic           device_req    [NrDevices];
+  logic [31:0]    device_addr   [NrDevices];
+  logic           device_we     [NrDevices];
+  logic [ 3:0]    device_be     [NrDevices];
+  logic [31:0]    device_wdata  [NrDevices];
+  logic           device_rvalid [NrDevices];
+  logic [31:0]    device_rdata  [NrDevices];
+  logic           device_err    [NrDevices];
+
+  // Device address mapping
+  logic [31:0] cfg_device_addr_base [NrDevices];
+  logic [31:0] cfg_device_addr_mask [NrDevices];
+  assign cfg_device_addr_base[Ram] = RamBase;
+  assign cfg_device_addr_mask[Ram] = ~(RamSize - 1);
+  assign cfg_device_addr_base[Timer] = 32'h30000;
+  assign cfg_device_addr_mask[Timer] = ~32'h3FF; // 1 kB
+
+  // Boot address of each core, the first instruction executed is at the boot address + 0x80
+  logic [31:0] boot_addr [NrCores];
+
+  // Cores whose simulator_ctrl received a halt request
+  logic [NrCores-1:0] core_halted;
+
+  `ifdef VERILATOR
+    assign clk_sys = IO_CLK;
+    assign rst_sys_n = IO_RST_N;
+
+    // Entry points of the programs loaded for each core (see ibex_multicore_system.cc)
+    import "DPI-C" function int multicore_boot_addr(input int core);
+
+    initial begin
+      for (int c = 0; c < NrCores; c++) begin
+        boot_addr[c] = 32'(multicore_boot_addr(c));
+      end
+    end
+  `else
+    initial begin
+      rst_sys_n = 1'b0;
+      #8
+      rst_sys_n = 1'b1;
+    end
+    always begin
+      #1 clk_sys = 1'b0;
+      #1 clk_sys = 1'b1;
+    end
+
+    initial begin
+      for (int c = 0; c < NrCores; c++) begin
+        boot_addr[c] = CoreRamBase;
+      end
+    end
+  `endif
+
+  // Tie-off unused error signals
+  assign device_err[Ram] = 1'b0;
+
+  bus #(
+    .NrDevices    ( NrDevices     ),
+    .NrHosts      ( NrHosts       ),
+    .DataWidth    ( 32            ),
+    .AddressWidth ( 32            ),
+    .RoundRobin   ( BusRoundRobin )
+  ) u_bus (
+    .clk_i               (clk_sys),
+    .rst_ni              (rst_sys_n),
+
+    .host_req_i          (host_req     ),
+    .host_gnt_o          (host_gnt     ),
+    .host_addr_i         (host_addr    ),
+    .host_we_i           (host_we      ),
+    .host_be_i           (host_be      ),
+    .host_wdata_i        (host_wdata   ),
+    .host_rvalid_o       (host_rvalid  ),
+    .host_rdata_o        (host_rdata   ),
+    .host_err_o          (host_err     ),
+
+    .device_req_o        (device_req   ),
+    .device_addr_o       (device_addr  ),
+    .device_we_o         (device_we    ),
+    .device_be_o         (device_be    ),
+    .device_wdata_o      (device_wdata ),
+    .device_rvalid_i     (device_rvalid),
+    .device_rdata_i      (device_rdata ),
+    .device_err_i        (device_err   ),
+
+    .cfg_device_addr_base,
+    .cfg_device_addr_mask
+  );
+
+  // Bus occupancy statistics, enabled on the command line of the Verilator simulation (see
+  // dv/verilator/bus_monitor). The monitor supports up to 16 cores.
+  if (NrHosts <= 32 && NrDevices <= 32) begin : gen_bus_monitor
+    bus_monitor #(
+      .NrHosts   ( NrHosts   ),
+      .NrDevices ( NrDevices )
+    ) u_bus_monitor (
+      .clk_i           (clk_sys),
+      .rst_ni          (rst_sys_n),
+
+      .host_req_i      (host_req),
+      .host_gnt_i      (host_gnt),
+      .host_rvalid_i   (host_rvalid),
+
+      .device_req_i    (device_req),
+      .device_rvalid_i (device_rvalid)
+    );
+  end
+
+  // Performance counters of all cores, see mhpmcounter_get()
+  logic [63:0] mhpmcounter [NrCores][32];
+
+  // Simulation-only event counters of the instruction caches (see "Performance probes" in
+  // ibex_icache.sv), see icache_counter_get()
+  localparam int NrICacheCounters = 7;
+
+  logic [63:0] icache_counter [NrCores][NrICacheCounters];
+
+  for (genvar c = 0; c < NrCores; c++) begin : gen_cores
+    localparam int unsigned HostD = 2 * c;
+    localparam int unsigned HostI = 2 * c + 1;
+
+    logic        instr_req;
+    logic [31:0] instr_addr;
+    logic        data_req;
+    logic        data_we;
+    logic [ 3:0] data_be;
+    logic [31:0] data_addr;
+    logic [31:0] data_wdata;
+
+    logic        roi_valid;
+    logic        roi_begin;
+    logic [31:0] roi_id;
+
+    ibex_core_tracing #(
+        .SecureIbex      ( SecureIbex      ),
+        .PMPEnable       ( PMPEnable       ),
+        .PMPGranularity  ( PMPGranularity  ),
+        .PMPNumRegions   ( PMPNumRegions   ),
+        .MHPMCounterNum  ( 29              ),
+        .RV32E           ( RV32E           ),
+        .RV32M           ( RV32M           ),
+        .RV32B           ( RV32B           ),
+        .RegFile         ( RegFile         ),
+        .BranchTargetALU ( BranchTargetALU ),
+        .WritebackStage  ( WritebackStage  ),
+        .ICache          ( ICache          ),
+        .ICacheECC       ( ICacheECC       ),
+        .BranchPredictor ( BranchPredictor ),
+        .DmHaltAddr      ( 32'h00100000    ),
+        .DmExceptionAddr ( 32'h00100000    )
+      ) u_core (
+        .clk_i                 (clk_sys),
+        .rst_ni                (rst_sys_n),
+
+        .test_en_i             ('b0),
+
+        // The tracer writes trace_core_<hart ID>.log, one file per core
+        .hart_id_i             (32'(c)),
+        .boot_addr_i           (boot_addr[c]),
+
+        .instr_req_o           (instr_req),
+        .instr_gnt_i           (host_gnt[HostI]),
+        .instr_rvalid_i        (host_rvalid[HostI]),
+        .instr_addr_o          (instr_addr),
+        .instr_rdata_i         (host_rdata[HostI]),
+        .instr_err_i           (host_err[HostI]),
+
+        .data_req_o            (data_req),
+        .data_gnt_i            (host_gnt[HostD]),
+        .data_rvalid_i         (host_rvalid[HostD]),
+        .data_we_o             (data_we),
+        .data_be_o             (data_be),
+        .data_addr_o           (data_addr),
+        .data_wdata_o          (data_wdata),
+        .data_rdata_i          (host_rdata[HostD]),
+        .data_err_i            (host_err[HostD]),
+
+        .irq_software_i        (1'b0),
+        .irq_timer_i           (timer_irq),
+        .irq_external_i        (1'b0),
+        .irq_fast_i            (15'b0),
+        .irq_nm_i              (1'b0),
+
+        .debug_req_i           ('b0),
+
+        .fetch_enable_i        ('b1),
+        .alert_minor_o         (),
+        .alert_major_o         (),
+        .core_sleep_o          ()
+      );
+
+    assign host_req[HostI]   = instr_req;
+    assign host_addr[HostI]  = core_addr_map(c, instr_addr);
+    assign host_we[HostI]    = 1'b0;
+    assign host_be[HostI]    = 4'b0;
+    assign host_wdata[HostI] = 32'b0;
+
+    assign host_req[HostD]   = data_req;
+    assign host_addr[HostD]  = core_addr_map(c, data_addr);
+    assign host_we[HostD]    = data_we;
+    assign host_be[HostD]    = data_be;
+    assign host_wdata[HostD] = data_wdata;
+
+    assign cfg_device_addr_base[SimCtrl0 + c] = SimCtrlBase + (32'(c) << 10);
+    assign cfg_device_addr_mask[SimCtrl0 + c] = ~32'h3FF; // 1 kB
+    assign device_err[SimCtrl0 + c] = 1'b0;
+
+    // Region of interest markers are not supported with multiple cores, the simulation ends once
+    // all cores have halted.
+    simulator_ctrl #(
+      .LogName($sformatf("ibex_multicore_system_core%0d.log", c)),
+      .FinishOnHalt(1'b0)
+      ) u_simulator_ctrl (
+        .clk_i     (clk_sys),
+        .rst_ni    (rst_sys_n),
+
+        .req_i     (device_req[SimCtrl0 + c]),
+        .we_i      (device_we[SimCtrl0 + c]),
+        .be_i      (device_be[SimCtrl0 + c]),
+        .addr_i    (device_addr[SimCtrl0 + c]),
+        .wdata_i   (device_wdata[SimCtrl0 + c]),
+        .rvalid_o  (device_rvalid[SimCtrl0 + c]),
+        .rdata_o   (device_rdata[SimCtrl0 + c]),
+
+        .roi_valid_o (roi_valid),
+        .roi_begin_o (roi_begin),
+        .roi_id_o    (roi_id),
+        .halted_o    (core_halted[c]),
+
+        .cpuctrl_i   ('0)
+      );
+
+    logic unused_roi;
+    assign unused_roi = ^{roi_valid, roi_begin, roi_id};
+
+    assign mhpmcounter[c] = u_core.u_ibex_core.cs_registers_i.mhpmcounter;
+
+    if (ICache) begin : gen_icache_counters
+      assign icache_counter[c] = u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.perf_cnt_q;
+    end else begin : gen_no_icache_counters
+      assign icache_counter[c] = '{default: '0};
+    end
+  end
+
+  always_ff @(posedge clk_sys) begin
+    if (&core_halted) begin
+      $display("Terminating simulation, all cores have halted.");
+      $finish;
+    end
+  end
+
+  // RAM shared by all cores, only port A is used. The memory contents are held in a sparse map in
+  // the Verilator C++ model (see dv/verilator/sparse_mem).
+  sparse_ram_2p #(
+      .Depth(RamSize / 4),
+      .MemId(0)
+    ) u_ram (
+      .clk_i       (clk_sys),
+      .rst_ni      (rst_sys_n),
+
+      .a_req_i     (device_req[Ram]),
+      .a_we_i      (device_we[Ram]),
+      .a_be_i      (device_be[Ram]),
+      .a_addr_i    (device_addr[Ram]),
+      .a_wdata_i   (device_wdata[Ram]),
+      .a_rvalid_o  (device_rvalid[Ram]),
+      .a_rdata_o   (device_rdata[Ram]),
+
+      .b_req_i     (1'b0),
+      .b_we_i      (1'b0),
+      .b_be_i      (4'b0),
+      .b_addr_i    (32'b0),
+      .b_wdata_i   (32'b0),
+      .b_rvalid_o  (),
+      .b_rdata_o   ()
+    );
+
+  // The timer interrupt is routed to all cores
+  timer #(
+    .DataWidth    (32),
+    .AddressWidth (32)
+    ) u_timer (
+      .clk_i          (clk_sys),
+      .rst_ni         (rst_sys_n),
+
+      .timer_req_i    (device_req[Timer]),
+      .timer_we_i     (device_we[Timer]),
+      .timer_be_i     (device_be[Timer]),
+      .timer_addr_i   (device_addr[Timer]),
+      .timer_wdata_i  (device_wdata[Timer]),
+      .timer_rvalid_o (device_rvalid[Timer]),
+      .timer_rdata_o  (device_rdata[Timer]),
+      .timer_err_o    (device_err[Timer]),
+      .timer_intr_o   (timer_irq)
+    );
+
+  // Bus arbitration statistics of each host: granted requests, and cycles in which a request
+  // waited for the grant because another host was granted the bus
+  logic [63:0] bus_grants [NrHosts];
+  logic [63:0] bus_stalls [NrHosts];
+
+  always_ff @(posedge clk_sys or negedge rst_sys_n) begin
+    if (!rst_sys_n) begin
+      bus_grants <= '{default: '0};
+      bus_stalls <= '{default: '0};
+    end else begin
+      for (int h = 0; h < NrHosts; h++) begin
+        if (host_req[h] && host_gnt[h]) begin
+          bus_grants[h] <= bus_grants[h] + 64'd1;
+        end
+        if (host_req[h] && !host_gnt[h]) begin
+          bus_stalls[h] <= bus_stalls[h] + 64'd1;
+        end
+      end
+    end
+  end
+
+  export "DPI-C" function multicore_num_cores;
+
+  function automatic int multicore_num_cores();
+    return NrCores;
+  endfunction
+
+  export "DPI-C" function bus_grants_get;
+
+  function automatic longint bus_grants_get(int host);
+    return bus_grants[host];
+  endfunction
+
+  export "DPI-C" function bus_stalls_get;
+
+  function automatic longint bus_stalls_get(int host);
+    return bus_stalls[host];
+  endfunction
+
+  // The performance counters of all cores are read through the same DPI functions as in
+  // ibex_simple_system (see dv/verilator/pcount), mhpmcounter_select_core() chooses the core.
+  int unsigned pcount_core = 0;
+
+  export "DPI-C" function mhpmcounter_select_core;
+
+  function automatic void mhpmcounter_select_core(int core);
+    pcount_core = core;
+  endfunction
+
+  export "DPI-C" function mhpmcounter_get;
+
+  function automatic longint mhpmcounter_get(int index);
+    return mhpmcounter[pcount_core][index];
+  endfunction
+
+  export "DPI-C" function icache_counter_num;
+
+  function automatic int icache_counter_num();
+    return ICache ? NrICacheCounters : 0;
+  endfunction
+
+  export "DPI-C" function icache_counter_get;
+
+  function automatic longint icache_counter_get(int index);
+    return icache_counter[pcount_core][index];
+  endfunction
+
+endmodule
@@ -2,6 +2,8 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+`include "prim_assert.sv"
+
 // VCS does not support overriding enum and string parameters via command line. Instead, a `define
 // is used that can be set from the command line. If no value has been specified, this gives a
 // default. Other simulators don't take the detour via `define and can override the corresponding
@@ -21,9 +23,14 @@
 /**
  * Ibex simple system
  *
- * This is a basic system consisting of an ibex, a 1 MB sram for instruction/data
- * and a small memory mapped control module for outputting ASCII text and
- * controlling/halting the simulation from the software running on the ibex.
+ * This is a basic system consisting of an ibex, a sram for instruction/data (1 MB at 0x100000 by
+ * default, see RamBase and RamSize) and a small memory mapped control module for outputting ASCII
+ * text and controlling/halting the simulation from the software running on the ibex. The core
+ * boots from RamBase.
+ *
+ * With HarvardMem (the default) instructions are fetched from the second port of the sram, and
+ * only data accesses go through the bus. Otherwise instruction fetch is a second host on the bus,
+ * arbitrated against the (higher priority) data accesses for the first port of the sram.
  *
  * It is designed to be used with verilator but should work with other
  * simulators, a small amount of work may be required to support the
@@ -45,13 +52,21 @@ module ibex_simple_system (
   parameter ibex_pkg::regfile_e RegFile                  = `RegFile;
   parameter bit                 BranchTargetALU          = 1'b0;
   parameter bit                 WritebackStage           = 1'b0;
+  parameter bit                 ICache                   = 1'b0;
+  parameter bit                 ICacheECC                = 1'b0;
   parameter bit                 BranchPredictor          = 1'b0;
   parameter                     SRAMInitFile             = "";
+  parameter bit                 SparseRam                = 1'b0;
+  parameter bit                 HarvardMem               = 1'b1;
+  // RAM size in bytes, must be a power of two. RamBase must be aligned to it.
+  parameter int unsigned        RamSize                  = 32'h100000;
+  parameter logic [31:0]        RamBase                  = 32'h100000;
 
   logic clk_sys = 1'b0, rst_sys_n;
 
   typedef enum {
-    CoreD
+    CoreD,
+    CoreI
   } bus_host_e;
 
   typedef enum {
@@ -61,11 +76,13 @@ module ibex_simple_system (
   } bus_device_e;
 
   localparam int NrDevices = 3;
-  localparam int NrHosts = 1;
+  localparam int NrHosts = HarvardMem ? 1 : 2;
 
   // interrupts
   logic timer_irq;
 
+  logic core_sleep;
+
   // host and device signals
   logic           host_req    [NrHosts];
   logic           host_gnt    [NrHosts];
@@ -90,8 +107,8 @@ module ibex_simple_system (
   // Device address mapping
   logic [31:0] cfg_device_addr_base [NrDevices];
   logic [31:0] cfg_device_addr_mask [NrDevices];
-  assign cfg_device_addr_base[Ram] = 32'h100000;
-  assign cfg_device_addr_mask[Ram] = ~32'hFFFFF; // 1 MB
+  assign cfg_device_addr_base[Ram] = RamBase;
+  assign cfg_device_addr_mask[Ram] = ~(RamSize - 1);
   assign cfg_device_addr_base[SimCtrl] = 32'h20000;
   assign cfg_device_addr_mask[SimCtrl] = ~32'h3FF; // 1 kB
   assign cfg_device_addr_base[Timer] = 32'h30000;
@@ -105,8 +122,34 @@ module ibex_simple_system (
   logic [31:0] instr_rdata;
   logic instr_err;
 
-  assign instr_gnt = instr_req;
-  assign instr_err = '0;
+  // Instruction fetch signals on the RAM side of the latency model
+  logic ram_instr_req;
+  logic ram_instr_gnt;
+  logic ram_instr_rvalid;
+  logic [31:0] ram_instr_addr;
+  logic [31:0] ram_instr_rdata;
+  logic ram_instr_err;
+
+  // Second (instruction fetch) port of the RAM, unused without HarvardMem
+  logic ram_b_req;
+  logic ram_b_rvalid;
+  logic [31:0] ram_b_rdata;
+
+  // Data signals on the core side of the latency model
+  logic core_data_req;
+  logic core_data_gnt;
+  logic core_data_rvalid;
+  logic core_data_we;
+  logic [ 3:0] core_data_be;
+  logic [31:0] core_data_addr;
+  logic [31:0] core_data_wdata;
+  logic [31:0] core_data_rdata;
+  logic core_data_err;
+
+  // Region of interest markers written by software
+  logic roi_valid;
+  logic roi_begin;
+  logic [31:0] roi_id;
 
   `ifdef VERILATOR
     assign clk_sys = IO_CLK;
@@ -159,6 +202,23 @@ module ibex_simple_system (
     .cfg_device_addr_mask
   );
 
+  // Bus occupancy statistics, enabled on the command line of the Verilator simulation (see
+  // dv/verilator/bus_monitor)
+  bus_monitor #(
+    .NrHosts   ( NrHosts   ),
+    .NrDevices ( NrDevices )
+  ) u_bus_monitor (
+    .clk_i           (clk_sys),
+    .rst_ni          (rst_sys_n),
+
+    .host_req_i      (host_req),
+    .host_gnt_i      (host_gnt),
+    .host_rvalid_i   (host_rvalid),
+
+    .device_req_i    (device_req),
+    .device_rvalid_i (device_rvalid)
+  );
+
   ibex_core_tracing #(
       .SecureIbex      ( SecureIbex      ),
       .PMPEnable       ( PMPEnable       ),
@@ -171,9 +231,11 @@ module ibex_simple_system (
       .RegFile         ( RegFile         ),
       .BranchTargetALU ( BranchTargetALU ),
       .WritebackStage  ( WritebackStage  ),
+      .ICache          ( ICache          ),
+      .ICacheECC       ( ICacheECC       ),
       .BranchPredictor ( BranchPredictor ),
-      .DmHaltAddr      ( 32'h00100000    ),
-      .DmExceptionAddr ( 32'h00100000    )
+      .DmHaltAddr      ( RamBase         ),
+      .DmExceptionAddr ( RamBase         )
     ) u_core (
       .clk_i                 (clk_sys),
       .rst_ni                (rst_sys_n),
@@ -181,8 +243,8 @@ module ibex_simple_system (
       .test_en_i             ('b0),
 
       .hart_id_i             (32'b0),
-      // First instruction executed is at 0x0 + 0x80
-      .boot_addr_i           (32'h00100000),
+      // First instruction executed is at RamBase + 0x80
+      .boot_addr_i           (RamBase),
 
       .instr_req_o           (instr_req),
       .instr_gnt_i           (instr_gnt),
@@ -191,15 +253,15 @@ module ibex_simple_system (
       .instr_rdata_i         (instr_rdata),
       .instr_err_i           (instr_err),
 
-      .data_req_o            (host_req[CoreD]),
-      .data_gnt_i            (host_gnt[CoreD]),
-      .data_rvalid_i         (host_rvalid[CoreD]),
-      .data_we_o             (host_we[CoreD]),
-      .data_be_o             (host_be[CoreD]),
-      .data_addr_o           (host_addr[CoreD]),
-      .data_wdata_o          (host_wdata[CoreD]),
-      .data_rdata_i          (host_rdata[CoreD]),
-      .data_err_i            (host_err[CoreD]),
+      .data_req_o            (core_data_req),
+      .data_gnt_i            (core_data_gnt),
+      .data_rvalid_i         (core_data_rvalid),
+      .data_we_o             (core_data_we),
+      .data_be_o             (core_data_be),
+      .data_addr_o           (core_data_addr),
+      .data_wdata_o          (core_data_wdata),
+      .data_rdata_i          (core_data_rdata),
+      .data_err_i            (core_data_err),
 
       .irq_software_i        (1'b0),
       .irq_timer_i           (timer_irq),
@@ -212,33 +274,301 @@ module ibex_simple_system (
       .fetch_enable_i        ('b1),
       .alert_minor_o         (),
       .alert_major_o         (),
-      .core_sleep_o          ()
+      .core_sleep_o          (core_sleep)
     );
 
-  // SRAM block for instruction and data storage
-  ram_2p #(
-      .Depth(1024*1024/4),
-      .MemInitFile(SRAMInitFile)
-    ) u_ram (
-      .clk_i       (clk_sys),
-      .rst_ni      (rst_sys_n),
-
-      .a_req_i     (device_req[Ram]),
-      .a_we_i      (device_we[Ram]),
-      .a_be_i      (device_be[Ram]),
-      .a_addr_i    (device_addr[Ram]),
-      .a_wdata_i   (device_wdata[Ram]),
-      .a_rvalid_o  (device_rvalid[Ram]),
-      .a_rdata_o   (device_rdata[Ram]),
-
-      .b_req_i     (instr_req),
-      .b_we_i      (1'b0),
-      .b_be_i      (4'b0),
-      .b_addr_i    (instr_addr),
-      .b_wdata_i   (32'b0),
-      .b_rvalid_o  (instr_rvalid),
-      .b_rdata_o   (instr_rdata)
-    );
+  // Memory latency models for instruction fetch and data accesses. These pass requests through
+  // unchanged unless latency is configured on the command line of the Verilator simulation (see
+  // dv/verilator/mem_latency).
+  mem_latency #(
+    .PortId(0)
+  ) u_instr_latency (
+    .clk_i         (clk_sys),
+    .rst_ni        (rst_sys_n),
+
+    .host_req_i    (instr_req),
+    .host_gnt_o    (instr_gnt),
+    .host_addr_i   (instr_addr),
+    .host_we_i     (1'b0),
+    .host_be_i     (4'b0),
+    .host_wdata_i  (32'b0),
+    .host_rvalid_o (instr_rvalid),
+    .host_rdata_o  (instr_rdata),
+    .host_err_o    (instr_err),
+
+    .dev_req_o     (ram_instr_req),
+    .dev_gnt_i     (ram_instr_gnt),
+    .dev_addr_o    (ram_instr_addr),
+    .dev_we_o      (),
+    .dev_be_o      (),
+    .dev_wdata_o   (),
+    .dev_rvalid_i  (ram_instr_rvalid),
+    .dev_rdata_i   (ram_instr_rdata),
+    .dev_err_i     (ram_instr_err)
+  );
+
+  // Instruction fetch either has a port of the RAM to itself, or shares the bus with data accesses
+  if (HarvardMem) begin : gen_harvard_fetch
+    assign ram_instr_gnt = 1'b1;
+    assign ram_instr_err = 1'b0;
+
+    assign ram_b_req = ram_instr_req;
+    assign ram_instr_rvalid = ram_b_rvalid;
+    assign ram_instr_rdata = ram_b_rdata;
+  end else begin : gen_unified_fetch
+    assign host_req[CoreI] = ram_instr_req;
+    assign host_addr[CoreI] = ram_instr_addr;
+    assign host_we[CoreI] = 1'b0;
+    assign host_be[CoreI] = 4'b0;
+    assign host_wdata[CoreI] = 32'b0;
+    assign ram_instr_gnt = host_gnt[CoreI];
+    assign ram_instr_rvalid = host_rvalid[CoreI];
+    assign ram_instr_rdata = host_rdata[CoreI];
+    assign ram_instr_err = host_err[CoreI];
+
+    assign ram_b_req = 1'b0;
+
+    logic        unused_ram_b_rvalid;
+    logic [31:0] unused_ram_b_rdata;
+    assign unused_ram_b_rvalid = ram_b_rvalid;
+    assign unused_ram_b_rdata = ram_b_rdata;
+  end
+
+  mem_latency #(
+    .PortId(1)
+  ) u_data_latency (
+    .clk_i         (clk_sys),
+    .rst_ni        (rst_sys_n),
+
+    .host_req_i    (core_data_req),
+    .host_gnt_o    (core_data_gnt),
+    .host_addr_i   (core_data_addr),
+    .host_we_i     (core_data_we),
+    .host_be_i     (core_data_be),
+    .host_wdata_i  (core_data_wdata),
+    .host_rvalid_o (core_data_rvalid),
+    .host_rdata_o  (core_data_rdata),
+    .host_err_o    (core_data_err),
+
+    .dev_req_o     (host_req[CoreD]),
+    .dev_gnt_i     (host_gnt[CoreD]),
+    .dev_addr_o    (host_addr[CoreD]),
+    .dev_we_o      (host_we[CoreD]),
+    .dev_be_o      (host_be[CoreD]),
+    .dev_wdata_o   (host_wdata[CoreD]),
+    .dev_rvalid_i  (host_rvalid[CoreD]),
+    .dev_rdata_i   (host_rdata[CoreD]),
+    .dev_err_i     (host_err[CoreD])
+  );
+
+  // Memory watchpoints on the data port, configured on the command line of the Verilator
+  // simulation (see dv/verilator/mem_watch). Load/store requests are issued by the instruction in
+  // the ID/EX stage, so its PC is logged with each access.
+  mem_watch u_data_watch (
+    .clk_i    (clk_sys),
+    .rst_ni   (rst_sys_n),
+
+    .req_i    (host_req[CoreD]),
+    .gnt_i    (host_gnt[CoreD]),
+    .addr_i   (host_addr[CoreD]),
+    .we_i     (host_we[CoreD]),
+    .be_i     (host_be[CoreD]),
+    .wdata_i  (host_wdata[CoreD]),
+    .rvalid_i (host_rvalid[CoreD]),
+    .rdata_i  (host_rdata[CoreD]),
+
+    .pc_i     (u_core.u_ibex_core.pc_id)
+  );
+
+  // SRAM block for instruction and data storage. Port B is only used for instruction fetch with
+  // HarvardMem. With SparseRam the memory contents are held in a sparse map in the Verilator C++
+  // model instead (see dv/verilator/sparse_mem).
+  if (SparseRam) begin : gen_sparse_ram
+    sparse_ram_2p #(
+        .Depth(RamSize / 4),
+        .MemId(0)
+      ) u_ram (
+        .clk_i       (clk_sys),
+        .rst_ni      (rst_sys_n),
+
+        .a_req_i     (device_req[Ram]),
+        .a_we_i      (device_we[Ram]),
+        .a_be_i      (device_be[Ram]),
+        .a_addr_i    (device_addr[Ram]),
+        .a_wdata_i   (device_wdata[Ram]),
+        .a_rvalid_o  (device_rvalid[Ram]),
+        .a_rdata_o   (device_rdata[Ram]),
+
+        .b_req_i     (ram_b_req),
+        .b_we_i      (1'b0),
+        .b_be_i      (4'b0),
+        .b_addr_i    (ram_instr_addr),
+        .b_wdata_i   (32'b0),
+        .b_rvalid_o  (ram_b_rvalid),
+        .b_rdata_o   (ram_b_rdata)
+      );
+  end else begin : gen_ram
+    ram_2p #(
+        .Depth(RamSize / 4),
+        .MemInitFile(SRAMInitFile)
+      ) u_ram (
+        .clk_i       (clk_sys),
+        .rst_ni      (rst_sys_n),
+
+        .a_req_i     (device_req[Ram]),
+        .a_we_i      (device_we[Ram]),
+        .a_be_i      (device_be[Ram]),
+        .a_addr_i    (device_addr[Ram]),
+        .a_wdata_i   (device_wdata[Ram]),
+        .a_rvalid_o  (device_rvalid[Ram]),
+        .a_rdata_o   (device_rdata[Ram]),
+
+        .b_req_i     (ram_b_req),
+        .b_we_i      (1'b0),
+        .b_be_i      (4'b0),
+        .b_addr_i    (ram_instr_addr),
+        .b_wdata_i   (32'b0),
+        .b_rvalid_o  (ram_b_rvalid),
+        .b_rdata_o   (ram_b_rdata)
+      );
+  end
+
+  // Measures the latency from the assertion of the timer interrupt to the retirement of the first
+  // instruction of its handler (see dv/verilator/irq_latency). The timer interrupt (exception code
+  // 7) is vectored to mtvec base + 0x1C.
+  irq_latency_monitor #(
+    .IrqId(7)
+  ) u_timer_irq_latency (
+    .clk_i           (clk_sys),
+    .rst_ni          (rst_sys_n),
+
+    .irq_i           (timer_irq),
+    .irq_enabled_i   (u_core.u_ibex_core.csr_mstatus_mie &
+                      u_core.u_ibex_core.cs_registers_i.mie_q.irq_timer),
+    .handler_pc_i    ({u_core.u_ibex_core.csr_mtvec[31:8], 8'h1C}),
+
+    .core_sleep_i    (core_sleep),
+    .div_wait_i      (u_core.u_ibex_core.perf_div_wait),
+    .mul_wait_i      (u_core.u_ibex_core.perf_mul_wait),
+    .lsu_busy_i      (u_core.u_ibex_core.lsu_busy),
+
+    .rvfi_valid_i    (u_core.rvfi_valid),
+    .rvfi_intr_i     (u_core.rvfi_intr),
+    .rvfi_pc_rdata_i (u_core.rvfi_pc_rdata)
+  );
+
+  // Compressed binary trace of all retired instructions, enabled on the command line of the
+  // Verilator simulation (see dv/verilator/bin_trace)
+  bin_trace u_bin_trace (
+    .clk_i            (clk_sys),
+    .rst_ni           (rst_sys_n),
+
+    .rvfi_valid_i     (u_core.rvfi_valid),
+    .rvfi_pc_rdata_i  (u_core.rvfi_pc_rdata),
+    .rvfi_insn_i      (u_core.rvfi_insn),
+    .rvfi_trap_i      (u_core.rvfi_trap),
+    .rvfi_intr_i      (u_core.rvfi_intr),
+    .rvfi_rd_addr_i   (u_core.rvfi_rd_addr),
+    .rvfi_rd_wdata_i  (u_core.rvfi_rd_wdata),
+    .rvfi_mem_addr_i  (u_core.rvfi_mem_addr),
+    .rvfi_mem_rmask_i (u_core.rvfi_mem_rmask),
+    .rvfi_mem_wmask_i (u_core.rvfi_mem_wmask),
+    .rvfi_mem_rdata_i (u_core.rvfi_mem_rdata),
+    .rvfi_mem_wdata_i (u_core.rvfi_mem_wdata)
+  );
+
+  // Occupancy of the instruction fetch unit and front-end bound cycles, enabled on the command
+  // line of the Verilator simulation (see dv/verilator/fetch_monitor). Without an instruction cache
+  // the core fetches through ibex_prefetch_buffer, with up to NUM_REQS (2) outstanding requests
+  // and a fetch FIFO of NUM_REQS + 1 entries. The instruction cache doesn't provide its occupancy.
+  logic [3:0] fetch_outstanding;
+  logic [3:0] fetch_fifo_occupancy;
+
+  if (ICache) begin : gen_icache_fetch_occupancy
+    assign fetch_outstanding = '0;
+    assign fetch_fifo_occupancy = '0;
+  end else begin : gen_prefetch_fetch_occupancy
+    assign fetch_outstanding = 4'($countones(
+        u_core.u_ibex_core.if_stage_i.gen_prefetch_buffer.prefetch_buffer_i.rdata_outstanding_q));
+    assign fetch_fifo_occupancy = 4'($countones(
+        u_core.u_ibex_core.if_stage_i.gen_prefetch_buffer.prefetch_buffer_i.fifo_i.valid_q));
+  end
+
+  fetch_monitor #(
+    .MaxOutstanding ( ICache ? 0 : 2 ),
+    .FifoDepth      ( ICache ? 0 : 3 )
+  ) u_fetch_monitor (
+    .clk_i            (clk_sys),
+    .rst_ni           (rst_sys_n),
+
+    .outstanding_i    (fetch_outstanding),
+    .fifo_occupancy_i (fetch_fifo_occupancy),
+    .fetch_valid_i    (u_core.u_ibex_core.if_stage_i.fetch_valid),
+    .id_starved_i     (u_core.u_ibex_core.perf_iside_wait),
+    .core_sleep_i     (core_sleep)
+  );
+
+  // Switching activity of key nets of the core for the energy estimate, enabled on the command
+  // line of the Verilator simulation (see dv/verilator/energy). Keep the nets in sync with the
+  // RegisterNet() calls in ibex_simple_system.cc.
+  localparam int NrEnergyNets = 7;
+  localparam int EnergyNetWidth = 192;
+
+  logic [EnergyNetWidth-1:0] energy_net [NrEnergyNets];
+
+  assign energy_net[0] = EnergyNetWidth'({u_core.u_ibex_core.rf_we_wb,
+                                          u_core.u_ibex_core.rf_waddr_wb,
+                                          u_core.u_ibex_core.rf_wdata_wb});
+  assign energy_net[1] = EnergyNetWidth'({u_core.u_ibex_core.rf_rdata_a,
+                                          u_core.u_ibex_core.rf_rdata_b});
+  assign energy_net[2] = EnergyNetWidth'({u_core.u_ibex_core.alu_operand_a_ex,
+                                          u_core.u_ibex_core.alu_operand_b_ex});
+  assign energy_net[3] = EnergyNetWidth'({u_core.u_ibex_core.multdiv_operand_a_ex,
+                                          u_core.u_ibex_core.multdiv_operand_b_ex});
+  assign energy_net[4] = EnergyNetWidth'({instr_req, instr_addr, instr_rdata});
+  assign energy_net[5] = EnergyNetWidth'({core_data_req, core_data_we, core_data_be,
+                                          core_data_addr, core_data_wdata, core_data_rdata});
+
+  // Tag and data array accesses of the instruction cache
+  if (ICache) begin : gen_icache_energy
+    assign energy_net[6] = EnergyNetWidth'({
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.tag_req_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.tag_write_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.data_req_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.data_write_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.tag_wdata_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.data_wdata_ic0,
+        u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.hit_data_ic1});
+  end else begin : gen_no_icache_energy
+    assign energy_net[6] = '0;
+  end
+
+  energy_monitor #(
+    .NrNets   ( NrEnergyNets   ),
+    .NetWidth ( EnergyNetWidth )
+  ) u_energy_monitor (
+    .clk_i  (clk_sys),
+    .rst_ni (rst_sys_n),
+
+    .net_i  (energy_net)
+  );
+
+  // Dummy instructions inserted with SecureIbex and the cycles they take, enabled on the command
+  // line of the Verilator simulation (see dv/verilator/dummy_instr_stats). Also provides the
+  // cpuctrl bits software sets at startup.
+  logic [31:0] sim_cpuctrl;
+
+  dummy_instr_monitor u_dummy_instr_monitor (
+    .clk_i              (clk_sys),
+    .rst_ni             (rst_sys_n),
+
+    .dummy_instr_en_i   (u_core.u_ibex_core.dummy_instr_en),
+    .dummy_instr_mask_i (u_core.u_ibex_core.dummy_instr_mask),
+    .instr_ret_i        (u_core.u_ibex_core.instr_id_done),
+    .dummy_instr_id_i   (u_core.u_ibex_core.instr_valid_id & u_core.u_ibex_core.dummy_instr_id),
+
+    .cpuctrl_o          (sim_cpuctrl)
+  );
 
   simulator_ctrl #(
     .LogName("ibex_simple_system.log")
@@ -252,7 +582,14 @@ module ibex_simple_system (
       .addr_i    (device_addr[SimCtrl]),
       .wdata_i   (device_wdata[SimCtrl]),
       .rvalid_o  (device_rvalid[SimCtrl]),
-      .rdata_o   (device_rdata[SimCtrl])
+      .rdata_o   (device_rdata[SimCtrl]),
+
+      .roi_valid_o (roi_valid),
+      .roi_begin_o (roi_begin),
+      .roi_id_o    (roi_id),
+      .halted_o    (),
+
+      .cpuctrl_i   (sim_cpuctrl)
     );
 
   timer #(
@@ -273,10 +610,62 @@ module ibex_simple_system (
       .timer_intr_o   (timer_irq)
     );
 
+  // The RAM must not overlap the other devices, which are below 0x100000
+  `ASSERT_INIT(RamSizeLegal, RamSize >= 4 && (RamSize & (RamSize - 1)) == 0)
+  `ASSERT_INIT(RamBaseLegal, (RamBase & (RamSize - 1)) == 0 && RamBase >= 32'h100000)
+
+  export "DPI-C" function ram_size_get;
+
+  function automatic int unsigned ram_size_get();
+    return RamSize;
+  endfunction
+
+  export "DPI-C" function harvard_mem_get;
+
+  function automatic int harvard_mem_get();
+    return int'(HarvardMem);
+  endfunction
+
   export "DPI-C" function mhpmcounter_get;
 
   function automatic longint mhpmcounter_get(int index);
     return u_core.u_ibex_core.cs_registers_i.mhpmcounter[index];
   endfunction
 
+  // Simulation-only event counters of the instruction cache (see "Performance probes" in
+  // ibex_icache.sv). No counters are reported if the core is built without an ICache.
+  localparam int NrICacheCounters = 7;
+
+  logic [63:0] icache_counter [NrICacheCounters];
+
+  if (ICache) begin : gen_icache_counters
+    assign icache_counter = u_core.u_ibex_core.if_stage_i.gen_icache.icache_i.perf_cnt_q;
+  end else begin : gen_no_icache_counters
+    assign icache_counter = '{default: '0};
+  end
+
+  export "DPI-C" function icache_counter_num;
+
+  function automatic int icache_counter_num();
+    return ICache ? NrICacheCounters : 0;
+  endfunction
+
+  export "DPI-C" function icache_counter_get;
+
+  function automatic longint icache_counter_get(int index);
+    return icache_counter[index];
+  endfunction
+
+`ifdef VERILATOR
+  // Pass region of interest markers to the C++ model (see dv/verilator/roi), which samples the
+  // performance counters through mhpmcounter_get().
+  import "DPI-C" context function void ibex_roi_marker(input int id, input bit is_begin);
+
+  always_ff @(posedge clk_sys) begin
+    if (roi_valid) begin
+      ibex_roi_marker(roi_id, roi_begin);
+    end
+  end
+`endif
+
 endmodule
@@ -112,6 +112,9 @@ void start_time(void) {
   pcount_enable(0);
   pcount_reset();
   pcount_enable(1);
+  // Also mark the timed portion as region of interest 1, so the simulator
+  // reports its statistics (e.g. the energy estimate) separately
+  sim_roi_begin(1);
   GETMYTIME(&start_time_val);
 }
 
@@ -125,6 +128,7 @@ void start_time(void) {
 */
 void stop_time(void) {
   GETMYTIME(&stop_time_val);
+  sim_roi_end(1);
   pcount_enable(0);
 }
 
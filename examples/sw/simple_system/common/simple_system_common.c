@@ -36,6 +36,14 @@ void puthex(uint32_t h) {
 
 void sim_halt() { DEV_WRITE(SIM_CTRL_BASE + SIM_CTRL_CTRL, 1); }
 
+void sim_roi_begin(uint32_t id) {
+  DEV_WRITE(SIM_CTRL_BASE + SIM_CTRL_ROI_BEGIN, id);
+}
+
+void sim_roi_end(uint32_t id) {
+  DEV_WRITE(SIM_CTRL_BASE + SIM_CTRL_ROI_END, id);
+}
+
 void pcount_reset() {
   asm volatile(
       "csrw minstret,       x0\n"
@@ -42,6 +42,25 @@ void puthex(uint32_t h);
  */
 void sim_halt();
 
+/**
+ * Marks the beginning of a region of interest (ROI).
+ *
+ * When the simulator is run with ROI reporting, all performance counters are
+ * sampled at the beginning and end of every region and per-region statistics
+ * are reported at the end of the simulation. Regions may be nested and the same
+ * ID may be used multiple times, repeated executions are aggregated.
+ *
+ * @param id Identifier of the region
+ */
+void sim_roi_begin(uint32_t id);
+
+/**
+ * Marks the end of a region of interest (ROI) started with sim_roi_begin().
+ *
+ * @param id Identifier of the region
+ */
+void sim_roi_end(uint32_t id);
+
 /**
  * Enables/disables performance counters.  This effects mcycle and minstret as
  * well as the mhpmcounterN counters.
@@ -8,6 +8,9 @@
 #define SIM_CTRL_BASE 0x20000
 #define SIM_CTRL_OUT 0x0
 #define SIM_CTRL_CTRL 0x8
+#define SIM_CTRL_ROI_BEGIN 0x10
+#define SIM_CTRL_ROI_END 0x18
+#define SIM_CTRL_CPUCTRL 0x20
 
 #define TIMER_BASE 0x30000
 #define TIMER_MTIME 0x0
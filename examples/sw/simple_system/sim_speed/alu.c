@@ -0,0 +1,29 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Tight loop of single-cycle ALU instructions
+
+#include "simple_system_common.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 200000
+#endif
+
+int main(int argc, char **argv) {
+  uint32_t x = 0x12345678;
+  uint32_t acc = 0;
+
+  for (int i = 0; i < ITERATIONS; ++i) {
+    // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    acc += (x & 0xff) | (acc >> 3);
+  }
+
+  puthex(acc);
+  putchar('\n');
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Divide heavy kernel, keeps the multi-cycle divider busy
+
+#include "simple_system_common.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 40000
+#endif
+
+int main(int argc, char **argv) {
+  volatile uint32_t divisor = 7;
+  uint32_t x = 0xFFFFFFFF;
+  uint32_t acc = 0;
+
+  for (int i = 0; i < ITERATIONS; ++i) {
+    acc += x / divisor;
+    acc ^= x % (divisor + i);
+    x = x * 1664525u + 1013904223u;
+  }
+
+  puthex(acc);
+  putchar('\n');
+
+  return 0;
+}
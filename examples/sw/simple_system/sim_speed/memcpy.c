@@ -0,0 +1,41 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Load/store heavy copying of buffers, word-wise and byte-wise
+
+#include "simple_system_common.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS 40
+#endif
+
+#define BUF_WORDS 2048
+
+static uint32_t src[BUF_WORDS];
+static uint32_t dst[BUF_WORDS];
+
+int main(int argc, char **argv) {
+  for (int i = 0; i < BUF_WORDS; ++i) {
+    src[i] = i * 0x9E3779B9u;
+  }
+
+  for (int n = 0; n < ITERATIONS; ++n) {
+    volatile uint32_t *s = src;
+    volatile uint32_t *d = dst;
+    for (int i = 0; i < BUF_WORDS; ++i) {
+      d[i] = s[i];
+    }
+
+    volatile uint8_t *sb = (volatile uint8_t *)dst;
+    volatile uint8_t *db = (volatile uint8_t *)src;
+    for (int i = 0; i < BUF_WORDS * 4; ++i) {
+      db[i] = sb[i] + 1;
+    }
+  }
+
+  puthex(src[BUF_WORDS - 1]);
+  putchar('\n');
+
+  return 0;
+}
@@ -0,0 +1,32 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Interrupt heavy workload: a timer interrupt every few hundred cycles
+
+#include "simple_system_common.h"
+
+#ifndef INTERRUPTS
+#define INTERRUPTS 5000
+#endif
+
+#ifndef TIMER_INTERVAL
+#define TIMER_INTERVAL 200
+#endif
+
+int main(int argc, char **argv) {
+  uint32_t spins = 0;
+
+  timer_enable(TIMER_INTERVAL);
+
+  while (get_elapsed_time() < INTERRUPTS) {
+    spins++;
+  }
+
+  timer_disable();
+
+  puthex(spins);
+  putchar('\n');
+
+  return 0;
+}
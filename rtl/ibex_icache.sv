@@ -1005,6 +1005,46 @@ module ibex_icache #(
   // outstanding.
   assign busy_o = inval_prog_q | (|(fill_busy_q & ~fill_rvd_done));
 
+  ////////////////////////
+  // Performance probes //
+  ////////////////////////
+
+`ifndef SYNTHESIS
+  // Simulation-only event counters. These are not architecturally visible, they are read by the
+  // simulation environment (see icache_counter_get() in ibex_simple_system.sv). The counter order
+  // must match ibex_icache_counter_names in dv/verilator/pcount/cpp/ibex_pcounts.cc.
+  localparam int unsigned NumPerfCounters = 7;
+
+  logic [NumPerfCounters-1:0] perf_event;
+  logic [63:0]                perf_cnt_q [NumPerfCounters];
+
+  // Lookups which reached IC1 with the cache enabled
+  assign perf_event[0] = lookup_valid_ic1;
+  // Lookups which hit in the cache
+  assign perf_event[1] = lookup_valid_ic1 & tag_hit_ic1 & ~ecc_err_ic1;
+  // Lookups which missed in the cache (an ECC error is treated as a miss)
+  assign perf_event[2] = lookup_valid_ic1 & ~(tag_hit_ic1 & ~ecc_err_ic1);
+  // Lines written into the cache by a fill buffer
+  assign perf_event[3] = |fill_ram_arb;
+  // Cycles in which the core requests data but no lookup can be made because all fill buffers are
+  // busy or lookups are throttled
+  assign perf_event[4] = req_i & ~branch_i & (&fill_busy_q | lookup_throttle);
+  // Invalidations started (including the one following reset)
+  assign perf_event[5] = start_inval;
+  // Lookups with a tag or data ECC error
+  assign perf_event[6] = ecc_err_ic1;
+
+  for (genvar i = 0; i < NumPerfCounters; i++) begin : gen_perf_cnt
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        perf_cnt_q[i] <= '0;
+      end else if (perf_event[i]) begin
+        perf_cnt_q[i] <= perf_cnt_q[i] + 64'd1;
+      end
+    end
+  end
+`endif
+
   ////////////////
   // Assertions //
   ////////////////
@@ -12,13 +12,16 @@
  * following simplifying assumptions.
  *
  * - All devices (slaves) must respond in the next cycle after the request.
- * - Host (master) arbitration is strictly priority based.
+ * - Host (master) arbitration is strictly priority based, with host 0 having
+ *   the highest priority. With RoundRobin set the host granted last has the
+ *   lowest priority instead, so that no host can starve the others.
  */
 module bus #(
   parameter int NrDevices    = 1,
   parameter int NrHosts      = 1,
   parameter int DataWidth    = 32,
-  parameter int AddressWidth = 32
+  parameter int AddressWidth = 32,
+  parameter bit RoundRobin   = 1'b0
 ) (
   input                           clk_i,
   input                           rst_ni,
@@ -58,10 +61,32 @@ module bus #(
   logic [NumBitsDeviceSel-1:0] device_sel_req, device_sel_resp;
 
   // Master select prio arbiter
-  always_comb begin
-    for (integer host = NrHosts - 1; host >= 0; host = host - 1) begin
-      if (host_req_i[host]) begin
-        host_sel_req = NumBitsHostSel'(host);
+  if (RoundRobin) begin : gen_arb_round_robin
+    logic [NumBitsHostSel-1:0] host_sel_last;
+
+    // Search from the host after the one granted last, wrapping around
+    always_comb begin
+      host_sel_req = host_sel_last;
+      for (integer i = NrHosts; i > 0; i = i - 1) begin
+        if (host_req_i[(int'(host_sel_last) + i) % NrHosts]) begin
+          host_sel_req = NumBitsHostSel'((int'(host_sel_last) + i) % NrHosts);
+        end
+      end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        host_sel_last <= '0;
+      end else if (host_req_i[host_sel_req]) begin
+        host_sel_last <= host_sel_req;
+      end
+    end
+  end else begin : gen_arb_prio
+    always_comb begin
+      for (integer host = NrHosts - 1; host >= 0; host = host - 1) begin
+        if (host_req_i[host]) begin
+          host_sel_req = NumBitsHostSel'(host);
+        end
       end
     end
   end
@@ -6,12 +6,22 @@
  * Module for communicating with the simulator that interfaces via the memory
  * system.
  *
- * Contains two registers
+ * Contains five registers
  *
  * * 0x0 - CHAR_OUT_ADDR - [7:0] of write data output via output_char DPI call
  * and SimOutputManager (see dv/common/cpp/sim_output_manager.cc)
  *
- * * 0x8 - SIM_CTRL_ADDR - Write 1 to bit 0 to halt sim
+ * * 0x8 - SIM_CTRL_ADDR - Write 1 to bit 0 to halt sim (or only to set
+ * halted_o if FinishOnHalt is clear)
+ *
+ * * 0x10 - ROI_BEGIN_ADDR - Write an ID to mark the beginning of a region of
+ * interest, signalled on the roi_* outputs
+ *
+ * * 0x18 - ROI_END_ADDR - Write an ID to mark the end of a region of interest
+ *
+ * * 0x20 - CPUCTRL_ADDR - Read the bits software should set in the cpuctrl CSR
+ * at startup, given on the cpuctrl_i input (e.g. to enable dummy instructions
+ * from the simulator command line)
  *
  * The slightly odd spacing is because we also use SIM_CTRL_ADDR when
  * simulating simple_system code with Spike, which requires the address to be
@@ -24,7 +34,10 @@ module simulator_ctrl #(
   parameter string LogName = "ibex_out.log",
   // If set flush on every char (useful for monitoring output whilst
   // simulation is running).
-  parameter bit    FlushOnChar = 1
+  parameter bit    FlushOnChar = 1,
+  // If set end the simulation on a halt request, otherwise only signal it on
+  // halted_o (e.g. to wait for other cores to halt as well).
+  parameter bit    FinishOnHalt = 1
 ) (
   input               clk_i,
   input               rst_ni,
@@ -35,11 +48,26 @@ module simulator_ctrl #(
   input        [31:0] addr_i,
   input        [31:0] wdata_i,
   output logic        rvalid_o,
-  output logic [31:0] rdata_o
+  output logic [31:0] rdata_o,
+
+  // Region of interest marker, valid for a single cycle after the register
+  // write
+  output logic        roi_valid_o,
+  output logic        roi_begin_o,
+  output logic [31:0] roi_id_o,
+
+  // Set from the cycle after a halt request
+  output logic        halted_o,
+
+  // Value read from CPUCTRL_ADDR
+  input        [31:0] cpuctrl_i
 );
 
   localparam logic [7:0] CHAR_OUT_ADDR = 8'h0;
   localparam logic [7:0] SIM_CTRL_ADDR = 8'h2;
+  localparam logic [7:0] ROI_BEGIN_ADDR = 8'h4;
+  localparam logic [7:0] ROI_END_ADDR = 8'h6;
+  localparam logic [7:0] CPUCTRL_ADDR = 8'h8;
 
   logic [7:0] ctrl_addr;
   logic [2:0] sim_finish = 3'b000;
@@ -59,10 +87,16 @@ module simulator_ctrl #(
   always_ff @(posedge clk_i or negedge rst_ni) begin
     if (~rst_ni) begin
       rvalid_o <= 0;
+      rdata_o <= '0;
       sim_finish <= 'b0;
+      roi_valid_o <= 1'b0;
+      roi_begin_o <= 1'b0;
+      roi_id_o <= '0;
     end else begin
       // Immeditely respond to any request
       rvalid_o <= req_i;
+      rdata_o <= (req_i && !we_i && ctrl_addr == CPUCTRL_ADDR) ? cpuctrl_i : '0;
+      roi_valid_o <= 1'b0;
 
       if (req_i & we_i) begin
         case (ctrl_addr)
@@ -77,22 +111,35 @@ module simulator_ctrl #(
           end
           SIM_CTRL_ADDR: begin
             if ((be_i[0] & wdata_i[0]) && (sim_finish == 'b0)) begin
-              $display("Terminating simulation by software request.");
+              if (FinishOnHalt) begin
+                $display("Terminating simulation by software request.");
+              end else begin
+                $display("%m: Halted by software request.");
+              end
               sim_finish <= 3'b001;
             end
           end
+          ROI_BEGIN_ADDR, ROI_END_ADDR: begin
+            if (&be_i) begin
+              roi_valid_o <= 1'b1;
+              roi_begin_o <= ctrl_addr == ROI_BEGIN_ADDR;
+              roi_id_o <= wdata_i;
+            end
+          end
           default: ;
         endcase
       end
     end
 
-    if (sim_finish != 'b0) begin
-      sim_finish <= sim_finish + 1;
-    end
-    if (sim_finish >= 3'b010) begin
-      $finish;
+    if (FinishOnHalt) begin
+      if (sim_finish != 'b0) begin
+        sim_finish <= sim_finish + 1;
+      end
+      if (sim_finish >= 3'b010) begin
+        $finish;
+      end
     end
   end
 
-  assign rdata_o = '0;
+  assign halted_o = sim_finish != 'b0;
 endmodule
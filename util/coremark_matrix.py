@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Run CoreMark on Simple System for a set of Ibex configurations
+
+Builds a Verilator Simple System simulator for each requested configuration
+from ibex_configs.yaml (one after the other), runs CoreMark on each of them and
+collects the CoreMark/MHz score together with the performance counters from
+ibex_simple_system_pcount.csv.
+
+Results are appended to a history file (one JSON object per line). The results
+of a run are compared against the most recent entry in the history file with
+the same ISA string, and any configuration whose CoreMark/MHz drops, or whose
+CPI rises, by more than a threshold is flagged as a regression.
+'''
+
+import argparse
+import csv
+import datetime
+import json
+import logging
+import os
+import re
+import shlex
+import subprocess
+import sys
+from typing import Dict, List, Optional, Tuple, Union
+
+import ibex_config
+
+_IBEX_ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+_COREMARK_DIR = os.path.join(_IBEX_ROOT, 'examples', 'sw', 'benchmarks',
+                             'coremark')
+_SIM_BINARY = os.path.join('sim-verilator', 'Vibex_simple_system')
+
+_ITERATIONS_RE = re.compile(r'^Iterations\s*:\s*(\d+)', re.MULTILINE)
+_TICKS_RE = re.compile(r'^Total ticks\s*:\s*(\d+)', re.MULTILINE)
+
+# Extensions added to the ISA string for the RV32B parameter of a
+# configuration, so that configurations with bitmanip run bitmanip code. The
+# balanced configuration only implements some of the (draft) sub-extensions.
+_RV32B_ISA_EXTS = {
+    'ibex_pkg::RV32BNone': '',
+    'ibex_pkg::RV32BBalanced': '_zbb_zbs_zbt_zbf',
+    'ibex_pkg::RV32BFull': 'b'
+}
+
+
+def run_cmd(cmd: List[str], cwd: str, log_path: str,
+            env: Optional[Dict[str, str]] = None) -> None:
+    '''Run a command, writing its output to log_path'''
+    cmd_str = ' '.join([shlex.quote(a) for a in cmd])
+    logging.debug('Running {} in {}'.format(cmd_str, cwd))
+    with open(log_path, 'w') as log_file:
+        proc = subprocess.run(cmd, cwd=cwd, stdout=log_file,
+                              stderr=subprocess.STDOUT, env=env)
+    if proc.returncode != 0:
+        raise RuntimeError('Command failed with exit code {} (see {}): {}'
+                           .format(proc.returncode, log_path, cmd_str))
+
+
+def build_coremark(isa: str, out_dir: str) -> str:
+    '''Build CoreMark for the given ISA string and return the ELF path'''
+    log_prefix = os.path.join(out_dir, 'coremark_{}'.format(isa))
+    make = ['make', '-C', _COREMARK_DIR]
+    run_cmd(make + ['clean'], _IBEX_ROOT, log_prefix + '_clean.log')
+    run_cmd(make + ['RV_ISA=' + isa], _IBEX_ROOT, log_prefix + '_build.log')
+
+    elf_path = os.path.join(out_dir, 'coremark_{}.elf'.format(isa))
+    os.replace(os.path.join(_COREMARK_DIR, 'coremark.elf'), elf_path)
+    return elf_path
+
+
+def config_isa(config: Dict[str, object], base_isa: str) -> str:
+    '''Return the ISA string to build CoreMark with for a configuration'''
+    rv32b = str(config.get('RV32B', 'ibex_pkg::RV32BNone'))
+    if rv32b not in _RV32B_ISA_EXTS:
+        raise ValueError('Unknown RV32B value: {}'.format(rv32b))
+    return base_isa + _RV32B_ISA_EXTS[rv32b]
+
+
+def build_simulator(config_name: str, config: Dict[str, object], jobs: int,
+                    out_dir: str) -> str:
+    '''Build Simple System for one configuration and return the binary path
+
+    The simulator is built with jobs parallel make jobs.
+    '''
+    build_root = os.path.join(out_dir, config_name, 'build')
+    fusesoc_opts = ibex_config.FusesocOpts().output(config, None)
+    cmd = (['fusesoc', '--cores-root=' + _IBEX_ROOT, 'run', '--target=sim',
+            '--setup', '--build', '--build-root=' + build_root,
+            'lowrisc:ibex:ibex_simple_system'] +
+           shlex.split(fusesoc_opts))
+
+    # FuseSoC runs make to compile the Verilated model
+    env = dict(os.environ)
+    env['MAKEFLAGS'] = '-j{}'.format(jobs)
+
+    logging.info('Building simulator for {}'.format(config_name))
+    run_cmd(cmd, _IBEX_ROOT, os.path.join(out_dir, config_name, 'build.log'),
+            env)
+    return os.path.join(build_root, _SIM_BINARY)
+
+
+def parse_stat(value: str) -> Union[int, float, str]:
+    '''Parse a statistic value, which isn't necessarily an integer'''
+    for parse in (int, float):
+        try:
+            return parse(value)
+        except ValueError:
+            pass
+    return value
+
+
+def read_pcounts(csv_path: str) -> Dict[str, Union[int, float, str]]:
+    '''Read a performance counter CSV file as written by Simple System
+
+    Besides the counters, the file holds the statistics of the enabled
+    simulator extensions, with ratios and other non-integer values. If a name
+    appears more than once, the first (counter) value is kept.
+    '''
+    pcounts = {}  # type: Dict[str, Union[int, float, str]]
+    with open(csv_path, newline='') as csv_file:
+        for row in csv.reader(csv_file):
+            if len(row) == 2 and row[0] not in pcounts:
+                pcounts[row[0]] = parse_stat(row[1])
+    return pcounts
+
+
+def run_coremark(config_name: str, sim_binary: str, isa: str, elf_path: str,
+                 out_dir: str) -> Dict[str, object]:
+    '''Run CoreMark on a simulator and return the parsed results'''
+    run_dir = os.path.join(out_dir, config_name)
+    logging.info('Running CoreMark on {}'.format(config_name))
+    run_cmd([sim_binary, '--meminit=ram,' + elf_path], run_dir,
+            os.path.join(run_dir, 'sim.log'))
+
+    with open(os.path.join(run_dir, 'ibex_simple_system.log')) as log_file:
+        log = log_file.read()
+
+    iterations_match = _ITERATIONS_RE.search(log)
+    ticks_match = _TICKS_RE.search(log)
+    if (iterations_match is None or ticks_match is None or
+            'Correct operation validated' not in log):
+        raise RuntimeError('CoreMark did not complete successfully on {} '
+                           '(see {})'.format(config_name, run_dir))
+
+    iterations = int(iterations_match.group(1))
+    ticks = int(ticks_match.group(1))
+    pcounts = read_pcounts(os.path.join(run_dir,
+                                        'ibex_simple_system_pcount.csv'))
+
+    instrs = pcounts.get('Instructions Retired', 0)
+    cpi = pcounts['Cycles'] / instrs if instrs else None
+
+    return {
+        'isa': isa,
+        'coremark_per_mhz': (10 ** 6) * iterations / ticks,
+        'cpi': cpi,
+        'iterations': iterations,
+        'ticks': ticks,
+        'pcounts': pcounts
+    }
+
+
+def build_and_run(config_name: str, config: Dict[str, object], isa: str,
+                  elf_path: str, jobs: int,
+                  out_dir: str) -> Dict[str, object]:
+    '''Build the simulator for a configuration and run CoreMark on it'''
+    os.makedirs(os.path.join(out_dir, config_name), exist_ok=True)
+    sim_binary = build_simulator(config_name, config, jobs, out_dir)
+    return run_coremark(config_name, sim_binary, isa, elf_path, out_dir)
+
+
+def git_revision() -> str:
+    '''Return the current git revision of the Ibex repository'''
+    proc = subprocess.run(['git', 'rev-parse', 'HEAD'], cwd=_IBEX_ROOT,
+                          stdout=subprocess.PIPE, universal_newlines=True)
+    return proc.stdout.strip() if proc.returncode == 0 else 'unknown'
+
+
+def read_last_history_entry(history_path: str,
+                            isa: str) -> Optional[Dict[str, object]]:
+    '''Return the most recent history entry with the given ISA string'''
+    if not os.path.exists(history_path):
+        return None
+
+    last = None
+    with open(history_path) as history_file:
+        for line in history_file:
+            line = line.strip()
+            if not line:
+                continue
+            entry = json.loads(line)
+            if entry.get('isa') == isa:
+                last = entry
+    return last
+
+
+def find_regressions(results: Dict[str, Dict[str, object]],
+                     previous: Dict[str, object],
+                     threshold: float) -> List[Tuple[str, str, float, float]]:
+    '''Compare results against a previous history entry
+
+    Returns a list of (config, metric, previous value, new value) tuples for
+    every metric that got worse by more than threshold percent.
+    '''
+    regressions = []
+    prev_results = previous['results']
+    assert isinstance(prev_results, dict)
+
+    for config_name, result in sorted(results.items()):
+        prev = prev_results.get(config_name)
+        # Only compare results of CoreMark built with the same ISA string
+        if prev is None or prev.get('isa', result['isa']) != result['isa']:
+            continue
+
+        new_score = result['coremark_per_mhz']
+        old_score = prev['coremark_per_mhz']
+        assert isinstance(new_score, float)
+        if new_score < old_score * (1.0 - threshold / 100.0):
+            regressions.append((config_name, 'CoreMark/MHz', old_score,
+                                new_score))
+
+        new_cpi = result['cpi']
+        old_cpi = prev.get('cpi')
+        if new_cpi is not None and old_cpi is not None:
+            assert isinstance(new_cpi, float)
+            if new_cpi > old_cpi * (1.0 + threshold / 100.0):
+                regressions.append((config_name, 'CPI', old_cpi, new_cpi))
+
+    return regressions
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    argparser.add_argument('configs', nargs='*',
+                           help=('Configurations to benchmark (default: all '
+                                 'configurations in the config file)'))
+    argparser.add_argument('--config_filename',
+                           default=os.path.join(
+                               _IBEX_ROOT,
+                               ibex_config.get_config_file_location()),
+                           help='Config file to read')
+    argparser.add_argument('--isa', default='rv32im',
+                           help='ISA string to build CoreMark with, the '
+                                'bitmanip extensions of a configuration are '
+                                'added to it')
+    argparser.add_argument('--out-dir',
+                           default=os.path.join(_IBEX_ROOT, 'build',
+                                                'coremark_matrix'),
+                           help='Directory for builds and run outputs')
+    argparser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                           help='Number of make jobs for each simulator '
+                                'build (configurations are built one after '
+                                'the other)')
+    argparser.add_argument('--history',
+                           default=os.path.join(_IBEX_ROOT, 'build',
+                                                'coremark_history.jsonl'),
+                           help='History file to compare against and append '
+                                'results to')
+    argparser.add_argument('--threshold', type=float, default=1.0,
+                           help='Regression threshold in percent')
+    argparser.add_argument('--no-update', action='store_true',
+                           help="Don't append results to the history file")
+    argparser.add_argument('--verbose', '-v', action='store_true',
+                           help='Print commands as they are run')
+    args = argparser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(message)s')
+
+    with open(args.config_filename) as config_file:
+        config_dicts = ibex_config.get_config_dicts(config_file)
+
+    config_names = args.configs or list(config_dicts.keys())
+    for config_name in config_names:
+        if config_name not in config_dicts:
+            logging.error('Configuration {} not found in {}'
+                          .format(config_name, args.config_filename))
+            return 1
+
+    os.makedirs(args.out_dir, exist_ok=True)
+
+    # CoreMark is built in place, so build it once per ISA string up front
+    results = {}
+    failed = False
+    elf_paths = {}  # type: Dict[str, str]
+    config_isas = {}  # type: Dict[str, str]
+    for config_name in config_names:
+        try:
+            isa = config_isa(config_dicts[config_name], args.isa)
+            if isa not in elf_paths:
+                logging.info('Building CoreMark for {}'.format(isa))
+                elf_paths[isa] = build_coremark(isa, args.out_dir)
+            config_isas[config_name] = isa
+        except Exception as err:
+            logging.error('{}: {}'.format(config_name, err))
+            failed = True
+
+    # Simulators are built one after the other, as concurrent FuseSoC builds
+    # share the cores tree and would only compete for the same CPUs
+    for config_name, isa in config_isas.items():
+        try:
+            results[config_name] = build_and_run(config_name,
+                                                 config_dicts[config_name],
+                                                 isa, elf_paths[isa],
+                                                 args.jobs, args.out_dir)
+        except Exception as err:
+            logging.error('{}: {}'.format(config_name, err))
+            failed = True
+
+    print('\n{:<40} {:<24} {:>12} {:>8}'
+          .format('Config', 'ISA', 'CoreMark/MHz', 'CPI'))
+    for config_name in config_names:
+        if config_name not in results:
+            continue
+        result = results[config_name]
+        cpi = result['cpi']
+        print('{:<40} {:<24} {:>12.3f} {:>8}'
+              .format(config_name, result['isa'], result['coremark_per_mhz'],
+                      '{:.3f}'.format(cpi) if cpi is not None else '-'))
+
+    previous = read_last_history_entry(args.history, args.isa)
+    regressions = []
+    if previous is not None:
+        regressions = find_regressions(results, previous, args.threshold)
+        if regressions:
+            print('\nRegressions against {} (threshold {}%):'
+                  .format(previous.get('revision'), args.threshold))
+            for config_name, metric, old, new in regressions:
+                print('  {}: {} {:.3f} -> {:.3f}'
+                      .format(config_name, metric, old, new))
+
+    if not args.no_update and results:
+        entry = {
+            'date': datetime.datetime.now().isoformat(timespec='seconds'),
+            'revision': git_revision(),
+            'isa': args.isa,
+            'results': results
+        }
+        os.makedirs(os.path.dirname(os.path.abspath(args.history)),
+                    exist_ok=True)
+        with open(args.history, 'a') as history_file:
+            history_file.write(json.dumps(entry, sort_keys=True) + '\n')
+
+    return 1 if failed or regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
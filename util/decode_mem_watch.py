@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Decode a binary memory watchpoint log
+
+Prints the accesses logged by the memory watchpoints of Simple System
+(--watch, see dv/verilator/mem_watch) one per line, optionally filtered by
+watchpoint index and access type.
+'''
+
+import argparse
+import struct
+import sys
+
+_MAGIC = b'IBEXWTCH'
+_VERSION = 1
+_HEADER = struct.Struct('<8sII')
+_RECORD = struct.Struct('<QIIIBBH')
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    argparser.add_argument('log', help='Binary log file, e.g. '
+                                       'ibex_simple_system_watch.bin')
+    argparser.add_argument('--watch', type=int, action='append',
+                           help='Only show hits of this watchpoint index '
+                                '(can be given multiple times)')
+    argparser.add_argument('--writes', action='store_true',
+                           help='Only show writes')
+    argparser.add_argument('--reads', action='store_true',
+                           help='Only show reads')
+    args = argparser.parse_args()
+
+    with open(args.log, 'rb') as log_file:
+        data = log_file.read()
+
+    if len(data) < _HEADER.size:
+        print('{} is too short'.format(args.log), file=sys.stderr)
+        return 1
+
+    magic, version, record_size = _HEADER.unpack_from(data)
+    if magic != _MAGIC or version != _VERSION or record_size != _RECORD.size:
+        print('{} is not a version {} watchpoint log'.format(args.log,
+                                                            _VERSION),
+              file=sys.stderr)
+        return 1
+
+    print('{:>12} {:>10} {:>10} {:>10} {:>2} {:>4} {:>5}'
+          .format('Cycle', 'PC', 'Address', 'Data', 'RW', 'BE', 'Watch'))
+    for offset in range(_HEADER.size, len(data) - record_size + 1,
+                        record_size):
+        cycle, pc, addr, value, be, we, watch = _RECORD.unpack_from(data,
+                                                                   offset)
+        if args.watch and watch not in args.watch:
+            continue
+        if (args.writes and not we) or (args.reads and we):
+            continue
+
+        print('{:>12} 0x{:08x} 0x{:08x} 0x{:08x} {:>2} {:>4x} {:>5}'
+              .format(cycle, pc, addr, value, 'W' if we else 'R', be, watch))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
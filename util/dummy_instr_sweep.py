@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Run a program on Simple System at every dummy instruction frequency
+
+Builds Simple System with SecureIbex (unless a simulator is given with --sim)
+and runs the program with dummy instructions disabled and with every
+cpuctrl.dummy_instr_mask, several runs going on in parallel. The cycles per
+real (not dummy) instruction of every run are compared to the run without
+dummy instructions. Pass arguments to the simulator after '--':
+
+  dummy_instr_sweep.py -- \\
+      --meminit=ram,$PWD/examples/sw/benchmarks/coremark/coremark.elf
+
+Programs must be given with an absolute path, as every run has its own
+directory.
+'''
+
+import argparse
+import collections
+import concurrent.futures
+import csv
+import logging
+import os
+import shlex
+import subprocess
+import sys
+from typing import Dict, List, NamedTuple
+
+_IBEX_ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+
+_CORE = 'lowrisc:ibex:ibex_simple_system'
+_TOPLEVEL = 'ibex_simple_system'
+_STATS_CSV = 'ibex_simple_system_pcount.csv'
+
+# Arguments of --dummy-instr, the first one is the baseline
+_CONFIGS = ['off'] + [str(mask) for mask in range(8)]
+
+RunResult = NamedTuple('RunResult', [('config', str),
+                                     ('ok', bool),
+                                     ('stats', Dict[str, str])])
+
+
+def run_cmd(cmd: List[str], cwd: str, log_path: str) -> bool:
+    '''Run a command, writing its output to log_path'''
+    logging.debug('Running {} in {}'.format(
+        ' '.join([shlex.quote(a) for a in cmd]), cwd))
+    with open(log_path, 'w') as log_file:
+        proc = subprocess.run(cmd, cwd=cwd, stdout=log_file,
+                              stderr=subprocess.STDOUT)
+    return proc.returncode == 0
+
+
+def build(out_dir: str, build_args: List[str]) -> str:
+    '''Build Simple System with SecureIbex, returns the simulator binary'''
+    build_root = os.path.join(out_dir, 'build')
+    cmd = (['fusesoc', '--cores-root=' + _IBEX_ROOT, 'run', '--target=sim',
+            '--setup', '--build', '--build-root=' + build_root, _CORE,
+            '--SecureIbex=1'] + build_args)
+    logging.info('Building {}'.format(_CORE))
+    log_path = os.path.join(out_dir, 'build.log')
+    if not run_cmd(cmd, _IBEX_ROOT, log_path):
+        logging.error('Build failed, see {}'.format(log_path))
+        return ''
+    # FuseSoC builds each target in <build-root>/<target>-<tool>
+    return os.path.join(build_root, 'sim-verilator', 'V' + _TOPLEVEL)
+
+
+def run(sim_binary: str, config: str, sim_args: List[str],
+        out_dir: str) -> RunResult:
+    '''Run the simulator with one dummy instruction configuration'''
+    run_dir = os.path.join(out_dir, 'dummy_instr_' + config)
+    os.makedirs(run_dir, exist_ok=True)
+
+    logging.info('Running with --dummy-instr={}'.format(config))
+    ok = run_cmd([sim_binary, '--dummy-instr=' + config] + sim_args, run_dir,
+                 os.path.join(run_dir, 'sim.log'))
+    if not ok:
+        logging.error('{}: simulation failed, see {}'
+                      .format(config, os.path.join(run_dir, 'sim.log')))
+
+    stats = collections.OrderedDict()  # type: Dict[str, str]
+    stats_path = os.path.join(run_dir, _STATS_CSV)
+    if os.path.exists(stats_path):
+        with open(stats_path) as stats_file:
+            for row in csv.reader(stats_file):
+                if len(row) == 2:
+                    stats[row[0]] = row[1]
+    return RunResult(config, ok, stats)
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(
+        description=__doc__.split('\n')[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.split('\n')[2:]))
+    argparser.add_argument('--sim',
+                           help='Simulator binary built with SecureIbex=1 '
+                                '(default: build one)')
+    argparser.add_argument('--build-arg', action='append', default=[],
+                           metavar='ARG',
+                           help='Further FuseSoC argument for the build, '
+                                'e.g. --build-arg=--RV32M=ibex_pkg::RV32MSlow '
+                                '(can be given multiple times)')
+    argparser.add_argument('--out-dir',
+                           help='Directory for the build and run outputs '
+                                '(default: build/dummy_instr_sweep)')
+    argparser.add_argument('--output',
+                           help='CSV file with all statistics of all runs '
+                                '(default: results.csv in the output '
+                                'directory)')
+    argparser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                           help='Number of runs in parallel')
+    argparser.add_argument('--verbose', '-v', action='store_true',
+                           help='Print commands as they are run')
+
+    # Everything after '--' is passed to the simulator
+    argv = sys.argv[1:]
+    sim_args = []  # type: List[str]
+    if '--' in argv:
+        sim_args = argv[argv.index('--') + 1:]
+        argv = argv[:argv.index('--')]
+    args = argparser.parse_args(argv)
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(message)s')
+
+    out_dir = os.path.abspath(args.out_dir or
+                              os.path.join(_IBEX_ROOT, 'build',
+                                           'dummy_instr_sweep'))
+    os.makedirs(out_dir, exist_ok=True)
+
+    sim_binary = (os.path.abspath(args.sim) if args.sim
+                  else build(out_dir, args.build_arg))
+    if not sim_binary:
+        return 1
+
+    results = []  # type: List[RunResult]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(run, sim_binary, config, sim_args, out_dir)
+                   for config in _CONFIGS]
+        for future in futures:
+            results.append(future.result())
+
+    # The overhead is relative to the cycles per real instruction without
+    # dummy instructions
+    def cpi(result: RunResult) -> float:
+        try:
+            return float(result.stats['Total Cycles/Real Instruction'])
+        except (KeyError, ValueError):
+            return 0.0
+
+    baseline = cpi(results[0])
+
+    columns = ['Total Cycles', 'Total Real Instructions',
+               'Total Dummy Instructions', 'Total Cycles/Real Instruction']
+    header = ['Dummy Instr'] + columns + ['CPI Overhead']
+    widths = [len(h) for h in header]
+    print()
+    print('  '.join(h.rjust(w) for h, w in zip(header, widths)) + '  Result')
+    for result in results:
+        overhead = ('{:.1f}%'.format(100.0 * (cpi(result) / baseline - 1))
+                    if cpi(result) and baseline else '-')
+        row = ([result.config] +
+               [result.stats.get(column, '-') for column in columns] +
+               [overhead])
+        print('  '.join(v.rjust(w) for v, w in zip(row, widths)) + '  ' +
+              ('PASS' if result.ok else 'FAIL'))
+
+    stat_names = []  # type: List[str]
+    for result in results:
+        for name in result.stats:
+            if name not in stat_names:
+                stat_names.append(name)
+    output = args.output or os.path.join(out_dir, 'results.csv')
+    with open(output, 'w', newline='') as output_file:
+        writer = csv.writer(output_file)
+        writer.writerow(['Dummy Instr', 'Result'] + stat_names)
+        for result in results:
+            writer.writerow([result.config] +
+                            ['PASS' if result.ok else 'FAIL'] +
+                            [result.stats.get(name, '') for name in stat_names])
+    print('\nResults written to {}'.format(output))
+
+    failed = sum(1 for result in results if not result.ok)
+    if failed:
+        logging.error('{} of {} runs failed'.format(failed, len(results)))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Inspect a binary instruction trace
+
+Reads the compressed binary traces written by Simple System with --bin-trace
+(see dv/verilator/bin_trace/cpp/ibex_bin_trace_format.h for the format). The
+chunk index is used to only decompress the parts of the trace needed:
+
+  ibex_bin_trace.py info trace.bin
+  ibex_bin_trace.py dump trace.bin --from-cycle=100000 --count=20
+  ibex_bin_trace.py dump trace.bin --pc=0x100084 --count=5
+'''
+
+import argparse
+import struct
+import sys
+import zlib
+from typing import Iterator, List, NamedTuple, Optional
+
+_MAGIC = b'IBEXTRCE'
+_FOOTER_MAGIC = b'IBEXTIDX'
+_VERSION = 1
+
+_FILE_HEADER = struct.Struct('<8sII')
+_CHUNK_HEADER = struct.Struct('<IIIIQQ')
+_INDEX_ENTRY = struct.Struct('<QQQIIII4Q')
+_FOOTER = struct.Struct('<QII8s')
+
+_PC_SEQ = 1 << 0
+_INSN_NEW = 1 << 1
+_RD = 1 << 2
+_MEM = 1 << 3
+_TRAP = 1 << 4
+_INTR = 1 << 5
+
+_ABI_NAMES = ['zero', 'ra', 'sp', 'gp', 'tp', 't0', 't1', 't2', 's0', 's1',
+              'a0', 'a1', 'a2', 'a3', 'a4', 'a5', 'a6', 'a7', 's2', 's3',
+              's4', 's5', 's6', 's7', 's8', 's9', 's10', 's11', 't3', 't4',
+              't5', 't6']
+
+
+Chunk = NamedTuple('Chunk', [('offset', int), ('first_cycle', int),
+                             ('last_cycle', int), ('pc_min', int),
+                             ('pc_max', int), ('num_records', int),
+                             ('pc_filter', int)])
+
+Record = NamedTuple('Record', [('cycle', int), ('pc', int), ('insn', int),
+                               ('trap', bool), ('intr', bool),
+                               ('rd_addr', int), ('rd_wdata', int),
+                               ('mem_addr', int), ('mem_rmask', int),
+                               ('mem_wmask', int), ('mem_rdata', int),
+                               ('mem_wdata', int)])
+
+
+def pc_filter_bit(pc: int) -> int:
+    '''Bit of the per-chunk PC filter set for pc, see BinTracePcFilterBit()'''
+    return (((pc >> 4) * 0x9e3779b1) & 0xffffffff) >> 24
+
+
+def next_pc(pc: int, insn: int) -> int:
+    return (pc + (4 if insn & 3 == 3 else 2)) & 0xffffffff
+
+
+def unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+
+class TraceReader:
+    def __init__(self, data: bytes) -> None:
+        self.data = data
+        if len(data) < _FILE_HEADER.size:
+            raise ValueError('File too short')
+        magic, version, _ = _FILE_HEADER.unpack_from(data)
+        if magic != _MAGIC or version != _VERSION:
+            raise ValueError('Not a version {} binary trace'
+                             .format(_VERSION))
+        self.complete = True
+        self.chunks = self._read_index()
+        if self.chunks is None:
+            self.complete = False
+            self.chunks = self._scan_chunks()
+
+    def _read_index(self) -> Optional[List[Chunk]]:
+        if len(self.data) < _FILE_HEADER.size + _FOOTER.size:
+            return None
+        index_offset, num_chunks, _, magic = _FOOTER.unpack_from(
+            self.data, len(self.data) - _FOOTER.size)
+        if magic != _FOOTER_MAGIC:
+            return None
+
+        chunks = []
+        for i in range(num_chunks):
+            fields = _INDEX_ENTRY.unpack_from(
+                self.data, index_offset + i * _INDEX_ENTRY.size)
+            pc_filter = 0
+            for word, value in enumerate(fields[7:]):
+                pc_filter |= value << (64 * word)
+            chunks.append(Chunk(*fields[:6], pc_filter=pc_filter))
+        return chunks
+
+    def _scan_chunks(self) -> List[Chunk]:
+        '''Rebuild the index of a trace whose simulation didn't end cleanly'''
+        chunks = []
+        offset = _FILE_HEADER.size
+        while offset + _CHUNK_HEADER.size <= len(self.data):
+            (_, compressed_size, num_records, _, first_cycle,
+             last_cycle) = _CHUNK_HEADER.unpack_from(self.data, offset)
+            end = offset + _CHUNK_HEADER.size + compressed_size
+            if end > len(self.data):
+                break
+            chunks.append(Chunk(offset, first_cycle, last_cycle, 0,
+                                0xffffffff, num_records, (1 << 256) - 1))
+            offset = end
+        return chunks
+
+    def records(self, chunk: Chunk) -> Iterator[Record]:
+        '''Decode all records of a chunk'''
+        (raw_size, compressed_size, num_records, _, _,
+         _) = _CHUNK_HEADER.unpack_from(self.data, chunk.offset)
+        start = chunk.offset + _CHUNK_HEADER.size
+        raw = zlib.decompress(self.data[start:start + compressed_size])
+        if len(raw) != raw_size:
+            raise ValueError('Corrupt chunk at offset {}'
+                             .format(chunk.offset))
+
+        pos = 0
+
+        def varint() -> int:
+            nonlocal pos
+            value = 0
+            shift = 0
+            while True:
+                byte = raw[pos]
+                pos += 1
+                value |= (byte & 0x7f) << shift
+                if not byte & 0x80:
+                    return value
+                shift += 7
+
+        cycle = pc = insn = mem_addr = 0
+        insn_dict = []  # type: List[int]
+        for _ in range(num_records):
+            flags = raw[pos]
+            pos += 1
+            cycle += varint()
+            if flags & _PC_SEQ:
+                pc = next_pc(pc, insn)
+            else:
+                pc = (pc + unzigzag(varint())) & 0xffffffff
+            if flags & _INSN_NEW:
+                insn = int.from_bytes(raw[pos:pos + 4], 'little')
+                pos += 4
+                insn_dict.append(insn)
+            else:
+                insn = insn_dict[varint()]
+
+            rd_addr = rd_wdata = 0
+            if flags & _RD:
+                rd_addr = raw[pos]
+                pos += 1
+                rd_wdata = varint()
+
+            mem_rmask = mem_wmask = mem_rdata = mem_wdata = 0
+            if flags & _MEM:
+                mem_addr = (mem_addr + unzigzag(varint())) & 0xffffffff
+                mem_rmask = raw[pos] >> 4
+                mem_wmask = raw[pos] & 0xf
+                pos += 1
+                if mem_rmask:
+                    mem_rdata = varint()
+                if mem_wmask:
+                    mem_wdata = varint()
+
+            yield Record(cycle, pc, insn, bool(flags & _TRAP),
+                         bool(flags & _INTR), rd_addr, rd_wdata,
+                         mem_addr if flags & _MEM else 0, mem_rmask,
+                         mem_wmask, mem_rdata, mem_wdata)
+
+    def find(self, from_cycle: int, pc: Optional[int]) -> Iterator[Record]:
+        '''All records from from_cycle on, optionally only those at pc'''
+        for chunk in self.chunks:
+            if chunk.last_cycle < from_cycle:
+                continue
+            if pc is not None:
+                if (pc < chunk.pc_min or pc > chunk.pc_max or
+                        not (chunk.pc_filter >> pc_filter_bit(pc)) & 1):
+                    continue
+            for record in self.records(chunk):
+                if record.cycle < from_cycle:
+                    continue
+                if pc is not None and record.pc != pc:
+                    continue
+                yield record
+
+
+def format_record(record: Record) -> str:
+    insn = ('{:04x}'.format(record.insn) if record.insn & 3 != 3
+            else '{:08x}'.format(record.insn))
+    line = '{:>12} {:08x} {:>8}'.format(record.cycle, record.pc, insn)
+    if record.rd_addr:
+        line += ' {}=0x{:08x}'.format(_ABI_NAMES[record.rd_addr],
+                                      record.rd_wdata)
+    if record.mem_rmask or record.mem_wmask:
+        line += ' PA:0x{:08x}'.format(record.mem_addr)
+        if record.mem_wmask:
+            line += ' store:0x{:08x}'.format(record.mem_wdata)
+        if record.mem_rmask:
+            line += ' load:0x{:08x}'.format(record.mem_rdata)
+    if record.trap:
+        line += ' trap'
+    if record.intr:
+        line += ' intr'
+    return line
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(
+        description=__doc__.split('\n')[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.split('\n')[2:]))
+    argparser.add_argument('command', choices=['info', 'dump'])
+    argparser.add_argument('trace', help='Binary trace file')
+    argparser.add_argument('--from-cycle', type=int, default=0,
+                           help='Start dumping at this cycle')
+    argparser.add_argument('--to-cycle', type=int, default=None,
+                           help='Stop dumping after this cycle')
+    argparser.add_argument('--pc', type=lambda x: int(x, 0), default=None,
+                           help='Only dump instructions at this PC')
+    argparser.add_argument('--count', type=int, default=None,
+                           help='Stop after this many instructions')
+    args = argparser.parse_args()
+
+    with open(args.trace, 'rb') as trace_file:
+        data = trace_file.read()
+
+    try:
+        reader = TraceReader(data)
+    except ValueError as err:
+        print('{}: {}'.format(args.trace, err), file=sys.stderr)
+        return 1
+
+    if args.command == 'info':
+        num_records = sum(chunk.num_records for chunk in reader.chunks)
+        print('Instructions: {}'.format(num_records))
+        print('Chunks:       {}'.format(len(reader.chunks)))
+        if reader.chunks:
+            print('Cycles:       {}-{}'.format(reader.chunks[0].first_cycle,
+                                               reader.chunks[-1].last_cycle))
+        if num_records:
+            print('Bytes/instr:  {:.2f}'.format(len(data) / num_records))
+        if not reader.complete:
+            print('Index missing, the simulation did not end cleanly.')
+        return 0
+
+    print('{:>12} {:>8} {:>8} {}'.format('Cycle', 'PC', 'Insn',
+                                         'Register and memory contents'))
+    count = 0
+    for record in reader.find(args.from_cycle, args.pc):
+        if args.to_cycle is not None and record.cycle > args.to_cycle:
+            break
+        if args.count is not None and count >= args.count:
+            break
+        print(format_record(record))
+        count += 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,416 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Measure the simulation speed of the Verilator Simple System
+
+Builds Simple System for every combination of the requested Ibex
+configurations, register file implementations and build variants, runs a
+fixed set of workloads on each of them and records
+
+- the simulation speed (cycles/s, as reported by the simulator),
+- the time it took to build the simulator (builds run one after the other
+  with a fixed number of make jobs, so build times are comparable),
+- the size of the simulator binary and
+- the peak resident set size of each simulation run.
+
+Results are written as JSON (see SCHEMA below) to allow before/after
+comparisons, e.g. with --compare.
+'''
+
+import argparse
+import datetime
+import json
+import logging
+import os
+import platform
+import re
+import shlex
+import statistics
+import subprocess
+import sys
+import time
+from typing import Dict, List, Optional, Tuple
+
+import ibex_config
+
+_IBEX_ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+_SIM_BINARY = 'Vibex_simple_system'
+
+# Version of the result format:
+# {
+#   "schema": SCHEMA,
+#   "date": ISO 8601 date, "revision": git revision,
+#   "host": {"name": ..., "machine": ..., "cpu": ..., "cpu_count": ...},
+#   "builds": [{"config", "regfile", "variant", "build_time_s",
+#               "build_jobs", "binary_size_bytes"}, ...],
+#   "runs": [{"config", "regfile", "variant", "workload", "cycles",
+#             "cycles_per_s", "wall_time_s", "max_rss_kib"}, ...]
+# }
+SCHEMA = 'ibex-sim-speed/1'
+
+_REGFILES = {
+    'ff': 'ibex_pkg::RegFileFF',
+    'latch': 'ibex_pkg::RegFileLatch',
+    'fpga': 'ibex_pkg::RegFileFPGA',
+}
+
+# Build variants: FuseSoC target and extra simulator arguments. The notrace
+# variant is built without any tracing support, so it measures the simulator
+# without the cost of the (inactive) tracing code.
+_VARIANTS = {
+    'notrace': ('sim-notrace', []),
+    'trace': ('sim', ['-t']),
+}
+
+_SIM_SPEED_DIR = os.path.join('examples', 'sw', 'simple_system', 'sim_speed')
+_COREMARK_DIR = os.path.join('examples', 'sw', 'benchmarks', 'coremark')
+
+# Workloads: make arguments and resulting ELF file
+_WORKLOADS = {
+    'coremark': (['-C', _COREMARK_DIR],
+                 os.path.join(_COREMARK_DIR, 'coremark.elf')),
+    'alu': (['-C', _SIM_SPEED_DIR, 'WORKLOAD=alu'],
+            os.path.join(_SIM_SPEED_DIR, 'alu.elf')),
+    'memcpy': (['-C', _SIM_SPEED_DIR, 'WORKLOAD=memcpy'],
+               os.path.join(_SIM_SPEED_DIR, 'memcpy.elf')),
+    'div': (['-C', _SIM_SPEED_DIR, 'WORKLOAD=div'],
+            os.path.join(_SIM_SPEED_DIR, 'div.elf')),
+    'timer_irq': (['-C', _SIM_SPEED_DIR, 'WORKLOAD=timer_irq'],
+                  os.path.join(_SIM_SPEED_DIR, 'timer_irq.elf')),
+}
+
+_CYCLES_RE = re.compile(r'^Executed cycles:\s*(\d+)', re.MULTILINE)
+_SPEED_RE = re.compile(r'^Simulation speed:\s*([0-9.eE+]+) cycles/s',
+                       re.MULTILINE)
+
+BuildKey = Tuple[str, str, str]
+
+
+def run_cmd(cmd: List[str], cwd: str, log_path: str,
+            env: Optional[Dict[str, str]] = None) -> None:
+    '''Run a command, writing its output to log_path'''
+    cmd_str = ' '.join([shlex.quote(a) for a in cmd])
+    logging.debug('Running {} in {}'.format(cmd_str, cwd))
+    with open(log_path, 'w') as log_file:
+        proc = subprocess.run(cmd, cwd=cwd, stdout=log_file,
+                              stderr=subprocess.STDOUT, env=env)
+    if proc.returncode != 0:
+        raise RuntimeError('Command failed with exit code {} (see {}): {}'
+                           .format(proc.returncode, log_path, cmd_str))
+
+
+def build_workloads(names: List[str], out_dir: str) -> Dict[str, str]:
+    '''Build the workloads and return the paths of their ELF files'''
+    elfs = {}
+    for name in names:
+        make_args, elf = _WORKLOADS[name]
+        logging.info('Building workload {}'.format(name))
+        run_cmd(['make'] + make_args, _IBEX_ROOT,
+                os.path.join(out_dir, 'sw_{}.log'.format(name)))
+        elfs[name] = os.path.join(_IBEX_ROOT, elf)
+    return elfs
+
+
+def build_dir_name(key: BuildKey) -> str:
+    config_name, regfile, target = key
+    return '{}-{}-{}'.format(config_name, regfile, target)
+
+
+def build_simulator(key: BuildKey, config: Dict[str, object], jobs: int,
+                    out_dir: str) -> Dict[str, object]:
+    '''Build Simple System and return the build time and binary size
+
+    The simulator is built with jobs parallel make jobs. Only one simulator
+    must be built at a time, otherwise the build time depends on the other
+    builds running alongside.
+    '''
+    config_name, regfile, target = key
+    build_dir = os.path.join(out_dir, build_dir_name(key))
+    build_root = os.path.join(build_dir, 'build')
+    os.makedirs(build_dir, exist_ok=True)
+
+    fusesoc_opts = shlex.split(ibex_config.FusesocOpts().output(config, None))
+    cmd = (['fusesoc', '--cores-root=' + _IBEX_ROOT, 'run',
+            '--target=' + target, '--setup', '--build',
+            '--build-root=' + build_root, 'lowrisc:ibex:ibex_simple_system'] +
+           fusesoc_opts + ['--RegFile=' + _REGFILES[regfile]])
+
+    # FuseSoC runs make to compile the Verilated model
+    env = dict(os.environ)
+    env['MAKEFLAGS'] = '-j{}'.format(jobs)
+
+    logging.info('Building simulator {}'.format(build_dir_name(key)))
+    start = time.monotonic()
+    run_cmd(cmd, _IBEX_ROOT, os.path.join(build_dir, 'build.log'), env)
+    build_time = time.monotonic() - start
+
+    # FuseSoC builds each target in <build-root>/<target>-<tool>
+    sim_binary = os.path.join(build_root, target + '-verilator', _SIM_BINARY)
+    return {
+        'sim_binary': sim_binary,
+        'build_time_s': round(build_time, 3),
+        'build_jobs': jobs,
+        'binary_size_bytes': os.path.getsize(sim_binary)
+    }
+
+
+def run_workload(sim_binary: str, sim_args: List[str], elf: str,
+                 run_dir: str) -> Dict[str, object]:
+    '''Run a workload and return cycles, speed, wall time and peak RSS'''
+    os.makedirs(run_dir, exist_ok=True)
+    log_path = os.path.join(run_dir, 'sim.log')
+    cmd = [sim_binary, '--meminit=ram,' + elf] + sim_args
+
+    logging.debug('Running {} in {}'.format(' '.join(cmd), run_dir))
+    start = time.monotonic()
+    with open(log_path, 'w') as log_file:
+        proc = subprocess.Popen(cmd, cwd=run_dir, stdout=log_file,
+                                stderr=subprocess.STDOUT)
+        # wait4() gives the resource usage of this process alone
+        _, status, rusage = os.wait4(proc.pid, 0)
+        exit_ok = os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
+        proc.returncode = os.WEXITSTATUS(status) if exit_ok else 1
+    wall_time = time.monotonic() - start
+
+    if not exit_ok:
+        raise RuntimeError('Simulation failed (see {})'.format(log_path))
+
+    with open(log_path) as log_file:
+        log = log_file.read()
+    cycles_match = _CYCLES_RE.search(log)
+    speed_match = _SPEED_RE.search(log)
+    if cycles_match is None or speed_match is None:
+        raise RuntimeError('No simulation statistics in {}'.format(log_path))
+
+    # Traces are large and not of interest here
+    for name in os.listdir(run_dir):
+        if name.endswith('.fst') or name.endswith('.vcd'):
+            os.remove(os.path.join(run_dir, name))
+
+    return {
+        'cycles': int(cycles_match.group(1)),
+        'cycles_per_s': float(speed_match.group(1)),
+        'wall_time_s': round(wall_time, 3),
+        # ru_maxrss is in KiB on Linux
+        'max_rss_kib': rusage.ru_maxrss
+    }
+
+
+def git_revision() -> str:
+    '''Return the current git revision of the Ibex repository'''
+    proc = subprocess.run(['git', 'rev-parse', 'HEAD'], cwd=_IBEX_ROOT,
+                          stdout=subprocess.PIPE, universal_newlines=True)
+    return proc.stdout.strip() if proc.returncode == 0 else 'unknown'
+
+
+def compare(old: Dict[str, object], new: Dict[str, object],
+            threshold: float) -> int:
+    '''Print the change in simulation speed between two result files
+
+    Returns the number of runs which got slower by more than threshold
+    percent.
+    '''
+    def run_key(run: Dict[str, object]) -> Tuple[object, ...]:
+        return (run['config'], run['regfile'], run['variant'],
+                run['workload'])
+
+    old_runs = old['runs']
+    new_runs = new['runs']
+    assert isinstance(old_runs, list) and isinstance(new_runs, list)
+    old_by_key = {run_key(run): run for run in old_runs}
+
+    slower = 0
+    print('\nChange against {} ({}):'.format(old.get('revision'),
+                                             old.get('date')))
+    for run in new_runs:
+        old_run = old_by_key.get(run_key(run))
+        if old_run is None:
+            continue
+        change = (100.0 * (run['cycles_per_s'] - old_run['cycles_per_s']) /
+                  old_run['cycles_per_s'])
+        flag = ''
+        if change < -threshold:
+            flag = '  SLOWER'
+            slower += 1
+        print('  {:<48} {:>12.0f} -> {:>12.0f} cycles/s ({:+.1f}%){}'
+              .format('/'.join(str(k) for k in run_key(run)),
+                      old_run['cycles_per_s'], run['cycles_per_s'], change,
+                      flag))
+    return slower
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    argparser.add_argument('configs', nargs='*', default=['small'],
+                           help='Configurations from ibex_configs.yaml '
+                                '(default: small)')
+    argparser.add_argument('--regfile', action='append',
+                           choices=sorted(_REGFILES.keys()),
+                           help='Register file implementations (default: '
+                                'all, can be given multiple times)')
+    argparser.add_argument('--variant', action='append',
+                           choices=sorted(_VARIANTS.keys()),
+                           help='Build variants (default: all, can be given '
+                                'multiple times)')
+    argparser.add_argument('--workload', action='append',
+                           choices=sorted(_WORKLOADS.keys()),
+                           help='Workloads (default: all, can be given '
+                                'multiple times)')
+    argparser.add_argument('--repeat', type=int, default=1,
+                           help='Run each workload N times and report the '
+                                'median speed')
+    argparser.add_argument('--out-dir',
+                           default=os.path.join(_IBEX_ROOT, 'build',
+                                                'sim_speed'),
+                           help='Directory for builds and run outputs')
+    argparser.add_argument('--output',
+                           help='Result file (default: results.json in the '
+                                'output directory)')
+    argparser.add_argument('--compare', metavar='JSON',
+                           help='Previous result file to compare against')
+    argparser.add_argument('--threshold', type=float, default=5.0,
+                           help='Slowdown in percent flagged by --compare')
+    argparser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                           help='Number of make jobs for each simulator '
+                                'build (builds run one after the other)')
+    argparser.add_argument('--verbose', '-v', action='store_true',
+                           help='Print commands as they are run')
+    args = argparser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(message)s')
+
+    config_filename = os.path.join(_IBEX_ROOT,
+                                   ibex_config.get_config_file_location())
+    with open(config_filename) as config_file:
+        config_dicts = ibex_config.get_config_dicts(config_file)
+    for config_name in args.configs:
+        if config_name not in config_dicts:
+            logging.error('Configuration {} not found in {}'
+                          .format(config_name, config_filename))
+            return 1
+
+    regfiles = args.regfile or sorted(_REGFILES.keys())
+    variants = args.variant or sorted(_VARIANTS.keys())
+    workloads = args.workload or sorted(_WORKLOADS.keys())
+
+    out_dir = os.path.abspath(args.out_dir)
+    os.makedirs(out_dir, exist_ok=True)
+
+    try:
+        elfs = build_workloads(workloads, out_dir)
+    except RuntimeError as err:
+        logging.error(err)
+        return 1
+
+    # Variants sharing a FuseSoC target share a build
+    build_keys = sorted({(config_name, regfile, _VARIANTS[variant][0])
+                         for config_name in args.configs
+                         for regfile in regfiles for variant in variants})
+
+    # Builds are done one after the other so that their build times don't
+    # depend on how many other builds are running alongside
+    builds = {}  # type: Dict[BuildKey, Dict[str, object]]
+    failed = False
+    for key in build_keys:
+        try:
+            builds[key] = build_simulator(key, config_dicts[key[0]],
+                                          args.jobs, out_dir)
+        except RuntimeError as err:
+            logging.error('{}: {}'.format(build_dir_name(key), err))
+            failed = True
+
+    results = {
+        'schema': SCHEMA,
+        'date': datetime.datetime.now().isoformat(timespec='seconds'),
+        'revision': git_revision(),
+        'host': {
+            'name': platform.node(),
+            'machine': platform.machine(),
+            'cpu': platform.processor(),
+            'cpu_count': os.cpu_count()
+        },
+        'builds': [],
+        'runs': []
+    }  # type: Dict[str, object]
+    result_builds = results['builds']
+    result_runs = results['runs']
+    assert isinstance(result_builds, list) and isinstance(result_runs, list)
+
+    # Runs are done one after the other to not disturb the measurement
+    for config_name in args.configs:
+        for regfile in regfiles:
+            for variant in variants:
+                target, sim_args = _VARIANTS[variant]
+                build = builds.get((config_name, regfile, target))
+                if build is None:
+                    continue
+
+                result_builds.append({
+                    'config': config_name,
+                    'regfile': regfile,
+                    'variant': variant,
+                    'build_time_s': build['build_time_s'],
+                    'build_jobs': build['build_jobs'],
+                    'binary_size_bytes': build['binary_size_bytes']
+                })
+
+                for workload in workloads:
+                    name = '/'.join([config_name, regfile, variant, workload])
+                    logging.info('Running {}'.format(name))
+                    run_dir = os.path.join(out_dir, 'runs', config_name,
+                                           regfile, variant, workload)
+                    try:
+                        samples = [run_workload(str(build['sim_binary']),
+                                                sim_args, elfs[workload],
+                                                run_dir)
+                                   for _ in range(args.repeat)]
+                    except RuntimeError as err:
+                        logging.error('{}: {}'.format(name, err))
+                        failed = True
+                        continue
+
+                    speed = statistics.median([s['cycles_per_s']
+                                               for s in samples])
+                    run = dict(samples[0])
+                    run.update({
+                        'config': config_name,
+                        'regfile': regfile,
+                        'variant': variant,
+                        'workload': workload,
+                        'cycles_per_s': speed,
+                        'max_rss_kib': max(s['max_rss_kib'] for s in samples)
+                    })
+                    result_runs.append(run)
+
+    print('\n{:<48} {:>12} {:>10} {:>10}'.format('Run', 'Cycles/s',
+                                                 'Wall (s)', 'RSS (MiB)'))
+    for run in result_runs:
+        print('{:<48} {:>12.0f} {:>10.2f} {:>10.1f}'
+              .format('/'.join([run['config'], run['regfile'], run['variant'],
+                                run['workload']]),
+                      run['cycles_per_s'], run['wall_time_s'],
+                      run['max_rss_kib'] / 1024))
+
+    output = args.output or os.path.join(out_dir, 'results.json')
+    with open(output, 'w') as output_file:
+        json.dump(results, output_file, indent=2, sort_keys=True)
+        output_file.write('\n')
+    print('\nResults written to {}'.format(output))
+
+    slower = 0
+    if args.compare:
+        with open(args.compare) as compare_file:
+            old = json.load(compare_file)
+        if old.get('schema') != SCHEMA:
+            logging.error('{} has an unknown schema'.format(args.compare))
+            return 1
+        slower = compare(old, results, args.threshold)
+
+    return 1 if failed or slower else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
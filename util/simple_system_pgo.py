@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Build Simple System with profile-guided and link-time optimization
+
+Verilated models are large, branch-heavy C++ code which benefits a lot from
+profile-guided optimization (PGO). This script
+
+1. builds a baseline Simple System simulator with the default flags,
+2. builds an instrumented simulator (-fprofile-generate),
+3. runs a set of training programs on the instrumented simulator,
+4. rebuilds the simulator using the profile (-fprofile-use) and LTO, and
+5. runs the training programs on the baseline and the optimized simulator
+   and reports the simulation speed (cycles/s) of both.
+
+The optimized simulator is left in <out-dir>/pgo. Requires GCC.
+'''
+
+import argparse
+import json
+import logging
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+from typing import Dict, List
+
+import ibex_config
+
+_IBEX_ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+_SIM_DIR = 'sim-verilator'
+_SIM_BINARY = 'Vibex_simple_system'
+
+# Default training programs, built with make in the given directories
+_TRAINING_SW = [
+    ('coremark', os.path.join('examples', 'sw', 'benchmarks', 'coremark'),
+     'coremark.elf'),
+    ('hello_test', os.path.join('examples', 'sw', 'simple_system',
+                                'hello_test'), 'hello_test.elf'),
+]
+
+_SPEED_RE = re.compile(r'^Simulation speed:\s*([0-9.eE+]+) cycles/s',
+                       re.MULTILINE)
+
+
+def run_cmd(cmd: List[str], cwd: str, log_path: str) -> str:
+    '''Run a command, writing its output to log_path and returning it'''
+    cmd_str = ' '.join([shlex.quote(a) for a in cmd])
+    logging.debug('Running {} in {}'.format(cmd_str, cwd))
+    proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+    with open(log_path, 'w') as log_file:
+        log_file.write(proc.stdout)
+    if proc.returncode != 0:
+        raise RuntimeError('Command failed with exit code {} (see {}): {}'
+                           .format(proc.returncode, log_path, cmd_str))
+    return proc.stdout
+
+
+def build_training_sw(out_dir: str) -> Dict[str, str]:
+    '''Build the default training programs and return their ELF paths'''
+    elfs = {}
+    for name, sw_dir, elf in _TRAINING_SW:
+        logging.info('Building {}'.format(name))
+        run_cmd(['make', '-C', sw_dir], _IBEX_ROOT,
+                os.path.join(out_dir, name + '_build.log'))
+        elfs[name] = os.path.join(_IBEX_ROOT, sw_dir, elf)
+    return elfs
+
+
+def setup_simulator(build_root: str, fusesoc_opts: List[str]) -> str:
+    '''Let FuseSoC set up (but not build) Simple System in build_root
+
+    Returns the directory of the Verilator build.
+    '''
+    cmd = (['fusesoc', '--cores-root=' + _IBEX_ROOT, 'run', '--target=sim',
+            '--setup', '--build-root=' + build_root,
+            'lowrisc:ibex:ibex_simple_system'] + fusesoc_opts)
+    os.makedirs(build_root, exist_ok=True)
+    run_cmd(cmd, _IBEX_ROOT, os.path.join(build_root, 'setup.log'))
+    return os.path.join(build_root, _SIM_DIR)
+
+
+def build_simulator(sim_dir: str, make_vars: List[str], jobs: int,
+                    log_name: str) -> None:
+    '''Build the Verilator model in sim_dir
+
+    The variables in make_vars are passed on the make command line. Make
+    passes them on to the sub-make which compiles the Verilator output, where
+    they override the defaults of verilated.mk.
+    '''
+    run_cmd(['make', '-j{}'.format(jobs)] + make_vars, sim_dir,
+            os.path.join(sim_dir, log_name))
+
+
+def clean_objects(sim_dir: str) -> None:
+    '''Remove compiled objects, keeping the Verilator output'''
+    for name in os.listdir(sim_dir):
+        if (name.endswith('.o') or name.endswith('.a') or
+                name.endswith('.d') or name == _SIM_BINARY):
+            os.remove(os.path.join(sim_dir, name))
+
+
+def run_sim(sim_binary: str, name: str, elf: str, run_dir: str) -> float:
+    '''Run one program on a simulator and return the simulation speed'''
+    os.makedirs(run_dir, exist_ok=True)
+    out = run_cmd([sim_binary, '--meminit=ram,' + elf], run_dir,
+                  os.path.join(run_dir, name + '.log'))
+    match = _SPEED_RE.search(out)
+    if match is None:
+        raise RuntimeError('No simulation speed reported for {} (see {})'
+                           .format(name, run_dir))
+    return float(match.group(1))
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    argparser.add_argument('--config', default=None,
+                           help=('Configuration from ibex_configs.yaml to '
+                                 'build (default: core defaults)'))
+    argparser.add_argument('--train-elf', action='append', default=[],
+                           metavar='ELF',
+                           help='Additional training program (can be given '
+                                'multiple times)')
+    argparser.add_argument('--out-dir',
+                           default=os.path.join(_IBEX_ROOT, 'build',
+                                                'simple_system_pgo'),
+                           help='Directory for builds and run outputs')
+    argparser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                           help='Number of parallel compile jobs')
+    argparser.add_argument('--no-lto', action='store_true',
+                           help="Don't use link-time optimization")
+    argparser.add_argument('--verbose', '-v', action='store_true',
+                           help='Print commands as they are run')
+    args = argparser.parse_args()
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(message)s')
+
+    fusesoc_opts = []  # type: List[str]
+    if args.config is not None:
+        config_filename = os.path.join(_IBEX_ROOT,
+                                       ibex_config.get_config_file_location())
+        with open(config_filename) as config_file:
+            config_dicts = ibex_config.get_config_dicts(config_file)
+        if args.config not in config_dicts:
+            logging.error('Configuration {} not found in {}'
+                          .format(args.config, config_filename))
+            return 1
+        fusesoc_opts = shlex.split(ibex_config.FusesocOpts().output(
+            config_dicts[args.config], None))
+
+    out_dir = os.path.abspath(args.out_dir)
+    profile_dir = os.path.join(out_dir, 'profile')
+    os.makedirs(out_dir, exist_ok=True)
+    shutil.rmtree(profile_dir, ignore_errors=True)
+
+    try:
+        elfs = build_training_sw(out_dir)
+        for elf in args.train_elf:
+            elfs[os.path.splitext(os.path.basename(elf))[0]] = \
+                os.path.abspath(elf)
+
+        logging.info('Building baseline simulator')
+        base_dir = setup_simulator(os.path.join(out_dir, 'base'),
+                                   fusesoc_opts)
+        build_simulator(base_dir, [], args.jobs, 'build.log')
+
+        # The profile is recorded and used in the same build directory, as
+        # GCC names profile files after the object files they belong to.
+        logging.info('Building instrumented simulator')
+        pgo_dir = setup_simulator(os.path.join(out_dir, 'pgo'), fusesoc_opts)
+        profile_flags = ['-fprofile-generate=' + profile_dir,
+                         '-fprofile-update=single']
+        build_simulator(pgo_dir, ['OPT=' + ' '.join(profile_flags),
+                                  'LDFLAGS=' + ' '.join(profile_flags)],
+                        args.jobs, 'build_instrumented.log')
+
+        for name, elf in elfs.items():
+            logging.info('Training with {}'.format(name))
+            run_sim(os.path.join(pgo_dir, _SIM_BINARY), name, elf,
+                    os.path.join(out_dir, 'train'))
+
+        logging.info('Building optimized simulator')
+        clean_objects(pgo_dir)
+        use_flags = ['-fprofile-use=' + profile_dir, '-fprofile-correction',
+                     '-Wno-missing-profile']
+        make_vars = ['OPT=' + ' '.join(use_flags)]
+        if not args.no_lto:
+            # The model is linked from a static library, whose symbol index
+            # must be built by the LTO-aware archiver
+            make_vars = ['OPT=' + ' '.join(use_flags + ['-flto']),
+                         'LDFLAGS=-flto={}'.format(args.jobs), 'AR=gcc-ar']
+        build_simulator(pgo_dir, make_vars, args.jobs, 'build_optimized.log')
+    except RuntimeError as err:
+        logging.error(err)
+        return 1
+
+    results = {}
+    for name, elf in elfs.items():
+        try:
+            base = run_sim(os.path.join(base_dir, _SIM_BINARY),
+                           name, elf, os.path.join(out_dir, 'run_base'))
+            pgo = run_sim(os.path.join(pgo_dir, _SIM_BINARY), name,
+                          elf, os.path.join(out_dir, 'run_pgo'))
+        except RuntimeError as err:
+            logging.error(err)
+            return 1
+        results[name] = {'base_cycles_per_s': base, 'pgo_cycles_per_s': pgo,
+                         'speedup': pgo / base}
+
+    print('\n{:<20} {:>16} {:>16} {:>8}'.format('Program', 'Base cycles/s',
+                                                'PGO cycles/s', 'Speedup'))
+    for name, result in results.items():
+        print('{:<20} {:>16.0f} {:>16.0f} {:>7.2f}x'
+              .format(name, result['base_cycles_per_s'],
+                      result['pgo_cycles_per_s'], result['speedup']))
+
+    with open(os.path.join(out_dir, 'report.json'), 'w') as report_file:
+        json.dump(results, report_file, indent=2, sort_keys=True)
+
+    print('\nOptimized simulator: {}'
+          .format(os.path.join(pgo_dir, _SIM_BINARY)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Run a Verilator unit testbench for many parameter combinations
+
+Builds the testbench with FuseSoC for every combination of its parameter
+values and runs it, with several builds and runs going on in parallel. The
+statistics each run writes to its CSV file are collected into one table.
+
+By default all combinations listed in _BENCHES are run. Use --param to sweep
+a subset, and pass arguments to the testbench after '--':
+
+  tb_sweep.py icache
+  tb_sweep.py icache --param NumWays=2 --param SpecRequest=0,1 \\
+      -- --fetches=10000000 --mem-latency=2:8
+'''
+
+import argparse
+import collections
+import concurrent.futures
+import csv
+import itertools
+import logging
+import os
+import shlex
+import subprocess
+import sys
+from typing import Callable, Dict, List, NamedTuple, Optional
+
+_IBEX_ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), '..'))
+
+Params = Dict[str, str]
+
+Bench = NamedTuple('Bench', [
+    # FuseSoC core and toplevel module of the testbench
+    ('core', str),
+    ('toplevel', str),
+    # CSV file with "name,value" lines written by every run
+    ('stats_csv', str),
+    # Parameters and the values swept by default
+    ('params', Dict[str, List[str]]),
+    # Returns False for parameter combinations the RTL doesn't support
+    ('valid', Callable[[Params], bool]),
+    # Statistics shown in the summary table (the CSV output has all of them)
+    ('columns', List[str])])
+
+_BENCHES = {
+    'icache': Bench(
+        core='lowrisc:ibex:tb_icache',
+        toplevel='tb_icache',
+        stats_csv='tb_icache_stats.csv',
+        params=collections.OrderedDict([
+            ('CacheSizeBytes', ['1024', '4096', '16384']),
+            ('NumWays', ['2', '4']),
+            ('LineSize', ['64', '128']),
+            ('ICacheECC', ['0', '1']),
+            ('SpecRequest', ['0', '1']),
+            ('BranchCache', ['0', '1']),
+        ]),
+        # The ECC primitives only support lines of up to 121 bits
+        valid=lambda p: p['ICacheECC'] == '0' or int(p['LineSize']) <= 121,
+        columns=['Mismatches', 'Fetches/Cycle',
+                 'Branch Latency Without Memory',
+                 'Branch Latency From Memory', 'Memory Beats/Fetch',
+                 'ICache Hits', 'ICache Misses', 'Fetches/s']),
+    'multdiv': Bench(
+        core='lowrisc:ibex:tb_multdiv',
+        toplevel='tb_multdiv',
+        stats_csv='tb_multdiv_stats.csv',
+        params=collections.OrderedDict([
+            ('RV32M', ['ibex_pkg::RV32MSlow', 'ibex_pkg::RV32MFast',
+                       'ibex_pkg::RV32MSingleCycle']),
+        ]),
+        valid=lambda p: True,
+        columns=['Mismatches', 'MUL Latency', 'MULH Latency', 'DIV Latency',
+                 'REM Latency', 'Instructions/s']),
+    'alu': Bench(
+        core='lowrisc:ibex:tb_alu',
+        toplevel='tb_alu',
+        stats_csv='tb_alu_stats.csv',
+        params=collections.OrderedDict([
+            ('RV32B', ['ibex_pkg::RV32BNone', 'ibex_pkg::RV32BBalanced',
+                       'ibex_pkg::RV32BFull']),
+        ]),
+        valid=lambda p: True,
+        columns=['Mismatches', 'Vectors', 'Vectors/Cycle', 'Vectors/s',
+                 'Model Vectors/s']),
+    'pmp': Bench(
+        core='lowrisc:ibex:tb_pmp',
+        toplevel='tb_pmp',
+        stats_csv='tb_pmp_stats.csv',
+        params=collections.OrderedDict([
+            ('PMPGranularity', ['0', '1', '2', '8']),
+            ('PMPNumRegions', ['1', '4', '16']),
+        ]),
+        valid=lambda p: True,
+        columns=['Mismatches', 'Checks', 'Checks/Cycle', 'Checks/s',
+                 'Model Checks/s']),
+    # Needs the program to run, e.g.
+    # -- --meminit=ram,<absolute path of ELF file>
+    'simple_system': Bench(
+        core='lowrisc:ibex:ibex_simple_system',
+        toplevel='ibex_simple_system',
+        stats_csv='ibex_simple_system_pcount.csv',
+        params=collections.OrderedDict([
+            ('HarvardMem', ['0', '1']),
+            ('ICache', ['0', '1']),
+        ]),
+        valid=lambda p: True,
+        # Front-End Bound % and Total Energy are only reported if run with
+        # --fetch-monitor and --energy
+        columns=['Cycles', 'Instructions Retired', 'Cycles/Instruction',
+                 'Fetch Wait/Instruction', 'Front-End Bound %',
+                 'Total Energy']),
+    # Needs the program to run, e.g.
+    # -- --meminit=ram,<absolute path of ELF file>
+    'multicore': Bench(
+        core='lowrisc:ibex:ibex_multicore_system',
+        toplevel='ibex_multicore_system',
+        stats_csv='ibex_multicore_system_stats.csv',
+        params=collections.OrderedDict([
+            ('NrCores', ['1', '2', '4', '8']),
+            ('BusRoundRobin', ['0', '1']),
+        ]),
+        valid=lambda p: True,
+        columns=['Cycles', 'Instructions/Cycle', 'Bus Utilisation',
+                 'Arbitration Stalls/Request']),
+}
+
+RunResult = NamedTuple('RunResult', [('params', Params),
+                                     ('ok', bool),
+                                     ('stats', Dict[str, str])])
+
+
+def run_cmd(cmd: List[str], cwd: str, log_path: str) -> bool:
+    '''Run a command, writing its output to log_path'''
+    logging.debug('Running {} in {}'.format(
+        ' '.join([shlex.quote(a) for a in cmd]), cwd))
+    with open(log_path, 'w') as log_file:
+        proc = subprocess.run(cmd, cwd=cwd, stdout=log_file,
+                              stderr=subprocess.STDOUT)
+    return proc.returncode == 0
+
+
+def run_name(params: Params) -> str:
+    # Drop the package of enum values like ibex_pkg::RV32MFast
+    return '-'.join('{}{}'.format(name, value.split('::')[-1])
+                    for name, value in params.items())
+
+
+def build_and_run(bench: Bench, params: Params, sim_args: List[str],
+                  out_dir: str) -> RunResult:
+    '''Build the testbench for one parameter combination and run it'''
+    name = run_name(params)
+    run_dir = os.path.join(out_dir, name)
+    build_root = os.path.join(run_dir, 'build')
+    os.makedirs(run_dir, exist_ok=True)
+
+    cmd = (['fusesoc', '--cores-root=' + _IBEX_ROOT, 'run', '--target=sim',
+            '--setup', '--build', '--build-root=' + build_root, bench.core] +
+           ['--{}={}'.format(param, value) for param, value in params.items()])
+    logging.info('Building {}'.format(name))
+    if not run_cmd(cmd, _IBEX_ROOT, os.path.join(run_dir, 'build.log')):
+        logging.error('{}: build failed, see {}'
+                      .format(name, os.path.join(run_dir, 'build.log')))
+        return RunResult(params, False, {})
+
+    # FuseSoC builds each target in <build-root>/<target>-<tool>
+    sim_binary = os.path.join(build_root, 'sim-verilator',
+                              'V' + bench.toplevel)
+    logging.info('Running {}'.format(name))
+    ok = run_cmd([sim_binary] + sim_args, run_dir,
+                 os.path.join(run_dir, 'sim.log'))
+    if not ok:
+        logging.error('{}: simulation failed, see {}'
+                      .format(name, os.path.join(run_dir, 'sim.log')))
+
+    stats = collections.OrderedDict()  # type: Dict[str, str]
+    stats_path = os.path.join(run_dir, bench.stats_csv)
+    if os.path.exists(stats_path):
+        with open(stats_path) as stats_file:
+            for row in csv.reader(stats_file):
+                if len(row) == 2:
+                    stats[row[0]] = row[1]
+    return RunResult(params, ok, stats)
+
+
+def parse_param_arg(bench: Bench, arg: str) -> Optional[List[str]]:
+    name, sep, values = arg.partition('=')
+    if not sep or name not in bench.params:
+        return None
+    return [name] + values.split(',')
+
+
+def main() -> int:
+    argparser = argparse.ArgumentParser(
+        description=__doc__.split('\n')[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.split('\n')[2:]))
+    argparser.add_argument('bench', choices=sorted(_BENCHES.keys()))
+    argparser.add_argument('--param', action='append', default=[],
+                           metavar='NAME=V1[,V2...]',
+                           help='Only sweep these values of a parameter '
+                                '(can be given multiple times)')
+    argparser.add_argument('--out-dir',
+                           help='Directory for builds and run outputs '
+                                '(default: build/tb_sweep/<bench>)')
+    argparser.add_argument('--output',
+                           help='CSV file with all statistics of all runs '
+                                '(default: results.csv in the output '
+                                'directory)')
+    argparser.add_argument('--jobs', '-j', type=int, default=os.cpu_count(),
+                           help='Number of builds and runs in parallel')
+    argparser.add_argument('--verbose', '-v', action='store_true',
+                           help='Print commands as they are run')
+
+    # Everything after '--' is passed to the testbench
+    argv = sys.argv[1:]
+    sim_args = []  # type: List[str]
+    if '--' in argv:
+        sim_args = argv[argv.index('--') + 1:]
+        argv = argv[:argv.index('--')]
+    args = argparser.parse_args(argv)
+
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format='%(message)s')
+
+    bench = _BENCHES[args.bench]
+    sweep = collections.OrderedDict(bench.params)
+    for param_arg in args.param:
+        parsed = parse_param_arg(bench, param_arg)
+        if parsed is None:
+            logging.error('Invalid parameter {}, expected NAME=V1[,V2...] '
+                          'with NAME one of {}'
+                          .format(param_arg, ', '.join(bench.params)))
+            return 1
+        sweep[parsed[0]] = parsed[1:]
+
+    combinations = []
+    for values in itertools.product(*sweep.values()):
+        params = collections.OrderedDict(zip(sweep.keys(), values))
+        if bench.valid(params):
+            combinations.append(params)
+    if not combinations:
+        logging.error('No valid parameter combinations to run')
+        return 1
+
+    out_dir = os.path.abspath(args.out_dir or
+                              os.path.join(_IBEX_ROOT, 'build', 'tb_sweep',
+                                           args.bench))
+    os.makedirs(out_dir, exist_ok=True)
+    logging.info('Running {} parameter combinations in {}'
+                 .format(len(combinations), out_dir))
+
+    results = []  # type: List[RunResult]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(build_and_run, bench, params, sim_args,
+                               out_dir)
+                   for params in combinations]
+        for future in futures:
+            results.append(future.result())
+
+    # Summary table, one line per run
+    widths = [max(len(name), max(len(p[name]) for p in combinations))
+              for name in sweep]
+    widths += [max(len(column), 8) for column in bench.columns]
+    header = list(sweep.keys()) + bench.columns
+    print()
+    print('  '.join(h.rjust(w) for h, w in zip(header, widths)) + '  Result')
+    for result in results:
+        row = (list(result.params.values()) +
+               [result.stats.get(column, '-') for column in bench.columns])
+        print('  '.join(v.rjust(w) for v, w in zip(row, widths)) + '  ' +
+              ('PASS' if result.ok else 'FAIL'))
+
+    stat_names = []  # type: List[str]
+    for result in results:
+        for name in result.stats:
+            if name not in stat_names:
+                stat_names.append(name)
+    output = args.output or os.path.join(out_dir, 'results.csv')
+    with open(output, 'w', newline='') as output_file:
+        writer = csv.writer(output_file)
+        writer.writerow(list(sweep.keys()) + ['Result'] + stat_names)
+        for result in results:
+            writer.writerow(list(result.params.values()) +
+                            ['PASS' if result.ok else 'FAIL'] +
+                            [result.stats.get(name, '') for name in stat_names])
+    print('\nResults written to {}'.format(output))
+
+    failed = sum(1 for result in results if not result.ok)
+    if failed:
+        logging.error('{} of {} runs failed'.format(failed, len(results)))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())